@@ -16,6 +16,7 @@
 #include "qnn_tensor.h"
 #include "qnn_profiler.h"
 #include "qnn_log.h"
+#include "qnn_kv_cache.h"
 
 #define GROUP_SIZE 128
 #define SYMMETRIC 1
@@ -86,7 +87,14 @@ struct OpHolder {
     c->outputTensors = outputs.empty() ? nullptr : outputs.data();
   }
 
-  // tensor param은 TODO
+  // tensor param: t must already be in the graph (EnsureTensorInGraph) and outlive AddNode
+  void addTensorParam(const char* name, const QnnTensor& t) {
+    Qnn_Param_t p{};
+    p.paramType   = QNN_PARAMTYPE_TENSOR;
+    p.name        = name;
+    p.tensorParam = t.Clone();
+    params.push_back(p);
+  }
   void addScalarU32(const char* name, uint32_t v) {
     Qnn_Param_t p{};
     p.paramType = QNN_PARAMTYPE_SCALAR;
@@ -149,26 +157,178 @@ static OpHolder MakeOpHolder(const std::string& name,
 }
 
 
-static bool BuildOneGraph(
+// ---- KV cache storage (--kv-cache) ----
+struct KvCacheSpec {
+  QnnKvCacheMode mode{QnnKvCacheMode::kOff};
+  unsigned int heads{16};
+  unsigned int past_len{0};  // decode: past tokens read from k_cache/v_cache. 0 => write only (prefill)
+};
+
+// tensors created by the KV helpers, alive until the block returns (same as the block's locals)
+using TensorKeep = std::vector<std::unique_ptr<QnnTensor>>;
+
+static QnnTensor* NewGraphTensor(QnnGraphRuntime& graph, TensorKeep& keep, const std::string& name,
+                                 Qnn_TensorType_t type, Qnn_DataType_t dt, const std::vector<uint32_t>& dims,
+                                 const void* data = nullptr, uint32_t bytes = 0) {
+  keep.push_back(std::make_unique<QnnTensor>(name, type, dt, dims, nullptr, bytes, data, /*copy_data=*/data != nullptr));
+  if (!graph.EnsureTensorInGraph(*keep.back())) return nullptr;
+  return keep.back().get();
+}
+
+static bool ValidateAndAddOp(QnnBackendRuntime& backend, QnnGraphRuntime& graph, OpHolder& op) {
+  if (!backend.ValidateOpConfig(op.cfg)) {
+    std::cerr << "ValidateOpConfig failed: " << op.name_store << "\n";
+    return false;
+  }
+  if (!graph.AddNode(op.cfg)) {
+    std::cerr << "AddNode failed: " << op.name_store << "\n";
+    return false;
+  }
+  return true;
+}
+
+// cache write: src [B, T, D] f32 -> graph output <name> [B, T, H, D/H] in the storage dtype
+//   f32  : Reshape
+//   f16  : Reshape -> Cast
+//   int8 : Reshape -> |x| -> ReduceMax(head dim) -> max(., eps) / 127 = <name>_scale [B, T, H, 1] (graph output)
+//          x / scale -> Round -> Cast(int8)
+static bool AddKvCacheWrite(QnnBackendRuntime& backend, QnnGraphRuntime& graph, TensorKeep& keep,
+                            const std::string& name, QnnTensor& src,
+                            unsigned int B, unsigned int T, unsigned int D, const KvCacheSpec& kv) {
+  const char* kPackage = "qti.aisw";
+  const unsigned int H = kv.heads, Dh = D / H;
+  const std::vector<uint32_t> hd_dims{B, T, H, Dh};
+  const Qnn_DataType_t dt = KvCacheDataType(kv.mode);
+  auto none = [](OpHolder&){};
+
+  if (kv.mode == QnnKvCacheMode::kF32) {
+    QnnTensor* out = NewGraphTensor(graph, keep, name, QNN_TENSOR_TYPE_APP_READ, dt, hd_dims);
+    if (!out) return false;
+    OpHolder op = MakeOpHolder(name + "_reshape", kPackage, "Reshape", src, nullptr, nullptr, *out, none);
+    return ValidateAndAddOp(backend, graph, op);
+  }
+
+  QnnTensor* r = NewGraphTensor(graph, keep, name + "_f32", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+  if (!r) return false;
+  OpHolder reshape = MakeOpHolder(name + "_reshape", kPackage, "Reshape", src, nullptr, nullptr, *r, none);
+  if (!ValidateAndAddOp(backend, graph, reshape)) return false;
+
+  if (kv.mode == QnnKvCacheMode::kF16) {
+    QnnTensor* out = NewGraphTensor(graph, keep, name, QNN_TENSOR_TYPE_APP_READ, dt, hd_dims);
+    if (!out) return false;
+    OpHolder cast = MakeOpHolder(name + "_cast", kPackage, "Cast", *r, nullptr, nullptr, *out, none);
+    return ValidateAndAddOp(backend, graph, cast);
+  }
+
+  // int8, one scale per (token, head)
+  const std::vector<uint32_t> s_dims{B, T, H, 1};
+  const std::vector<uint32_t> one{1};
+  const uint32_t axis = 3;
+  const float min_max = 127.0f * kKvInt8MinScale, inv127 = 1.0f / 127.0f;
+  QnnTensor* a = NewGraphTensor(graph, keep, name + "_abs", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+  QnnTensor* m = NewGraphTensor(graph, keep, name + "_absmax", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, s_dims);
+  QnnTensor* m2 = NewGraphTensor(graph, keep, name + "_absmax_clamped", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, s_dims);
+  QnnTensor* axes = NewGraphTensor(graph, keep, name + "_axes", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_UINT_32, one, &axis, sizeof(axis));
+  QnnTensor* c_min = NewGraphTensor(graph, keep, name + "_min_absmax", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, one, &min_max, sizeof(float));
+  QnnTensor* c_inv = NewGraphTensor(graph, keep, name + "_inv127", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, one, &inv127, sizeof(float));
+  QnnTensor* scale = NewGraphTensor(graph, keep, name + "_scale", QNN_TENSOR_TYPE_APP_READ, QNN_DATATYPE_FLOAT_32, s_dims);
+  QnnTensor* d = NewGraphTensor(graph, keep, name + "_div", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+  QnnTensor* rd = NewGraphTensor(graph, keep, name + "_round", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+  QnnTensor* out = NewGraphTensor(graph, keep, name, QNN_TENSOR_TYPE_APP_READ, dt, hd_dims);
+  if (!a || !m || !m2 || !axes || !c_min || !c_inv || !scale || !d || !rd || !out) return false;
+
+  OpHolder ops[] = {
+    MakeOpHolder(name + "_abs", kPackage, "ElementWiseAbs", *r, nullptr, nullptr, *a, none),
+    MakeOpHolder(name + "_absmax", kPackage, "ReduceMax", *a, nullptr, nullptr, *m, [&](OpHolder& oh){
+      oh.addTensorParam("axes", *axes);
+      oh.addScalarB8("keep_dims", 1);
+    }),
+    MakeOpHolder(name + "_clamp", kPackage, "ElementWiseMaximum", *m, c_min, nullptr, *m2, none),
+    MakeOpHolder(name + "_scale", kPackage, "ElementWiseMultiply", *m2, c_inv, nullptr, *scale, none),
+    MakeOpHolder(name + "_div", kPackage, "ElementWiseDivide", *r, scale, nullptr, *d, none),
+    MakeOpHolder(name + "_round", kPackage, "ElementWiseRound", *d, nullptr, nullptr, *rd, none),
+    MakeOpHolder(name + "_cast", kPackage, "Cast", *rd, nullptr, nullptr, *out, none),
+  };
+  for (OpHolder& op : ops) {
+    if (!ValidateAndAddOp(backend, graph, op)) return false;
+  }
+  return true;
+}
+
+// cache read: graph input <name> [B, P, H, D/H] (+ <name>_scale for int8) -> f32 [B, P, D], nullptr on failure
+//   f32  : Reshape
+//   f16  : Cast -> Reshape
+//   int8 : Cast -> * scale -> Reshape
+static QnnTensor* AddKvCacheRead(QnnBackendRuntime& backend, QnnGraphRuntime& graph, TensorKeep& keep,
+                                 const std::string& name,
+                                 unsigned int B, unsigned int P, unsigned int D, const KvCacheSpec& kv) {
+  const char* kPackage = "qti.aisw";
+  const unsigned int H = kv.heads, Dh = D / H;
+  const std::vector<uint32_t> hd_dims{B, P, H, Dh};
+  auto none = [](OpHolder&){};
+
+  QnnTensor* in = NewGraphTensor(graph, keep, name, QNN_TENSOR_TYPE_APP_WRITE, KvCacheDataType(kv.mode), hd_dims);
+  QnnTensor* out = NewGraphTensor(graph, keep, name + "_read", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32,
+                                  std::vector<uint32_t>{B, P, D});
+  if (!in || !out) return nullptr;
+
+  QnnTensor* f = in;
+  if (kv.mode != QnnKvCacheMode::kF32) {
+    f = NewGraphTensor(graph, keep, name + "_f32", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+    if (!f) return nullptr;
+    OpHolder cast = MakeOpHolder(name + "_cast", kPackage, "Cast", *in, nullptr, nullptr, *f, none);
+    if (!ValidateAndAddOp(backend, graph, cast)) return nullptr;
+  }
+  if (kv.mode == QnnKvCacheMode::kInt8) {
+    QnnTensor* scale = NewGraphTensor(graph, keep, name + "_scale", QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32,
+                                      std::vector<uint32_t>{B, P, H, 1});
+    QnnTensor* dq = NewGraphTensor(graph, keep, name + "_dq", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, hd_dims);
+    if (!scale || !dq) return nullptr;
+    OpHolder mul = MakeOpHolder(name + "_dequant", kPackage, "ElementWiseMultiply", *f, scale, nullptr, *dq, none);
+    if (!ValidateAndAddOp(backend, graph, mul)) return nullptr;
+    f = dq;
+  }
+  OpHolder reshape = MakeOpHolder(name + "_reshape", kPackage, "Reshape", *f, nullptr, nullptr, *out, none);
+  if (!ValidateAndAddOp(backend, graph, reshape)) return nullptr;
+  return out;
+}
+
+// One attention block: x -> out.
+// Every tensor/op name created here is prefixed so several blocks can live in one graph
+// (prefix "" keeps the original single-block names).
+static bool AddAttentionBlock(
     QnnBackendRuntime& backend,
     QnnGraphRuntime& graph,
     bool is_kv,
-    // (필요하면) seed나 차이 주는 파라미터 추가 가능
+    const std::string& prefix,
+    QnnTensor& x,
+    QnnTensor& out,
     unsigned int B, unsigned int L, unsigned int D, unsigned int C,
     uint8_t* static_v, uint8_t* static_sc, float* static_q, float* static_k,
-    unsigned int v_bytes, unsigned int qk_bytes, unsigned int scale_bytes
+    unsigned int v_bytes, unsigned int qk_bytes, unsigned int scale_bytes,
+    const KvCacheSpec& kv = KvCacheSpec{}
 ) {
+  auto N = [&](const char* n) { return prefix + n; };
+
+  // KV cache: past k/v (P tokens) are read back and attended over together with this step's k/v,
+  // which are written out for the next step
+  const bool kv_on = kv.mode != QnnKvCacheMode::kOff;
+  const unsigned int P = kv_on ? kv.past_len : 0;
+  if (kv_on && (kv.heads == 0 || D % kv.heads != 0)) {
+    std::cerr << "KV cache: D=" << D << " is not divisible by heads=" << kv.heads << "\n";
+    return false;
+  }
+  TensorKeep kv_keep;
+
   // QBIT PARAM
   bool ADD_CONVERT = true;
 
   // ---- Tensor 정의 ----
-  std::vector<uint32_t> x_dims{B, L, C};
-  std::vector<uint32_t> y_dims{C, C};
   std::vector<uint32_t> v_dims{C, D};
   std::vector<uint32_t> weight_dims{D, C}; // outch, inch
   std::vector<uint32_t> flatten_o_dims{B * L, D};
   std::vector<uint32_t> o_dims{B, L, D};
-  std::vector<uint32_t> attn_dims{B, L, L};
+  std::vector<uint32_t> attn_dims{B, L, L + P};
   
   std::vector<uint32_t> flat_x_dims{B*L, C};
   std::vector<uint32_t> l_tns_dims{1, static_cast<uint32_t>(_get_l_size(C, GROUP_SIZE, !ADD_CONVERT))};
@@ -180,46 +340,41 @@ static bool BuildOneGraph(
   // 같은 weight sharing을 노리면 wq/wk/wvprime 같은 STATIC 텐서는
   // 두 graph에서 "이름이 동일"해야 할 가능성이 매우 큼.
   // (지금은 일단 동일 name 유지)
-  QnnTensor x("x",   QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, x_dims);
-  QnnTensor y("y",   QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, y_dims);
-
-  QnnTensor wq("wq", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, weight_dims,
+  QnnTensor wq(N("wq"), QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, weight_dims,
                nullptr, qk_bytes, static_cast<const void*>(static_q));
-  QnnTensor wk("wk", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, weight_dims,
+  QnnTensor wk(N("wk"), QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_32, weight_dims,
                nullptr, qk_bytes, static_cast<const void*>(static_k));
-  QnnTensor wvprime("wvprime", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_UINT_8, v_qbit_dims,
+  QnnTensor wvprime(N("wvprime"), QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_UINT_8, v_qbit_dims,
                     nullptr, D * C, static_cast<const void*>(static_v));
   std::unique_ptr<QnnTensor> wv_ptr, cast_x_ptr, l_tns_ptr, scale_ptr, c_tns_ptr, vflat_ptr, cast_v_ptr, flat_x_ptr;
   if(!is_kv){
     wv_ptr = std::make_unique<QnnTensor>(
-        "wv", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, v_dims
+        N("wv"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, v_dims
     );
   } else{
     if(B != 1 || L != 1){
       std::cerr << "Decoding does not support batch and sequence length more than 1" << std::endl;
     }
-    flat_x_ptr = std::make_unique<QnnTensor>("flat_x_ptr", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flat_x_dims);
+    flat_x_ptr = std::make_unique<QnnTensor>(N("flat_x_ptr"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flat_x_dims);
     cast_x_ptr = std::make_unique<QnnTensor>(
-      "cast_x_tns", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, flat_x_dims 
+      N("cast_x_tns"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, flat_x_dims 
     );
-    l_tns_ptr = std::make_unique<QnnTensor>("l_tns", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_UINT_8, l_tns_dims);
-    scale_ptr = std::make_unique<QnnTensor>("scale", QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_16, scale_dims, nullptr, scale_bytes, static_cast<const void*>(static_sc));
-    c_tns_ptr = std::make_unique<QnnTensor>("c_tns", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_UINT_8, c_tns_dims);
-    vflat_ptr = std::make_unique<QnnTensor>("vflat_tns", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, flatten_o_dims);
-    cast_v_ptr = std::make_unique<QnnTensor>("cast_v_tns", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, o_dims);
+    l_tns_ptr = std::make_unique<QnnTensor>(N("l_tns"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_UINT_8, l_tns_dims);
+    scale_ptr = std::make_unique<QnnTensor>(N("scale"), QNN_TENSOR_TYPE_STATIC, QNN_DATATYPE_FLOAT_16, scale_dims, nullptr, scale_bytes, static_cast<const void*>(static_sc));
+    c_tns_ptr = std::make_unique<QnnTensor>(N("c_tns"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_UINT_8, c_tns_dims);
+    vflat_ptr = std::make_unique<QnnTensor>(N("vflat_tns"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, flatten_o_dims);
+    cast_v_ptr = std::make_unique<QnnTensor>(N("cast_v_tns"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_16, o_dims);
   }
 
-  QnnTensor q("q", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flatten_o_dims);
-  QnnTensor qprime("qprime", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
-  QnnTensor k("k", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flatten_o_dims);
-  QnnTensor kprime("kprime", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
-  QnnTensor v("v", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
-  QnnTensor attn("attn", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, attn_dims);
-  QnnTensor out("o", QNN_TENSOR_TYPE_APP_READ, QNN_DATATYPE_FLOAT_32, o_dims);
+  QnnTensor q(N("q"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flatten_o_dims);
+  QnnTensor qprime(N("qprime"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
+  QnnTensor k(N("k"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, flatten_o_dims);
+  QnnTensor kprime(N("kprime"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
+  QnnTensor v(N("v"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, o_dims);
+  QnnTensor attn(N("attn"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, attn_dims);
 
   // ---- Graph tensor 등록 ----
   if (!graph.EnsureTensorInGraph(x)) return false;
-  if (!graph.EnsureTensorInGraph(y)) return false;
   if (!graph.EnsureTensorInGraph(wq)) return false;
   if (!graph.EnsureTensorInGraph(wk)) return false;
   if (!graph.EnsureTensorInGraph(wvprime)) return false;
@@ -245,6 +400,21 @@ static bool BuildOneGraph(
 
   const char* kPackage = "qti.aisw";
 
+  // ---- KV cache read (+ concat tensors) ----
+  QnnTensor* k_all = &kprime;
+  QnnTensor* v_all = &v;
+  QnnTensor* k_past = nullptr;
+  QnnTensor* v_past = nullptr;
+  if (P) {
+    k_past = AddKvCacheRead(backend, graph, kv_keep, N("k_cache"), B, P, D, kv);
+    v_past = AddKvCacheRead(backend, graph, kv_keep, N("v_cache"), B, P, D, kv);
+    if (!k_past || !v_past) return false;
+    const std::vector<uint32_t> all_dims{B, P + L, D};
+    k_all = NewGraphTensor(graph, kv_keep, N("k_all"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, all_dims);
+    v_all = NewGraphTensor(graph, kv_keep, N("v_all"), QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, all_dims);
+    if (!k_all || !v_all) return false;
+  }
+
   // ---- Op 만들기 ----
 
   // q = x * wq, k = x * wk
@@ -252,9 +422,9 @@ static bool BuildOneGraph(
   // decoding : v = x * wvprime -> tmanlinear(x, wvprime)
   //     => cast_x = convert(x), l = precompute(x, scale), c = tmanlinear(l, w), out = finalize(c), cast_out = cast(out)
 
-  OpHolder matmul_q = MakeOpHolder("matmul_q", kPackage, "FullyConnected", x, &wq, nullptr, q,
+  OpHolder matmul_q = MakeOpHolder(N("matmul_q"), kPackage, "FullyConnected", x, &wq, nullptr, q,
                                    [&](OpHolder& oh){ oh.addScalarB8("keep_dims", 0); });
-  OpHolder matmul_k = MakeOpHolder("matmul_k", kPackage, "FullyConnected", x, &wk, nullptr, k,
+  OpHolder matmul_k = MakeOpHolder(N("matmul_k"), kPackage, "FullyConnected", x, &wk, nullptr, k,
                                    [&](OpHolder&){});
   OpHolder matmul_wv, matmul_v, reshape_x, cast_x, precompute, tmanlinear, finalize, reshape_v, cast_v;
   if(!is_kv){
@@ -263,37 +433,37 @@ static bool BuildOneGraph(
     //                                  [&](OpHolder&){});
     // matmul_v = MakeOpHolder("matmul_v", kPackage, "MatMul", x, wv_ptr.get(), nullptr, v,
     //                                [&](OpHolder& oh){ oh.addScalarB8("transpose_in1", 1); });
-    matmul_v = MakeOpHolder("matmul_v", kPackage, "MatMul", x, &wq, nullptr, v, [&](OpHolder& oh){});
+    matmul_v = MakeOpHolder(N("matmul_v"), kPackage, "MatMul", x, &wq, nullptr, v, [&](OpHolder& oh){});
   } else{
-    reshape_x = MakeOpHolder("reshape_x", kPackage, "Reshape", x, nullptr, nullptr, *flat_x_ptr, [&](OpHolder&){});
-    cast_x = MakeOpHolder("cast_x", kPackage, "Cast", *flat_x_ptr.get(), nullptr, nullptr, *cast_x_ptr, [&](OpHolder&){});
-    precompute = MakeOpHolder("precompute", "TMANOpPackage", "TMANPrecompute", *cast_x_ptr.get(), nullptr, nullptr, *l_tns_ptr, [&](OpHolder& oh){
+    reshape_x = MakeOpHolder(N("reshape_x"), kPackage, "Reshape", x, nullptr, nullptr, *flat_x_ptr, [&](OpHolder&){});
+    cast_x = MakeOpHolder(N("cast_x"), kPackage, "Cast", *flat_x_ptr.get(), nullptr, nullptr, *cast_x_ptr, [&](OpHolder&){});
+    precompute = MakeOpHolder(N("precompute"), "TMANOpPackage", "TMANPrecompute", *cast_x_ptr.get(), nullptr, nullptr, *l_tns_ptr, [&](OpHolder& oh){
       oh.addScalarI32("group_size", GROUP_SIZE);
       oh.addScalarI32("bits", BITS);
       oh.addScalarI32("symmetric", SYMMETRIC);
     });
 
-    tmanlinear = MakeOpHolder("tmanlinear", "TMANOpPackage", "TMANLinear", *l_tns_ptr.get(), &wvprime, scale_ptr.get(), *c_tns_ptr.get(), [&](OpHolder& oh){
+    tmanlinear = MakeOpHolder(N("tmanlinear"), "TMANOpPackage", "TMANLinear", *l_tns_ptr.get(), &wvprime, scale_ptr.get(), *c_tns_ptr.get(), [&](OpHolder& oh){
       oh.addScalarI32("group_size", GROUP_SIZE);
       oh.addScalarI32("bits", BITS);
       oh.addScalarI32("symmetric", SYMMETRIC);
     });
-    finalize = MakeOpHolder("finalize", "TMANOpPackage", "TMANFinalize", *c_tns_ptr.get(), nullptr, nullptr, *vflat_ptr.get(), [&](OpHolder& oh){
+    finalize = MakeOpHolder(N("finalize"), "TMANOpPackage", "TMANFinalize", *c_tns_ptr.get(), nullptr, nullptr, *vflat_ptr.get(), [&](OpHolder& oh){
       oh.addScalarI32("group_size", GROUP_SIZE);
       oh.addScalarI32("bits", BITS);
       oh.addScalarI32("symmetric", SYMMETRIC);
     });
     
-    reshape_v = MakeOpHolder("reshape_v", kPackage, "Reshape", *vflat_ptr.get(), nullptr, nullptr, *cast_v_ptr.get(), [&](OpHolder&){});
-    cast_v = MakeOpHolder("cast_v", kPackage, "Cast", *cast_v_ptr.get(), nullptr, nullptr, v, [&](OpHolder&){});
+    reshape_v = MakeOpHolder(N("reshape_v"), kPackage, "Reshape", *vflat_ptr.get(), nullptr, nullptr, *cast_v_ptr.get(), [&](OpHolder&){});
+    cast_v = MakeOpHolder(N("cast_v"), kPackage, "Cast", *cast_v_ptr.get(), nullptr, nullptr, v, [&](OpHolder&){});
   }
-  OpHolder reshape_q = MakeOpHolder("reshape_q", kPackage, "Reshape", q, nullptr, nullptr, qprime,
+  OpHolder reshape_q = MakeOpHolder(N("reshape_q"), kPackage, "Reshape", q, nullptr, nullptr, qprime,
                                     [&](OpHolder&){});
-  OpHolder reshape_k = MakeOpHolder("reshape_k", kPackage, "Reshape", k, nullptr, nullptr, kprime,
+  OpHolder reshape_k = MakeOpHolder(N("reshape_k"), kPackage, "Reshape", k, nullptr, nullptr, kprime,
                                     [&](OpHolder&){});
-  OpHolder matmul_attn = MakeOpHolder("matmul_attn", kPackage, "MatMul", qprime, &kprime, nullptr, attn,
+  OpHolder matmul_attn = MakeOpHolder(N("matmul_attn"), kPackage, "MatMul", qprime, k_all, nullptr, attn,
                                       [&](OpHolder& oh){ oh.addScalarB8("transpose_in1", 1); });
-  OpHolder matmul_o = MakeOpHolder("matmul_o", kPackage, "MatMul", attn, &v, nullptr, out,
+  OpHolder matmul_o = MakeOpHolder(N("matmul_o"), kPackage, "MatMul", attn, v_all, nullptr, out,
                                    [&](OpHolder&){});
 
   // ---- Validate + AddNode ----
@@ -329,16 +499,112 @@ static bool BuildOneGraph(
   }
   if (!validate_and_add(reshape_q, "reshape_q")) return false;
   if (!validate_and_add(reshape_k, "reshape_k")) return false;
+  if (P) {
+    // [past; this step] along the sequence axis. Built here, not above: OpHolder must not be moved after bind
+    OpHolder concat_k = MakeOpHolder(N("concat_k"), kPackage, "Concat", *k_past, &kprime, nullptr, *k_all,
+                                     [&](OpHolder& oh){ oh.addScalarU32("axis", 1); });
+    OpHolder concat_v = MakeOpHolder(N("concat_v"), kPackage, "Concat", *v_past, &v, nullptr, *v_all,
+                                     [&](OpHolder& oh){ oh.addScalarU32("axis", 1); });
+    if (!validate_and_add(concat_k, "concat_k")) return false;
+    if (!validate_and_add(concat_v, "concat_v")) return false;
+  }
   if (!validate_and_add(matmul_attn, "matmul_attn")) return false;
   // if (!validate_and_add(matmul_v, "matmul_v")) return false;
   if (!validate_and_add(matmul_o, "matmul_o")) return false;
 
+  // ---- KV cache write: this step's k/v ----
+  if (kv_on) {
+    if (!AddKvCacheWrite(backend, graph, kv_keep, N(P ? "k_new" : "k_cache"), kprime, B, L, D, kv)) return false;
+    if (!AddKvCacheWrite(backend, graph, kv_keep, N(P ? "v_new" : "v_cache"), v, B, L, D, kv)) return false;
+  }
+
+  return true;
+}
+
+static bool BuildOneGraph(
+    QnnBackendRuntime& backend,
+    QnnGraphRuntime& graph,
+    bool is_kv,
+    // (필요하면) seed나 차이 주는 파라미터 추가 가능
+    unsigned int B, unsigned int L, unsigned int D, unsigned int C,
+    uint8_t* static_v, uint8_t* static_sc, float* static_q, float* static_k,
+    unsigned int v_bytes, unsigned int qk_bytes, unsigned int scale_bytes,
+    const KvCacheSpec& kv = KvCacheSpec{}
+) {
+  std::vector<uint32_t> x_dims{B, L, C};
+  std::vector<uint32_t> y_dims{C, C};
+  std::vector<uint32_t> o_dims{B, L, D};
+
+  QnnTensor x("x",   QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, x_dims);
+  QnnTensor y("y",   QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, y_dims);
+  QnnTensor out("o", QNN_TENSOR_TYPE_APP_READ, QNN_DATATYPE_FLOAT_32, o_dims);
+
+  if (!graph.EnsureTensorInGraph(x)) return false;
+  if (!graph.EnsureTensorInGraph(y)) return false;
+
+  // prefill only writes the cache
+  KvCacheSpec block_kv = kv;
+  if (!is_kv) block_kv.past_len = 0;
+  if (!AddAttentionBlock(backend, graph, is_kv, "", x, out, B, L, D, C,
+                         static_v, static_sc, static_q, static_k,
+                         v_bytes, qk_bytes, scale_bytes, block_kv)) return false;
+
   // ---- Finalize ----
   if (!graph.Finalize()) return false;
 
   return true;
 }
 
+// Layers [layer_begin, layer_end) of the decode stack in one graph:
+//   hidden_in -> block_0 -> ... -> block_n -> hidden_out
+// hidden_in/hidden_out are the only graph IO so shards can be chained by the runtime.
+static bool BuildLayerRangeGraph(
+    QnnBackendRuntime& backend,
+    QnnGraphRuntime& graph,
+    unsigned int layer_begin, unsigned int layer_end,
+    unsigned int B, unsigned int L, unsigned int D, unsigned int C,
+    uint8_t* static_v, uint8_t* static_sc, float* static_q, float* static_k,
+    unsigned int v_bytes, unsigned int qk_bytes, unsigned int scale_bytes,
+    const KvCacheSpec& kv = KvCacheSpec{}
+) {
+  if (D != C) {
+    std::cerr << "Layer stacking needs D == C (block output feeds next block input)\n";
+    return false;
+  }
+  if (layer_end <= layer_begin) {
+    std::cerr << "Empty layer range [" << layer_begin << ", " << layer_end << ")\n";
+    return false;
+  }
+  std::vector<uint32_t> h_dims{B, L, C};
+
+  // keep every hidden tensor alive until Finalize (ops reference their names)
+  std::vector<std::unique_ptr<QnnTensor>> hidden;
+  hidden.push_back(std::make_unique<QnnTensor>(
+      "hidden_in", QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, h_dims));
+  if (!graph.EnsureTensorInGraph(*hidden.back())) return false;
+
+  for (unsigned int l = layer_begin; l < layer_end; ++l) {
+    const bool last = (l + 1 == layer_end);
+    const std::string prefix = "l" + std::to_string(l) + "_";
+    hidden.push_back(std::make_unique<QnnTensor>(
+        last ? std::string("hidden_out") : prefix + "hidden",
+        last ? QNN_TENSOR_TYPE_APP_READ : QNN_TENSOR_TYPE_NATIVE,
+        QNN_DATATYPE_FLOAT_32, h_dims));
+
+    QnnTensor& in = *hidden[hidden.size() - 2];
+    QnnTensor& o = *hidden.back();
+    if (!AddAttentionBlock(backend, graph, /*is_kv=*/true, prefix, in, o, B, L, D, C,
+                           static_v, static_sc, static_q, static_k,
+                           v_bytes, qk_bytes, scale_bytes, kv)) {
+      std::cerr << "AddAttentionBlock failed for layer " << l << "\n";
+      return false;
+    }
+  }
+
+  if (!graph.Finalize()) return false;
+  return true;
+}
+
 template <typename T>
 bool load_raw(const std::string& path, std::vector<T>& out, size_t numel) {
   out.resize(numel);
@@ -359,6 +625,52 @@ bool load_raw(const std::string& path, std::vector<T>& out, size_t numel) {
 }
 
 int main(int argc, char** argv) {
+    // ./qnn_offline_compiler                        => multi_graph.bin (kv_forward)
+    // ./qnn_offline_compiler --layers N --shards K  => shard_0.bin ... shard_{K-1}.bin
+    //   --log PATH (default qnn_aot.log) | --log-sync (stdout, old callback) | --log-rate N (lines/s per call site)
+    //   --log-level error|warn|info|debug|verbose (default verbose) : while graphs are built/finalized, INFO otherwise
+    //   --kv-cache off|f32|f16|int8 (default off) [--kv-heads H (16)] [--kv-past P (128)] : KV cache IO per block
+    unsigned int num_layers = 0;
+    unsigned int num_shards = 0;
+    // VERBOSE backend log: async ring -> file by default, --log-sync for the old stdout callback
+    std::string log_path = "qnn_aot.log";
+    bool log_sync = false;
+    uint32_t log_rate = 0;
+    QnnLog_Level_t build_log_level = QNN_LOG_LEVEL_VERBOSE;
+    KvCacheSpec kv;
+    kv.past_len = 128;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        if (a == "--layers" && i + 1 < argc) num_layers = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (a == "--shards" && i + 1 < argc) num_shards = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (a == "--log" && i + 1 < argc) log_path = argv[++i];
+        else if (a == "--log-sync") log_sync = true;
+        else if (a == "--log-rate" && i + 1 < argc) log_rate = static_cast<uint32_t>(std::stoul(argv[++i]));
+        else if (a == "--log-level" && i + 1 < argc) {
+            if (!QnnLogLevelFromStr(argv[++i], &build_log_level)) {
+                std::cerr << "--log-level expects error|warn|info|debug|verbose, got " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (a == "--kv-cache" && i + 1 < argc) {
+            if (!KvCacheModeFromStr(argv[++i], &kv.mode)) {
+                std::cerr << "--kv-cache expects off|f32|f16|int8, got " << argv[i] << "\n";
+                return -1;
+            }
+        }
+        else if (a == "--kv-heads" && i + 1 < argc) kv.heads = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (a == "--kv-past" && i + 1 < argc) kv.past_len = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else {
+            std::cerr << "unknown argument: " << a << "\n";
+            return -1;
+        }
+    }
+    const bool sharded = num_shards > 0;
+    if (sharded && (num_layers == 0 || num_shards > num_layers)) {
+        std::cerr << "--shards K needs --layers N with 0 < K <= N\n";
+        return -1;
+    }
+
     const std::string backend_so = "libQnnHtp.so";
     const std::string system_so = "libQnnSystem.so";
 
@@ -372,12 +684,29 @@ int main(int argc, char** argv) {
     std::cout << "QNN system loaded: systemId= " << qnn.System() << "\n";
     
     Qnn_LogHandle_t logHandle = nullptr;
-    if (!CreateQnnLogger(qnn.Backend(), &logHandle, QNN_LOG_LEVEL_VERBOSE)) {
+    QnnAsyncLogger::Instance().SetRateLimit(log_rate);
+    const bool log_ok = log_sync ? CreateQnnLogger(qnn.Backend(), &logHandle, QNN_LOG_LEVEL_INFO)
+                                 : CreateQnnAsyncLogger(qnn.Backend(), &logHandle, QNN_LOG_LEVEL_INFO, log_path);
+    if (!log_ok) {
         std::cerr << "Failed to create QNN logger (continuing without logger)\n";
         return -1;
     } else {
-        std::cout << "QNN logger created. logHandle=" << logHandle << "\n";
+        std::cout << "QNN logger created. logHandle=" << logHandle
+                  << (log_sync ? " (stdout)" : " (async -> " + log_path + ")") << "\n";
     }
+    // setup/teardown at INFO, graph build + finalize at --log-level (backend and async filter together)
+    auto set_log_level = [&](QnnLog_Level_t level) {
+        if (!SetQnnLogLevel(qnn.Backend(), logHandle, level)) {
+            std::cerr << "SetQnnLogLevel(" << level << ") failed (keeping the current level)\n";
+        }
+    };
+    auto report_log = [&]() {
+        if (log_sync) return;
+        QnnAsyncLogger::Instance().Stop();
+        const QnnAsyncLogger::Stats st = QnnAsyncLogger::Instance().GetStats();
+        std::cout << "QNN log: " << st.written << " lines -> " << log_path << " (dropped=" << st.dropped
+                  << ", suppressed=" << st.suppressed << ", threads=" << st.threads << ")\n";
+    };
 
     QnnBackendRuntime backend;
     if (!backend.Create(qnn.Backend(), /*logger_handler=*/logHandle)){
@@ -414,7 +743,7 @@ int main(int argc, char** argv) {
     QnnGraphRuntime graph_kv, graph_prefill;
     graph_kv.SetRestoreMode(false);
     graph_prefill.SetRestoreMode(false);
-    if (!graph_kv.Create(qnn.Backend(), ctx.Handle(), profiler.GetProfiler(), "kv_forward")) {
+    if (!sharded && !graph_kv.Create(qnn.Backend(), ctx.Handle(), profiler.GetProfiler(), "kv_forward")) {
         std::cerr << "graphCreate for kv graph failed\n";
         return -1;
     }
@@ -430,6 +759,16 @@ int main(int argc, char** argv) {
     unsigned int L = 1; // 일단
     unsigned int D = 2048;
     unsigned int C = 2048;
+    if (kv.mode != QnnKvCacheMode::kOff) {
+        if (kv.heads == 0 || D % kv.heads != 0) {
+            std::cerr << "--kv-heads " << kv.heads << " must divide D=" << D << "\n";
+            return -1;
+        }
+        const size_t dh = D / kv.heads;
+        std::cout << "KV cache " << KvCacheModeStr(kv.mode) << ": heads=" << kv.heads << " past=" << kv.past_len
+                  << ", K+V bytes per token per layer=" << 2 * KvCacheBytes(kv.mode, 1, kv.heads, dh)
+                  << " (f32: " << 2 * KvCacheBytes(QnnKvCacheMode::kF32, 1, kv.heads, dh) << ")\n";
+    }
     std::mt19937 rng(12345);
     std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
     unsigned int v_bytes = static_cast<uint32_t>(D * C * sizeof(uint8_t) / 2);
@@ -452,18 +791,63 @@ int main(int argc, char** argv) {
     std::vector<uint8_t> static_sc;
     if(!load_raw("/workspace/m2048_k8192_g128/s_repacked.bin", static_sc, D*C/BITS/GROUP_SIZE*4*2)) return -1;
 
+    set_log_level(build_log_level);
+    if (sharded) {
+        // contiguous layer ranges, one context (= one binary) per shard
+        for (unsigned int k = 0; k < num_shards; ++k) {
+            const unsigned int begin = num_layers * k / num_shards;
+            const unsigned int end = num_layers * (k + 1) / num_shards;
+            const std::string graph_name = "shard" + std::to_string(k) + "_forward";
+
+            QnnContextRuntime shard_ctx;
+            if (!shard_ctx.Create(qnn.Backend(), backend.Handle(), device.Handle())) {
+                std::cerr << "contextCreate failed for " << graph_name << "\n";
+                return -1;
+            }
+            QnnGraphRuntime shard_graph;
+            shard_graph.SetRestoreMode(false);
+            if (!shard_graph.Create(qnn.Backend(), shard_ctx.Handle(), profiler.GetProfiler(), graph_name)) {
+                std::cerr << "graphCreate failed for " << graph_name << "\n";
+                return -1;
+            }
+            if (!BuildLayerRangeGraph(backend, shard_graph, begin, end, B, L, D, C,
+                                      static_v.data(), static_sc.data(), static_q, static_k,
+                                      v_bytes, qk_bytes, scale_bytes, kv)) {
+                std::cerr << "BuildLayerRangeGraph failed for " << graph_name << "\n";
+                return -1;
+            }
+
+            set_log_level(QNN_LOG_LEVEL_INFO);
+            std::vector<uint8_t> shard_blob;
+            if (!shard_ctx.GetBinary(shard_blob)) return -1;
+            if (k + 1 < num_shards) set_log_level(build_log_level);
+
+            const std::string path = "shard_" + std::to_string(k) + ".bin";
+            std::ofstream sofs(path, std::ios::binary);
+            sofs.write(reinterpret_cast<const char*>(shard_blob.data()), shard_blob.size());
+            sofs.close();
+            std::cout << "OK: wrote " << path << " layers [" << begin << ", " << end << ") ("
+                      << shard_blob.size() << " bytes)\n";
+        }
+        delete[] static_q;
+        delete[] static_k;
+        report_log();
+        return 0;
+    }
+
     // if(!BuildOneGraph(backend, graph_prefill, false, B, L, D, C, nullptr, nullptr, static_q, static_k, v_bytes, qk_bytes)){
     //     std::cerr << "BuildOneGraph for prefill graph failed\n";
     //     return -1;
     // }
     // std::cout << "Build Prefill Graph\n";
 
-    if(!BuildOneGraph(backend, graph_kv, true, B, L, D, C, static_v.data(), static_sc.data(), static_q, static_k, v_bytes, qk_bytes, scale_bytes)){
+    if(!BuildOneGraph(backend, graph_kv, true, B, L, D, C, static_v.data(), static_sc.data(), static_q, static_k, v_bytes, qk_bytes, scale_bytes, kv)){
         std::cerr << "BuildOneGraph for kv graph failed\n";
         return -1;
     }
     std::cout << "Build KV Graph\n";
-    
+    set_log_level(QNN_LOG_LEVEL_INFO);
+
     std::vector<uint8_t> blob;
     if (!ctx.GetBinary(blob)) return -1;
 
@@ -475,6 +859,7 @@ int main(int argc, char** argv) {
 
     delete[] static_q;
     delete[] static_k;
+    report_log();
 
     // scope 종료 시 backend Destroy
     return 0;
@@ -0,0 +1,585 @@
+#include <benchmark/benchmark.h>
+
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "QnnInterface.h"
+#include "QnnTypes.h"
+#include "qnn_async_log.h"
+#include "qnn_backendcache.h"
+#include "qnn_context.h"
+#include "qnn_cpu_ref.h"
+#include "qnn_mem_handle_pool.h"
+#include "qnn_mem_manager.h"
+#include "qnn_perf.h"
+#include "qnn_prefix_cache.h"
+#include "qnn_scheduler.h"
+#include "qnn_sharedbuffer.h"
+#include "qnn_tensor.h"
+
+// Host hot-path microbenchmarks. Runs on any Linux box:
+// the QNN interface below is a stand-in (context/mem/perf-vote calls only) and the arena is plain malloc.
+// qnn_common must be built with QNN_HOST_RUNTIME so the device paths are compiled in.
+
+namespace standin {
+
+static std::atomic<uintptr_t> g_next_handle{0x1000};
+
+static Qnn_ErrorHandle_t ContextCreate(Qnn_BackendHandle_t, Qnn_DeviceHandle_t,
+                                       const QnnContext_Config_t**, Qnn_ContextHandle_t* ctx){
+    *ctx = reinterpret_cast<Qnn_ContextHandle_t>(g_next_handle.fetch_add(1));
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t ContextFree(Qnn_ContextHandle_t, Qnn_ProfileHandle_t){
+    return QNN_SUCCESS;
+}
+
+static std::atomic<uint64_t> g_mem_register_calls{0};
+
+static Qnn_ErrorHandle_t MemRegister(Qnn_ContextHandle_t, const Qnn_MemDescriptor_t*,
+                                     uint32_t num, Qnn_MemHandle_t* handles){
+    g_mem_register_calls.fetch_add(1);
+    for (uint32_t i = 0; i < num; ++i)
+        handles[i] = reinterpret_cast<Qnn_MemHandle_t>(g_next_handle.fetch_add(1));
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t MemDeRegister(const Qnn_MemHandle_t*, uint32_t){
+    return QNN_SUCCESS;
+}
+
+// perf infra: records how many votes were sent and the last power mode
+static std::atomic<uint64_t> g_power_votes{0};
+static std::atomic<int> g_power_mode{0};
+
+static Qnn_ErrorHandle_t CreatePowerConfigId(uint32_t, uint32_t, uint32_t* id){
+    *id = 1;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t DestroyPowerConfigId(uint32_t){
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t SetPowerConfig(uint32_t, const QnnHtpPerfInfrastructure_PowerConfig_t** cfg){
+    for (; *cfg; ++cfg){
+        if ((*cfg)->option == QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_DCVS_V3)
+            g_power_mode.store((*cfg)->dcvsV3Config.powerMode);
+    }
+    g_power_votes.fetch_add(1);
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t DeviceGetInfrastructure(const QnnDevice_Infrastructure_t* infra){
+    static QnnHtpDevice_Infrastructure_t htp = []{
+        QnnHtpDevice_Infrastructure_t i{};
+        i.infraType = QNN_HTP_DEVICE_INFRASTRUCTURE_TYPE_PERF;
+        i.perfInfra.createPowerConfigId = CreatePowerConfigId;
+        i.perfInfra.destroyPowerConfigId = DestroyPowerConfigId;
+        i.perfInfra.setPowerConfig = SetPowerConfig;
+        return i;
+    }();
+    *const_cast<QnnDevice_Infrastructure_t*>(infra) = reinterpret_cast<QnnDevice_Infrastructure_t>(&htp);
+    return QNN_SUCCESS;
+}
+
+static const QnnInterface_t* Interface(){
+    static QnnInterface_t iface = []{
+        QnnInterface_t i{};
+        i.QNN_INTERFACE_VER_NAME.contextCreate = ContextCreate;
+        i.QNN_INTERFACE_VER_NAME.contextFree = ContextFree;
+        i.QNN_INTERFACE_VER_NAME.memRegister = MemRegister;
+        i.QNN_INTERFACE_VER_NAME.memDeRegister = MemDeRegister;
+        i.QNN_INTERFACE_VER_NAME.deviceGetInfrastructure = DeviceGetInfrastructure;
+        return i;
+    }();
+    return &iface;
+}
+
+// malloc-backed arena; ArenaAlloc only does offset math
+struct HostArena{
+    explicit HostArena(size_t bytes){
+        a.base = std::aligned_alloc(64, bytes);
+        a.fd = 3;
+        a.total = bytes;
+        a.cursor = 0;
+        a.alignment = 64;
+    }
+    ~HostArena(){ std::free(a.base); }
+    SharedBuffer::Arena a;
+};
+
+// fills the protected IO tables directly (no system context)
+class Cache : public QnnBackendCacheRuntime{
+    public:
+    void Set(const std::string& graph, const std::vector<Qnn_Tensor_t>& in, const std::vector<Qnn_Tensor_t>& out){
+        auto io = std::make_shared<QnnGraphIoStorage>();
+        for (const auto& t : in) io->inputs.push_back(io->Own(t));
+        for (const auto& t : out) io->outputs.push_back(io->Own(t));
+        graph_io_[graph] = std::move(io);
+        graph_names_.push_back(graph);
+        state_ = DESERIALIZE;
+    }
+};
+
+static void* Fake(uintptr_t v){ return reinterpret_cast<void*>(v); }
+
+} // namespace standin
+
+// ---- SharedBuffer::ArenaAlloc ----
+static void BM_ArenaAlloc(benchmark::State& state){
+    standin::HostArena arena(64 << 20);
+    auto& sb = SharedBuffer::Instance();
+    const size_t bytes = static_cast<size_t>(state.range(0));
+    void* p = nullptr;
+    size_t off = 0;
+    for (auto _ : state){
+        // wrap before the arena is full, so the failing (stderr) path is never timed
+        if (arena.a.cursor + bytes + 64 > arena.a.total) arena.a.cursor = 0;
+        if (!sb.ArenaAlloc(arena.a, bytes, 64, &p, &off)){
+            state.SkipWithError("ArenaAlloc failed");
+            break;
+        }
+        benchmark::DoNotOptimize(p);
+    }
+}
+BENCHMARK(BM_ArenaAlloc)->Arg(64)->Arg(4096)->Arg(1 << 20);
+
+// ---- RegisterTensorInSharedArena: (fd, offset) handle cache hit ----
+static void BM_RegisterTensorCached(benchmark::State& state){
+    const int num_tensors = static_cast<int>(state.range(0));
+    QnnContextRuntime ctx;
+    ctx.Create(standin::Interface(), standin::Fake(1), standin::Fake(2));
+    QnnMemManagerRuntime mem;
+    mem.Init(standin::Interface(), &ctx);
+
+    standin::HostArena arena(64 << 20);
+    auto& sb = SharedBuffer::Instance();
+    QnnTensor t("x", QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, {1, 1, 2048});
+    Qnn_Tensor_t meta = t.Clone();
+
+    void* p = nullptr;
+    Qnn_MemHandle_t h = nullptr;
+    // first pass registers, later passes hit sb_handle_by_key_
+    for (int i = 0; i < num_tensors; ++i) mem.RegisterTensorInSharedArena(sb, arena.a, meta, 8192, 64, &p, &h);
+
+    for (auto _ : state){
+        arena.a.cursor = 0;
+        for (int i = 0; i < num_tensors; ++i){
+            mem.RegisterTensorInSharedArena(sb, arena.a, meta, 8192, 64, &p, &h);
+        }
+        benchmark::DoNotOptimize(h);
+    }
+    state.SetItemsProcessed(state.iterations() * num_tensors);
+}
+BENCHMARK(BM_RegisterTensorCached)->Arg(2)->Arg(64);
+
+// ---- session churn: new QnnMemManagerRuntime per iteration, same arena ----
+// Arg(0): max idle 0 => every teardown deregisters, next session registers again (one batch)
+// Arg(1): handles stay idle in QnnMemHandlePool => no memRegister after the first session
+static void BM_MemHandlePoolSessionChurn(benchmark::State& state){
+    constexpr int kTensors = 64;
+    auto& pool = QnnMemHandlePool::Instance();
+    pool.SetMaxIdle(state.range(0) ? 1024 : 0);
+
+    QnnContextRuntime ctx;
+    ctx.Create(standin::Interface(), standin::Fake(1), standin::Fake(2));
+    standin::HostArena arena(64 << 20);
+    QnnTensor t("x", QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, {1, 1, 2048});
+    std::vector<Qnn_Tensor_t> metas(kTensors, t.Clone());
+    std::vector<Qnn_Tensor_t*> tensors;
+    std::vector<size_t> offsets;
+    for (int i = 0; i < kTensors; ++i){
+        tensors.push_back(&metas[i]);
+        offsets.push_back(static_cast<size_t>(i) * 8192);
+    }
+
+    const uint64_t calls0 = standin::g_mem_register_calls.load();
+    std::vector<void*> ptrs;
+    std::vector<Qnn_MemHandle_t> handles;
+    for (auto _ : state){
+        QnnMemManagerRuntime mem;
+        mem.Init(standin::Interface(), &ctx);
+        mem.RegisterTensorsAtArenaOffsets(arena.a, tensors, offsets, &ptrs, &handles);
+        benchmark::DoNotOptimize(handles.data());
+    }
+    state.counters["memRegister/iter"] = benchmark::Counter(
+        static_cast<double>(standin::g_mem_register_calls.load() - calls0), benchmark::Counter::kAvgIterations);
+    state.SetItemsProcessed(state.iterations() * kTensors);
+    ctx.Destroy();  // DropContext
+    pool.SetMaxIdle(1024);
+}
+BENCHMARK(BM_MemHandlePoolSessionChurn)->Arg(0)->Arg(1);
+
+// ---- QnnTensor ----
+static void BM_QnnTensorConstruct(benchmark::State& state){
+    const std::vector<uint32_t> dims{1, 30, 2048};
+    for (auto _ : state){
+        QnnTensor t("l0_matmul_q_out", QNN_TENSOR_TYPE_NATIVE, QNN_DATATYPE_FLOAT_32, dims);
+        benchmark::DoNotOptimize(t.Tensor());
+    }
+}
+BENCHMARK(BM_QnnTensorConstruct);
+
+static void BM_QnnTensorClone(benchmark::State& state){
+    QnnTensor t("x", QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32, {1, 30, 2048});
+    for (auto _ : state){
+        Qnn_Tensor_t c = t.Clone();
+        benchmark::DoNotOptimize(c);
+    }
+}
+BENCHMARK(BM_QnnTensorClone);
+
+// ---- QnnBackendCacheRuntime IO meta ----
+static void FillCache(standin::Cache& cache, int n){
+    std::vector<QnnTensor> owners;
+    owners.reserve(n);
+    std::vector<Qnn_Tensor_t> metas;
+    for (int i = 0; i < n; ++i){
+        owners.emplace_back("in" + std::to_string(i), QNN_TENSOR_TYPE_APP_WRITE, QNN_DATATYPE_FLOAT_32,
+                            std::vector<uint32_t>{1, 1, 2048});
+        metas.push_back(owners.back().Clone());
+    }
+    cache.Set("kv_forward", metas, metas);
+}
+
+// legacy: vector copy each call
+static void BM_GetGraphInputs(benchmark::State& state){
+    standin::Cache cache;
+    FillCache(cache, static_cast<int>(state.range(0)));
+    for (auto _ : state){
+        auto in = cache.GetGraphInputs("kv_forward");
+        benchmark::DoNotOptimize(in.data());
+    }
+}
+BENCHMARK(BM_GetGraphInputs)->Arg(2)->Arg(64);
+
+// stable reference, no allocation
+static void BM_GraphInputsRef(benchmark::State& state){
+    standin::Cache cache;
+    FillCache(cache, static_cast<int>(state.range(0)));
+    for (auto _ : state){
+        const auto& in = cache.GraphInputs("kv_forward");
+        benchmark::DoNotOptimize(in.data());
+    }
+}
+BENCHMARK(BM_GraphInputsRef)->Arg(2)->Arg(64);
+
+// hot-path rebind of a pre-built binding (memType/clientBuf only)
+static void BM_BindingRebind(benchmark::State& state){
+    standin::Cache cache;
+    FillCache(cache, static_cast<int>(state.range(0)));
+    QnnGraphBinding b = cache.MakeBinding("kv_forward");
+    std::vector<uint8_t> buf(8192);
+    for (auto _ : state){
+        for (auto& t : b.inputs){
+            auto* tv = QNN_TENSOR_VER_PTR(t);
+            tv->memType = QNN_TENSORMEMTYPE_RAW;
+            tv->clientBuf.data = buf.data();
+            tv->clientBuf.dataSize = static_cast<uint32_t>(buf.size());
+        }
+        benchmark::DoNotOptimize(b.inputs.data());
+    }
+}
+BENCHMARK(BM_BindingRebind)->Arg(2)->Arg(64);
+
+// ---- output setup of RunOneGraph (QnnMemManagerRuntime::BindOutputsInSharedArena) ----
+// range(0): outputs per graph; range(1)=1: every output on an alias slice
+static void BM_OutputBufferSetup(benchmark::State& state){
+    const int num_outputs = static_cast<int>(state.range(0));
+    const bool aliased = state.range(1) != 0;
+    QnnContextRuntime ctx;
+    ctx.Create(standin::Interface(), standin::Fake(1), standin::Fake(2));
+    QnnMemManagerRuntime mem;
+    mem.Init(standin::Interface(), &ctx);
+
+    standin::HostArena arena(64 << 20);
+    auto& sb = SharedBuffer::Instance();
+    QnnArenaAliasMap aliases;
+    std::vector<QnnTensor> owners;
+    owners.reserve(num_outputs);
+    std::vector<Qnn_Tensor_t> outputs;
+    std::vector<std::string> names;
+    for (int i = 0; i < num_outputs; ++i){
+        owners.emplace_back("out" + std::to_string(i), QNN_TENSOR_TYPE_APP_READ, QNN_DATATYPE_FLOAT_32,
+                            std::vector<uint32_t>{1, 1, 2048});
+        outputs.push_back(owners.back().Clone());
+        names.push_back("slice" + std::to_string(i));
+    }
+    std::vector<const std::string*> alias_of;
+    if (aliased) for (const std::string& n : names) alias_of.push_back(&n);
+
+    std::vector<void*> ptrs;
+    std::vector<size_t> bytes;
+    for (auto _ : state){
+        arena.a.cursor = 0;
+        if (!mem.BindOutputsInSharedArena(sb, arena.a, outputs, &aliases, alias_of, &ptrs, &bytes)){
+            state.SkipWithError("BindOutputsInSharedArena failed");
+            break;
+        }
+        benchmark::DoNotOptimize(ptrs.data());
+    }
+    state.SetItemsProcessed(state.iterations() * num_outputs);
+}
+BENCHMARK(BM_OutputBufferSetup)->Args({2, 0})->Args({64, 0})->Args({2, 1});
+
+// ---- CPU reference kernel ----
+static void BM_BatchMatmulF32(benchmark::State& state){
+    const int M = 1, K = static_cast<int>(state.range(0)), N = static_cast<int>(state.range(0));
+    std::vector<float> a(static_cast<size_t>(M) * K, 0.5f), b(static_cast<size_t>(K) * N, 0.25f), out(static_cast<size_t>(M) * N);
+    for (auto _ : state){
+        batch_matmul_f32(a.data(), b.data(), out.data(), 1, M, K, N, 1, /*transposeB=*/true);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(M) * K * N);
+}
+BENCHMARK(BM_BatchMatmulF32)->Arg(256)->Arg(1024);
+
+// ---- QnnHtpPerfScope: burst around one decode step ----
+// range(0)=1: an outer burst is already held, so the inner scope must not vote at all
+static void BM_PerfScopeBurst(benchmark::State& state){
+    const bool nested = state.range(0) != 0;
+    QnnHtpPerfRuntime perf;
+    if (!perf.Create(standin::Interface(), QnnHtpPowerProfile::kBalanced)){
+        state.SkipWithError("perf Create failed");
+        return;
+    }
+    std::unique_ptr<QnnHtpPerfScope> outer;
+    if (nested) outer = std::make_unique<QnnHtpPerfScope>(&perf, QnnHtpPowerProfile::kBurst);
+
+    const uint64_t votes0 = standin::g_power_votes.load();
+    for (auto _ : state){
+        QnnHtpPerfScope burst(&perf, QnnHtpPowerProfile::kBurst);
+        benchmark::DoNotOptimize(&burst);
+    }
+    const uint64_t votes = standin::g_power_votes.load() - votes0;
+    const uint64_t expect = nested ? 0 : 2 * state.iterations();  // up + back to idle
+    if (votes != expect) state.SkipWithError("unexpected number of power votes");
+    if (!nested && standin::g_power_mode.load() != QNN_HTP_PERF_INFRASTRUCTURE_POWERMODE_ADJUST_UP_DOWN)
+        state.SkipWithError("idle (balanced) vote was not restored");
+    state.counters["votes_per_iter"] = static_cast<double>(votes) / state.iterations();
+}
+BENCHMARK(BM_PerfScopeBurst)->Arg(0)->Arg(1);
+
+// ---- SharedBuffer AllocMem/FreeMem stress: many sessions in one process ----
+// needs a real rpcmem provider: QNN_RPCMEM_LIB=libQnnNull.so (memfd backed) on host.
+// each thread keeps a window of live blocks (mixed sizes) and frees the oldest one per iteration.
+static void BM_SharedBufferAllocFree(benchmark::State& state){
+    auto& sb = SharedBuffer::Instance();
+    static const size_t kSizes[] = {4 << 10, 64 << 10, 256 << 10, 2 << 20};
+    constexpr size_t kWindow = 16;
+    void* live[kWindow] = {};
+    size_t k = static_cast<size_t>(state.thread_index()) * 7;
+    bool ok = true;
+
+    for (auto _ : state){
+        const size_t slot = k % kWindow;
+        if (live[slot]){
+            if (!sb.IsAllocated(live[slot])){ ok = false; break; }
+            sb.FreeMem(live[slot]);
+        }
+        const size_t bytes = kSizes[(k * 2654435761u) % 4];
+        live[slot] = sb.AllocMem(bytes, 64);
+        if (!live[slot]){ ok = false; break; }
+        static_cast<uint8_t*>(live[slot])[0] = static_cast<uint8_t>(k);
+        static_cast<uint8_t*>(live[slot])[bytes - 1] = static_cast<uint8_t>(k);
+        ++k;
+    }
+    for (void* p : live) if (p) sb.FreeMem(p);
+
+    if (!ok){
+        state.SkipWithError("AllocMem/IsAllocated failed (set QNN_RPCMEM_LIB=libQnnNull.so on host)");
+        return;
+    }
+    state.SetItemsProcessed(state.iterations());
+    if (state.thread_index() == 0){
+        const auto st = sb.GetStats();
+        state.counters["thread_cache_hit%"] = st.allocs ? 100.0 * st.thread_cache_hits / st.allocs : 0.0;
+        state.counters["rpcmem_allocs"] = static_cast<double>(st.rpcmem_allocs);
+    }
+}
+BENCHMARK(BM_SharedBufferAllocFree)->ThreadRange(1, 16)->UseRealTime();
+
+// ---- session churn: a session allocates its IO buffers, runs, frees them ----
+// range(0)=0: pool disabled (only the <=1MiB thread cache helps), 1: default pool limit
+static void BM_SharedBufferSessionChurn(benchmark::State& state){
+    auto& sb = SharedBuffer::Instance();
+    const bool pool = state.range(0) != 0;
+    sb.Trim(0);
+    sb.SetPoolLimit(pool ? SharedBuffer::kDefaultPoolLimit : 0);
+
+    // KV-cache-ish mix: a few large, some small
+    static const size_t kSizes[] = {8 << 10, 8 << 10, 256 << 10, 256 << 10, 3 << 20, 3 << 20, 12 << 20};
+    std::vector<void*> bufs;
+    const uint64_t rpc0 = sb.GetStats().rpcmem_allocs;
+    bool ok = true;
+    for (auto _ : state){
+        for (size_t b : kSizes){
+            void* p = sb.AllocMem(b, 64);
+            if (!p){ ok = false; break; }
+            bufs.push_back(p);
+        }
+        for (void* p : bufs) sb.FreeMem(p);
+        bufs.clear();
+        if (!ok) break;
+    }
+    const uint64_t rpc = sb.GetStats().rpcmem_allocs - rpc0;
+    sb.Trim(0);
+    sb.SetPoolLimit(SharedBuffer::kDefaultPoolLimit);
+    if (!ok){
+        state.SkipWithError("AllocMem failed (set QNN_RPCMEM_LIB=libQnnNull.so on host)");
+        return;
+    }
+    state.counters["rpcmem_allocs_per_session"] = static_cast<double>(rpc) / state.iterations();
+}
+BENCHMARK(BM_SharedBufferSessionChurn)->Arg(0)->Arg(1);
+
+// ---- backend log line: synchronous vfprintf + fflush (logStdoutCallback) vs QnnAsyncLogger ----
+// range(0)=0: sync to a file, 1: async ring -> same kind of file. Time is what the backend thread pays per line.
+static FILE* g_sync_log = nullptr;
+
+static void SyncFileCallback(const char* fmt, QnnLog_Level_t level, uint64_t, va_list argp){
+    std::fprintf(g_sync_log, "[%d] ", static_cast<int>(level));
+    std::vfprintf(g_sync_log, fmt, argp);
+    std::fprintf(g_sync_log, "\n");
+    std::fflush(g_sync_log);
+}
+
+static void CallLog(QnnLog_Callback_t cb, QnnLog_Level_t level, const char* fmt, ...){
+    va_list ap;
+    va_start(ap, fmt);
+    cb(fmt, level, 0, ap);
+    va_end(ap);
+}
+
+static void BM_QnnLogLine(benchmark::State& state){
+    const bool async = state.range(0) != 0;
+    const std::string path = async ? "/tmp/qnn_microbench_async.log" : "/tmp/qnn_microbench_sync.log";
+    auto& logger = QnnAsyncLogger::Instance();
+    QnnLog_Callback_t cb = &SyncFileCallback;
+    const QnnAsyncLogger::Stats st0 = logger.GetStats();
+    if (async){
+        if (!logger.Start(path, QNN_LOG_LEVEL_VERBOSE)){
+            state.SkipWithError("QnnAsyncLogger Start failed");
+            return;
+        }
+        cb = &QnnAsyncLogger::Callback;
+    } else {
+        g_sync_log = std::fopen(path.c_str(), "w");
+        if (!g_sync_log){
+            state.SkipWithError("fopen failed");
+            return;
+        }
+    }
+    uint64_t i = 0;
+    for (auto _ : state){
+        CallLog(cb, QNN_LOG_LEVEL_VERBOSE, "<V> op %s: tensor %llu, rank %u, bytes %zu",
+                "QNN_OP_TMAN_GEMM", static_cast<unsigned long long>(i), 4u, static_cast<size_t>(i * 64));
+        ++i;
+    }
+    if (async){
+        logger.Stop();
+        const auto st = logger.GetStats();
+        // a tight loop outruns any disk; real backends log orders of magnitude slower
+        state.counters["dropped%"] = 100.0 * static_cast<double>(st.dropped - st0.dropped) / state.iterations();
+    } else {
+        std::fclose(g_sync_log);
+        g_sync_log = nullptr;
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_QnnLogLine)->Arg(0)->Arg(1);
+
+// ---- prefix cache: host cost of one request's prompt ([1, 128, 2048] f32, chunk 16) ----
+// range(0)=1: whole prompt cached (hash + lookup + pages copied to the output), 0: first chunk differs (hash + lookup only)
+// needs QNN_RPCMEM_LIB=libQnnNull.so on host (pages are SharedBuffer blocks)
+static void BM_PrefixCacheRequest(benchmark::State& state){
+    const bool hit = state.range(0) != 0;
+    constexpr size_t kTokens = 128, kChunk = 16, kRow = 2048 * sizeof(float);
+    constexpr size_t kChunks = kTokens / kChunk, kPage = kChunk * kRow;
+    std::vector<uint8_t> prompt(kTokens * kRow), other(kTokens * kRow), out(kTokens * kRow);
+    for (size_t i = 0; i < prompt.size(); ++i){
+        prompt[i] = static_cast<uint8_t>(i * 131);
+        other[i] = static_cast<uint8_t>(i * 137 + 1);
+    }
+    auto chain_of = [&](const std::vector<uint8_t>& p){
+        std::vector<QnnPrefixKey> chain(kChunks);
+        QnnPrefixKey k = QnnPrefixCache::Root();
+        for (size_t c = 0; c < kChunks; ++c) chain[c] = k = QnnPrefixCache::Extend(k, p.data() + c * kPage, kPage);
+        return chain;
+    };
+
+    QnnPrefixCache cache;
+    if (!cache.Init(kChunk, kPage, 64 << 20)){
+        state.SkipWithError("PrefixCache Init failed");
+        return;
+    }
+    const std::vector<QnnPrefixKey> cached = chain_of(prompt);
+    for (size_t c = 0; c < kChunks; ++c){
+        void* page = cache.Insert(c ? cached[c - 1] : QnnPrefixCache::Root(), cached[c]);
+        if (!page){
+            state.SkipWithError("Insert failed (set QNN_RPCMEM_LIB=libQnnNull.so on host)");
+            return;
+        }
+        std::memcpy(page, prompt.data() + c * kPage, kPage);
+        cache.Unpin(cached[c]);
+    }
+
+    const std::vector<uint8_t>& req = hit ? prompt : other;
+    std::vector<const void*> pages;
+    for (auto _ : state){
+        const std::vector<QnnPrefixKey> chain = chain_of(req);
+        const size_t m = cache.Lookup(chain, &pages);
+        for (size_t c = 0; c < m; ++c) std::memcpy(out.data() + c * kPage, pages[c], kPage);
+        for (size_t c = 0; c < m; ++c) cache.Unpin(chain[c]);
+        benchmark::DoNotOptimize(out.data());
+    }
+    state.SetBytesProcessed(state.iterations() * kTokens * kRow);
+    state.counters["matched_chunks"] = static_cast<double>(cache.GetStats().hit_chunks) / state.iterations();
+}
+BENCHMARK(BM_PrefixCacheRequest)->Arg(0)->Arg(1);
+
+// host cost of one continuous-batching step (Schedule + Complete) while 64 requests drain
+// through 1/4/8-row decode buckets and 32/128-token prefill chunks
+static void BM_BatchSchedulerStep(benchmark::State& state){
+    const std::vector<QnnStepGraph> graphs = {
+        {"decode_b1", 1, 1}, {"decode_b4", 4, 1}, {"decode_b8", 8, 1},
+        {"prefill_l32", 1, 32}, {"prefill_l128", 1, 128},
+    };
+    QnnBatchScheduler::Options opt;
+    opt.max_running = static_cast<uint32_t>(state.range(0));
+    opt.max_step_tokens = 256;
+    uint64_t steps = 0, tokens = 0, padded = 0;
+    QnnStepPlan plan;
+    for (auto _ : state){
+        state.PauseTiming();
+        QnnBatchScheduler sched;
+        if (!sched.Init(graphs, opt)){
+            state.SkipWithError("Scheduler Init failed");
+            return;
+        }
+        for (uint32_t r = 0; r < 64; ++r) sched.Submit(40 + (r * 37) % 200, 16 + (r * 11) % 48);
+        state.ResumeTiming();
+        while (sched.Schedule(&plan)){
+            sched.Complete(plan);
+            ++steps;
+        }
+        const auto st = sched.GetStats();
+        tokens += st.decode_tokens + st.prefill_tokens;
+        padded += st.padded_tokens;
+    }
+    state.counters["steps"] = static_cast<double>(steps) / state.iterations();
+    state.counters["pad_pct"] = tokens + padded ? 100.0 * padded / (tokens + padded) : 0.0;
+}
+BENCHMARK(BM_BatchSchedulerStep)->Arg(1)->Arg(8)->Arg(32);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "QnnLog.h"
+
+// QNN log callback that does not block the calling (backend) thread.
+//   - each logging thread formats into its own SPSC ring (no lock after the thread's first line)
+//   - a background thread drains every ring to a file every flush_interval_ms
+//   - level is an atomic, adjustable at runtime (SetQnnLogLevel in qnn_log.h also tells the backend)
+//   - per call site (fmt pointer) at most N lines per second, the rest are counted and reported
+// ring이 가득 차면 그 line은 버리고 dropped로 센다 (backend thread를 절대 기다리게 하지 않음).
+// VERBOSE로 graph finalize를 돌려도 stdout에 동기 vfprintf + fflush 하던 것보다 훨씬 덜 느려진다.
+class QnnAsyncLogger{
+    public:
+    static constexpr size_t kSlotText = 472;    // bytes of text per line, longer lines are truncated
+    static constexpr size_t kRingSlots = 1024;  // per thread, power of two
+
+    // never destroyed (backend threads may log during exit); the tail is flushed by an atexit-time Stop()
+    static QnnAsyncLogger& Instance();
+
+    // path "-" => stdout
+    bool Start(const std::string& path, QnnLog_Level_t level, uint32_t flush_interval_ms = 50);
+    // drain everything, stop the thread, close the file. Lines logged afterwards are dropped
+    void Stop();
+    bool IsRunning() const { return running_.load(std::memory_order_acquire); }
+
+    void SetLevel(QnnLog_Level_t level){ level_.store(static_cast<int>(level), std::memory_order_relaxed); }
+    QnnLog_Level_t Level() const { return static_cast<QnnLog_Level_t>(level_.load(std::memory_order_relaxed)); }
+
+    // max lines per second for one call site (fmt), 0 = unlimited
+    void SetRateLimit(uint32_t max_per_sec){ rate_limit_.store(max_per_sec, std::memory_order_relaxed); }
+
+    void Log(QnnLog_Level_t level, const char* fmt, va_list argp);
+
+    // QnnLog_Callback_t
+    static void Callback(const char* fmt, QnnLog_Level_t level, uint64_t timestamp, va_list argp);
+
+    struct Stats{
+        uint64_t written{0};     // lines written to the file
+        uint64_t dropped{0};     // ring full or logger stopped
+        uint64_t suppressed{0};  // rate limited
+        size_t threads{0};       // rings (threads that ever logged)
+    };
+    Stats GetStats() const;
+
+    private:
+    QnnAsyncLogger() = default;
+    QnnAsyncLogger(const QnnAsyncLogger&) = delete;
+    QnnAsyncLogger& operator=(const QnnAsyncLogger&) = delete;
+
+    struct Slot{
+        double ms;
+        uint32_t len;
+        uint8_t level;
+        char text[kSlotText];
+    };
+    struct Ring;
+
+    Ring& LocalRing();
+    bool Push(Ring& r, QnnLog_Level_t level, const char* fmt, va_list argp);
+    void PushLine(Ring& r, QnnLog_Level_t level, const char* fmt, ...);
+    size_t DrainLocked();  // consumer side, under drain_mu_
+
+    std::atomic<bool> running_{false};
+    std::atomic<int> level_{QNN_LOG_LEVEL_INFO};
+    std::atomic<uint32_t> rate_limit_{0};
+
+    // rings are only added (under rings_mu_), never removed: a thread may still hold its pointer
+    mutable std::mutex rings_mu_;
+    std::vector<std::unique_ptr<Ring>> rings_;
+
+    std::mutex drain_mu_;  // consumer + file
+    FILE* out_{nullptr};
+    bool owns_out_{false};
+
+    std::mutex thread_mu_;
+    std::condition_variable cv_;
+    std::thread thread_;
+    bool stop_{false};
+    uint32_t flush_interval_ms_{50};
+
+    std::atomic<uint64_t> written_{0};
+    std::atomic<uint64_t> dropped_{0};
+    std::atomic<uint64_t> suppressed_{0};
+};
@@ -5,6 +5,8 @@
 #include <QnnTypes.h>
 
 #include <cstdint>
+#include <deque>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -15,6 +17,33 @@ struct QnnContextBinary {
   uint32_t nbytes{0};
 };
 
+// 한 graph의 IO tensor meta를 소유하는 storage.
+// name/dimensions/per-axis scale 배열을 복사해 두므로 system context의 parsed memory를 가리키지 않는다.
+struct QnnGraphIoStorage {
+  std::vector<Qnn_Tensor_t> inputs;
+  std::vector<Qnn_Tensor_t> outputs;
+
+  // src의 pointer 멤버를 owned storage로 바꾼 복사본
+  Qnn_Tensor_t Own(const Qnn_Tensor_t& src);
+
+ private:
+  // deque: push_back해도 기존 원소 주소가 안 바뀜
+  std::deque<std::string> names_;
+  std::deque<std::vector<uint32_t>> dims_;
+  std::deque<std::vector<uint8_t>> dynamic_dims_;
+  std::deque<std::vector<Qnn_ScaleOffset_t>> scale_offsets_;
+};
+
+// graph마다 한 번 만들어 두고 memType/clientBuf/memHandle만 바꿔서 graphExecute에 넘기는 template.
+// meta를 shared_ptr로 잡고 있어서 cache Destroy() 이후에도 name/dims가 유효하다.
+struct QnnGraphBinding {
+  std::shared_ptr<const QnnGraphIoStorage> meta;
+  std::vector<Qnn_Tensor_t> inputs;
+  std::vector<Qnn_Tensor_t> outputs;
+
+  bool Empty() const { return inputs.empty() && outputs.empty(); }
+};
+
 class QnnBackendCacheRuntime {
  public:
   enum CacheState {
@@ -41,7 +70,16 @@ class QnnBackendCacheRuntime {
 
   bool IsValid() const { return sys_context_handle_ != nullptr; }
   CacheState State() const { return state_; }
+  const std::vector<std::string>& GraphNames() const { return graph_names_; }
+
+  // owned meta, 주소는 Destroy()까지 유지 (miss면 empty)
+  const std::vector<Qnn_Tensor_t>& GraphInputs(const std::string& graph_name) const;
+  const std::vector<Qnn_Tensor_t>& GraphOutputs(const std::string& graph_name) const;
+
+  // mutable IO template (setup 시 한 번). hot path에서는 binding.inputs/outputs를 재사용
+  QnnGraphBinding MakeBinding(const std::string& graph_name) const;
 
+  // 호출마다 vector 복사. 새 코드는 MakeBinding 사용
   std::vector<Qnn_Tensor_t> GetGraphInputs(const std::string& graph_name) const;
   std::vector<Qnn_Tensor_t> GetGraphOutputs(const std::string& graph_name) const;
 
@@ -65,8 +103,7 @@ class QnnBackendCacheRuntime {
   std::vector<std::string> graph_names_;
   std::string aot_graph_name_;
 
-  std::unordered_map<std::string, std::vector<Qnn_Tensor_t>> input_tensor_structs_;
-  std::unordered_map<std::string, std::vector<Qnn_Tensor_t>> output_tensor_structs_;
+  std::unordered_map<std::string, std::shared_ptr<QnnGraphIoStorage>> graph_io_;
 };
 
 // HTP 전용 확장 (원하면 사용)
@@ -0,0 +1,164 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "qnn_kv_cache.h"
+
+// reference cpu code
+// A: [B, M, K]
+// B: if (!transposeB) [BB, K, N]
+//    if ( transposeB) [BB, N, K]  (we use B^T in multiplication)
+//    BB must be 1 or B
+// Out: [B, M, N]
+inline void batch_matmul_f32(
+    const float* A,
+    const float* Bm,
+    float* Out,
+    int B, int M, int K, int N, int BB,
+    bool transposeB)
+{
+  // zero init
+  for (int b = 0; b < B; ++b) {
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        Out[((b*M + i)*N) + j] = 0.0f;
+      }
+    }
+  }
+
+  for (int b = 0; b < B; ++b) {
+    const float* Ab = A  + (size_t)b * M * K;
+    const float* Bb;
+    if(BB == 1){
+        Bb = Bm;
+    } else{
+        // BB == B
+        Bb = Bm + (size_t)b * (transposeB ? (size_t)N*K : (size_t)K*N);
+    }
+    
+    float* Ob       = Out+ (size_t)b * M * N;
+
+    for (int i = 0; i < M; ++i) {
+      for (int j = 0; j < N; ++j) {
+        float acc = 0.0f;
+        for (int k = 0; k < K; ++k) {
+          const float a = Ab[(size_t)i*K + k];
+
+          // 핵심: transposeB면 B의 "원본" shape이 [N, K]
+          // 곱셈에서는 B^T를 쓰므로, B^T의 (k, j)는 원본 B의 (j, k)
+          const float bval = transposeB
+              ? Bb[(size_t)j*K + k]   // B_original[j, k]
+              : Bb[(size_t)k*N + j];  // B_original[k, j]
+
+          acc += a * bval;
+        }
+        Ob[(size_t)i*N + j] = acc;
+      }
+    }
+  }
+}
+
+// IEEE half <-> float (round to nearest even), same as the HTP Cast
+inline uint16_t f32_to_f16(float f)
+{
+  uint32_t x;
+  std::memcpy(&x, &f, 4);
+  const uint32_t sign = (x >> 16) & 0x8000u;
+  const uint32_t absx = x & 0x7fffffffu;
+  if (absx >= 0x7f800000u) return static_cast<uint16_t>(sign | 0x7c00u | (absx > 0x7f800000u ? 0x200u : 0u));  // inf / nan
+  if (absx >= 0x477ff000u) return static_cast<uint16_t>(sign | 0x7c00u);  // overflow -> inf
+  if (absx < 0x38800000u) {
+    // subnormal half (or zero)
+    if (absx < 0x33000000u) return static_cast<uint16_t>(sign);
+    const uint32_t e = absx >> 23;
+    const uint32_t m = (absx & 0x7fffffu) | 0x800000u;
+    const uint32_t shift = 126 - e;
+    uint32_t h = m >> shift;
+    const uint32_t rem = m & ((1u << shift) - 1), half = 1u << (shift - 1);
+    if (rem > half || (rem == half && (h & 1u))) ++h;
+    return static_cast<uint16_t>(sign | h);
+  }
+  uint32_t h = ((absx - 0x38000000u) >> 13);
+  const uint32_t rem = absx & 0x1fffu;
+  if (rem > 0x1000u || (rem == 0x1000u && (h & 1u))) ++h;
+  return static_cast<uint16_t>(sign | h);
+}
+
+inline float f16_to_f32(uint16_t h)
+{
+  const uint32_t sign = (h & 0x8000u) << 16;
+  uint32_t e = (h >> 10) & 0x1fu;
+  uint32_t m = h & 0x3ffu;
+  uint32_t x;
+  if (e == 0x1fu) {
+    x = sign | 0x7f800000u | (m << 13);
+  } else if (e == 0) {
+    if (m == 0) {
+      x = sign;
+    } else {
+      // normalize the subnormal
+      e = 113;
+      while (!(m & 0x400u)) { m <<= 1; --e; }
+      x = sign | (e << 23) | ((m & 0x3ffu) << 13);
+    }
+  } else {
+    x = sign | ((e + 112) << 23) | (m << 13);
+  }
+  float f;
+  std::memcpy(&f, &x, 4);
+  return f;
+}
+
+// KV cache write: x [T, H, Dh] f32 -> storage of `mode` (what the graph's cache-write ops produce)
+//   int8: scale[t, h] = max(|x[t, h, :]|) / 127, q = round(x / scale)
+inline void quantize_kv(
+    QnnKvCacheMode mode,
+    const float* x,
+    void* out,
+    float* scale,  // [T, H], int8 only
+    int T, int H, int Dh)
+{
+  const size_t n = (size_t)T * H * Dh;
+  if (mode == QnnKvCacheMode::kF32) {
+    std::memcpy(out, x, n * sizeof(float));
+  } else if (mode == QnnKvCacheMode::kF16) {
+    uint16_t* o = static_cast<uint16_t*>(out);
+    for (size_t i = 0; i < n; ++i) o[i] = f32_to_f16(x[i]);
+  } else if (mode == QnnKvCacheMode::kInt8) {
+    int8_t* o = static_cast<int8_t*>(out);
+    for (size_t th = 0; th < (size_t)T * H; ++th) {
+      const float* xs = x + th * Dh;
+      float m = 0.0f;
+      for (int d = 0; d < Dh; ++d) m = std::max(m, std::fabs(xs[d]));
+      const float s = std::max(m, 127.0f * kKvInt8MinScale) * (1.0f / 127.0f);
+      scale[th] = s;
+      for (int d = 0; d < Dh; ++d) {
+        const float r = std::round(xs[d] / s);  // ElementWiseRound: half away from zero
+        o[th * Dh + d] = static_cast<int8_t>(std::min(127.0f, std::max(-127.0f, r)));
+      }
+    }
+  }
+}
+
+// KV cache read: storage -> f32 [T, H, Dh] (what the graph's cache-read ops feed to attention)
+inline void dequantize_kv(
+    QnnKvCacheMode mode,
+    const void* in,
+    const float* scale,  // [T, H], int8 only
+    float* x,
+    int T, int H, int Dh)
+{
+  const size_t n = (size_t)T * H * Dh;
+  if (mode == QnnKvCacheMode::kF32) {
+    std::memcpy(x, in, n * sizeof(float));
+  } else if (mode == QnnKvCacheMode::kF16) {
+    const uint16_t* p = static_cast<const uint16_t*>(in);
+    for (size_t i = 0; i < n; ++i) x[i] = f16_to_f32(p[i]);
+  } else if (mode == QnnKvCacheMode::kInt8) {
+    const int8_t* p = static_cast<const int8_t*>(in);
+    for (size_t i = 0; i < n; ++i) x[i] = static_cast<float>(p[i]) * scale[i / Dh];
+  }
+}
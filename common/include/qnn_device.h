@@ -10,6 +10,7 @@
 #include "QnnInterface.h"
 #include "HTP/QnnHtpDevice.h"
 #include "qnn_platform.h"
+#include "qnn_perf.h"
 
 class QnnDeviceRuntime{
     public:
@@ -28,6 +29,12 @@ class QnnDeviceRuntime{
     Qnn_DeviceHandle_t Handle() const { return device_handle_;}
     bool IsValid() const {return device_handle_ != nullptr;}
 
+    // HTP perf vote, set up in AfterCreateDevice (call before Create).
+    // idle = profile when nobody holds a QnnHtpPerfScope
+    void EnablePerfVote(QnnHtpPowerProfile idle) { perf_enabled_ = true; perf_idle_ = idle; }
+    // nullptr if not enabled or the backend has no perf infrastructure
+    QnnHtpPerfRuntime* Perf() { return perf_.IsValid() ? &perf_ : nullptr; }
+
     protected:
     virtual bool MakeConfig(std::vector<const QnnDevice_Config_t*>& out_cfg);
     virtual bool AfterCreateDevice(); // something like perf vote
@@ -52,4 +59,8 @@ HtpArch ARCH = HtpArch::V73; // SM8550P
 
     std::vector<QnnDevice_Config_t> cfg_storage_;    
     std::vector<std::unique_ptr<QnnHtpDevice_CustomConfig_t>> htp_custom_cfg_;
+
+    bool perf_enabled_{false};
+    QnnHtpPowerProfile perf_idle_{QnnHtpPowerProfile::kBalanced};
+    QnnHtpPerfRuntime perf_;
 };
\ No newline at end of file
@@ -22,6 +22,11 @@ class QnnDynLoad{
                  const std::string& system_so,
                  const QnnSaver_Config_t** saver_config = nullptr);
 
+    // backend / system는 독립이라 다른 thread에서 동시에 불러도 됨 (startup 병렬화용)
+    bool LoadBackend(const std::string& backend_so,
+                     const QnnSaver_Config_t** saver_config = nullptr);
+    bool LoadSystem(const std::string& system_so);
+
     const QnnInterface_t* Backend() const { return qnn_backend_iface_;}
     const QnnSystemInterface_t* System() const { return qnn_system_iface_;}
 
@@ -43,7 +48,8 @@ class QnnDynLoad{
                       const QnnSaver_Config_t** saver_config);
     bool LoadSystem_(const std::string& so_path);
 
-    mutable std::mutex mu_;
+    std::mutex backend_mu_;
+    std::mutex system_mu_;
 
     void* backend_handle_{nullptr};
     void* system_handle_{nullptr};
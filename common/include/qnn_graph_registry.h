@@ -0,0 +1,65 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "QnnInterface.h"
+
+#include "qnn_graph.h"
+#include "qnn_multi_context.h"
+
+// Graph handles retrieved on first use.
+// bucket/shard binary가 많으면 graphRetrieve를 startup에 전부 하는 비용이 커서,
+// Get(name) 첫 호출 때 context activate + graphRetrieve를 하고 handle을 cache한다.
+// Prewarm(names)은 background thread에서 미리 retrieve (Get과 동시에 불려도 안전).
+class QnnGraphRegistry{
+    public:
+    QnnGraphRegistry() = default;
+    ~QnnGraphRegistry() { Destroy(); }
+
+    QnnGraphRegistry(const QnnGraphRegistry&) = delete;
+    QnnGraphRegistry& operator=(const QnnGraphRegistry&) = delete;
+
+    // contexts must be Prepare()d; every graph name of every binary is indexed (no QNN call)
+    bool Init(const QnnInterface_t* be,
+              QnnMultiContextRuntime* contexts,
+              Qnn_ProfileHandle_t profile_handle);
+
+    // retrieved graph, nullptr on unknown name or failure (a failure is not retried)
+    QnnGraphRuntime* Get(const std::string& name);
+
+    // binary index that holds name, -1 if unknown
+    int ContextIndex(const std::string& name) const;
+
+    // retrieve names on a background thread; WaitPrewarm() returns false if any failed
+    void Prewarm(const std::vector<std::string>& names);
+    bool WaitPrewarm();
+
+    size_t NumGraphs() const { return entries_.size(); }
+    size_t NumRetrieved() const;
+    void Dump() const;
+
+    void Destroy();
+
+    private:
+    struct Entry{
+        size_t ctx_idx{0};
+        mutable std::mutex mu;  // one retrieve per graph, others wait for it
+        std::unique_ptr<QnnGraphRuntime> graph;
+        bool failed{false};
+        uint64_t retrieve_us{0};
+    };
+
+    const QnnInterface_t* be_{nullptr};
+    QnnMultiContextRuntime* contexts_{nullptr};
+    Qnn_ProfileHandle_t profile_{nullptr};
+
+    // filled once in Init, read-only afterwards (entry contents are guarded by Entry::mu)
+    std::unordered_map<std::string, std::unique_ptr<Entry>> entries_;
+
+    std::future<bool> prewarm_;
+};
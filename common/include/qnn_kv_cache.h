@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "QnnTypes.h"
+
+// KV cache storage of one attention block (main_aot --kv-cache).
+// Graph IO, per block (layer prefix + name):
+//   prefill writes  k_cache, v_cache         [B, T, H, D/H]
+//   decode  reads   k_cache, v_cache         [B, P, H, D/H]  (P past tokens)
+//           writes  k_new,   v_new           [B, 1, H, D/H]
+//   int8 adds       <name>_scale             [B, T, H, 1] f32, one scale per (token, head)
+// prefill output k_cache and decode input k_cache have the same name/dtype/size when P == prefill L,
+// so qnn_runtime_runner aliases them onto one arena slice (Step29) and the cache never leaves the arena.
+enum class QnnKvCacheMode{
+    kOff,   // no cache IO (original graph)
+    kF32,   // 4 bytes / element
+    kF16,   // 2 bytes / element
+    kInt8,  // 1 byte / element + 4 bytes / (token, head)
+};
+
+inline bool KvCacheModeFromStr(const std::string& s, QnnKvCacheMode* out){
+    if (s == "off") *out = QnnKvCacheMode::kOff;
+    else if (s == "f32") *out = QnnKvCacheMode::kF32;
+    else if (s == "f16") *out = QnnKvCacheMode::kF16;
+    else if (s == "int8") *out = QnnKvCacheMode::kInt8;
+    else return false;
+    return true;
+}
+
+inline const char* KvCacheModeStr(QnnKvCacheMode m){
+    switch (m){
+        case QnnKvCacheMode::kOff:  return "off";
+        case QnnKvCacheMode::kF32:  return "f32";
+        case QnnKvCacheMode::kF16:  return "f16";
+        case QnnKvCacheMode::kInt8: return "int8";
+    }
+    return "off";
+}
+
+inline Qnn_DataType_t KvCacheDataType(QnnKvCacheMode m){
+    switch (m){
+        case QnnKvCacheMode::kF16:  return QNN_DATATYPE_FLOAT_16;
+        case QnnKvCacheMode::kInt8: return QNN_DATATYPE_INT_8;
+        default:                    return QNN_DATATYPE_FLOAT_32;
+    }
+}
+
+// inverse of KvCacheDataType for a cache tensor found in graph IO
+inline QnnKvCacheMode KvCacheModeOf(Qnn_DataType_t dt){
+    switch (dt){
+        case QNN_DATATYPE_FLOAT_32: return QnnKvCacheMode::kF32;
+        case QNN_DATATYPE_FLOAT_16: return QnnKvCacheMode::kF16;
+        case QNN_DATATYPE_INT_8:    return QnnKvCacheMode::kInt8;
+        default:                    return QnnKvCacheMode::kOff;
+    }
+}
+
+// bytes of K (or V) for `tokens` tokens, scales included
+inline size_t KvCacheBytes(QnnKvCacheMode m, size_t tokens, size_t heads, size_t head_dim){
+    const size_t elems = tokens * heads * head_dim;
+    switch (m){
+        case QnnKvCacheMode::kF32:  return elems * 4;
+        case QnnKvCacheMode::kF16:  return elems * 2;
+        case QnnKvCacheMode::kInt8: return elems + tokens * heads * sizeof(float);
+        default:                    return 0;
+    }
+}
+
+// scale = max(|x| over the head) / 127, never below this (all-zero head)
+constexpr float kKvInt8MinScale = 1e-8f;
@@ -0,0 +1,103 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+// HDR-style log-linear latency histogram (us).
+// 2^k 구간마다 32개 sub-bucket => 상대오차 ~3%, 범위는 uint64 전체.
+// Record()는 relaxed atomic 몇 개뿐이라 execute path에 항상 켜둬도 된다.
+class QnnLatencyHistogram{
+    public:
+    static constexpr uint32_t kSubBits = 5;
+    static constexpr uint32_t kSub = 1u << kSubBits;
+    static constexpr uint32_t kNumBuckets = (64 - kSubBits + 1) * kSub;
+
+    struct Snapshot{
+        uint64_t count{0};
+        uint64_t min{0};
+        uint64_t max{0};
+        double mean{0};
+        uint64_t p50{0};
+        uint64_t p90{0};
+        uint64_t p99{0};
+    };
+
+    QnnLatencyHistogram() { Reset(); }
+
+    QnnLatencyHistogram(const QnnLatencyHistogram&) = delete;
+    QnnLatencyHistogram& operator=(const QnnLatencyHistogram&) = delete;
+
+    void Record(uint64_t us);
+
+    // not atomic w.r.t. concurrent Record(); a sample may land on either side
+    Snapshot Snap() const;
+    void Reset();
+
+    static uint32_t BucketOf(uint64_t v);
+    static uint64_t BucketUpper(uint32_t idx);
+
+    private:
+    std::array<std::atomic<uint64_t>, kNumBuckets> buckets_;
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> min_{UINT64_MAX};
+    std::atomic<uint64_t> max_{0};
+};
+
+// per graph: host wall time of graphExecute + (optional) HTP_EXEC_ACCEL_US from Basic profiling
+struct QnnGraphLatency{
+    QnnLatencyHistogram wall_us;
+    QnnLatencyHistogram accel_us;
+};
+
+// process-wide registry. Get() takes a mutex only to find/insert the entry;
+// callers cache the returned reference (entries are never removed, address stable).
+class QnnLatencyRegistry{
+    public:
+    static QnnLatencyRegistry& Instance();
+
+    QnnGraphLatency& Get(const std::string& graph_name);
+
+    void Dump(std::ostream& os, bool reset = false);
+    void ResetAll();
+
+    // print every interval_ms to std::cout until StopPeriodicDump()
+    void StartPeriodicDump(uint32_t interval_ms, bool reset_after_dump = false);
+    void StopPeriodicDump();
+
+    ~QnnLatencyRegistry() { StopPeriodicDump(); }
+
+    private:
+    QnnLatencyRegistry() = default;
+    QnnLatencyRegistry(const QnnLatencyRegistry&) = delete;
+    QnnLatencyRegistry& operator=(const QnnLatencyRegistry&) = delete;
+
+    std::mutex mu_;
+    std::map<std::string, std::unique_ptr<QnnGraphLatency>> graphs_;
+
+    std::mutex dump_mu_;
+    std::condition_variable dump_cv_;
+    std::thread dump_thread_;
+    bool dump_stop_{false};
+};
+
+// host wall time of one scope -> hist (e.g. around graphExecute)
+class QnnLatencyTimer{
+    public:
+    explicit QnnLatencyTimer(QnnLatencyHistogram& hist);
+    ~QnnLatencyTimer();
+
+    QnnLatencyTimer(const QnnLatencyTimer&) = delete;
+    QnnLatencyTimer& operator=(const QnnLatencyTimer&) = delete;
+
+    private:
+    QnnLatencyHistogram& hist_;
+    uint64_t start_;
+};
@@ -2,8 +2,10 @@
 #include <cstdio>
 #include <cstdarg>
 #include <chrono>
+#include <string>
 #include "QnnLog.h"
 #include "QnnInterface.h"
+#include "qnn_async_log.h"
 
 static double now_ms() {
   using namespace std::chrono;
@@ -52,7 +54,57 @@ static bool CreateQnnLogger(const QnnInterface_t* be_iface,
 
   const Qnn_ErrorHandle_t err = api.logCreate(logStdoutCallback, max_level, out_log);
   if (err != QNN_SUCCESS || !*out_log) {
-    std::fprintf(stderr, "[QNN] logCreate failed, err=%d\n", QNN_GET_ERROR_CODE(err));
+    std::fprintf(stderr, "[QNN] logCreate failed, err=%lu\n", static_cast<unsigned long>(QNN_GET_ERROR_CODE(err)));
+    return false;
+  }
+  return true;
+}
+
+// logStdoutCallback 대신 QnnAsyncLogger로: backend thread는 ring에 format만 하고 바로 돌아간다.
+// path "-" => stdout (그래도 flush는 drain thread가 flush_ms마다 한 번)
+inline bool CreateQnnAsyncLogger(const QnnInterface_t* be_iface,
+                                 Qnn_LogHandle_t* out_log,
+                                 QnnLog_Level_t max_level,
+                                 const std::string& path,
+                                 uint32_t flush_ms = 50) {
+  if (!be_iface || !out_log) return false;
+  *out_log = nullptr;
+
+  auto& api = be_iface->QNN_INTERFACE_VER_NAME;
+  if (!api.logCreate) {
+    std::fprintf(stderr, "[QNN] logCreate not available in this interface\n");
+    return false;
+  }
+  if (!QnnAsyncLogger::Instance().Start(path, max_level, flush_ms)) return false;
+
+  const Qnn_ErrorHandle_t err = api.logCreate(QnnAsyncLogger::Callback, max_level, out_log);
+  if (err != QNN_SUCCESS || !*out_log) {
+    std::fprintf(stderr, "[QNN] logCreate failed, err=%lu\n", static_cast<unsigned long>(QNN_GET_ERROR_CODE(err)));
+    QnnAsyncLogger::Instance().Stop();
+    return false;
+  }
+  return true;
+}
+
+inline bool QnnLogLevelFromStr(const std::string& s, QnnLog_Level_t* out) {
+  if (s == "error") *out = QNN_LOG_LEVEL_ERROR;
+  else if (s == "warn") *out = QNN_LOG_LEVEL_WARN;
+  else if (s == "info") *out = QNN_LOG_LEVEL_INFO;
+  else if (s == "debug") *out = QNN_LOG_LEVEL_DEBUG;
+  else if (s == "verbose") *out = QNN_LOG_LEVEL_VERBOSE;
+  else return false;
+  return true;
+}
+
+// runtime level change: backend side (fewer lines generated) + async logger filter
+inline bool SetQnnLogLevel(const QnnInterface_t* be_iface, Qnn_LogHandle_t log, QnnLog_Level_t level) {
+  QnnAsyncLogger::Instance().SetLevel(level);
+  if (!be_iface || !log) return false;
+  auto& api = be_iface->QNN_INTERFACE_VER_NAME;
+  if (!api.logSetLogLevel) return false;
+  const Qnn_ErrorHandle_t err = api.logSetLogLevel(log, level);
+  if (err != QNN_SUCCESS) {
+    std::fprintf(stderr, "[QNN] logSetLogLevel failed, err=%lu\n", static_cast<unsigned long>(QNN_GET_ERROR_CODE(err)));
     return false;
   }
   return true;
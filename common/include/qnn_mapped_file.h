@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// read-only mmap of a context binary.
+// contextCreateFromBinary / systemContextGetBinaryInfo 에 그대로 넘길 수 있어서
+// 큰 binary를 ifstream으로 통째로 복사하지 않아도 된다.
+class QnnMappedFile{
+    public:
+    QnnMappedFile() = default;
+    ~QnnMappedFile() { Close(); }
+
+    QnnMappedFile(const QnnMappedFile&) = delete;
+    QnnMappedFile& operator=(const QnnMappedFile&) = delete;
+
+    // will_need: page-in 을 미리 요청 (prefetch 용)
+    bool Open(const std::string& path, bool will_need = false);
+    void Close();
+
+    bool IsValid() const { return addr_ != nullptr; }
+    uint8_t* Data() const { return static_cast<uint8_t*>(addr_); }
+    size_t Size() const { return size_; }
+    const std::string& Path() const { return path_; }
+
+    private:
+    std::string path_;
+    void* addr_{nullptr};
+    size_t size_{0};
+};
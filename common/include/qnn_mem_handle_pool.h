@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "QnnInterface.h"
+#include "QnnTypes.h"
+
+// (ctx, fd, offset, shape, dtype) of one shared-buffer registration
+struct QnnMemHandleKey{
+    Qnn_ContextHandle_t ctx{nullptr};
+    int32_t fd{-1};
+    uint64_t offset{0};
+    Qnn_DataType_t dtype{QNN_DATATYPE_UNDEFINED};
+    std::vector<uint32_t> dims;
+
+    bool operator==(const QnnMemHandleKey& o) const{
+        return ctx == o.ctx && fd == o.fd && offset == o.offset && dtype == o.dtype && dims == o.dims;
+    }
+};
+
+struct QnnMemHandleKeyHash{
+    size_t operator()(const QnnMemHandleKey& k) const;
+};
+
+// Process-wide, refcounted cache of memRegister handles.
+// session(QnnMemManagerRuntime)이 내려가도 handle은 idle로 남아서, 같은 buffer를 다시 쓰는
+// 다음 session은 memRegister 없이 가져간다 (SharedBuffer pool이 block과 fd를 살려두므로 흔한 경우).
+// idle handle은 Trim / max idle 초과 / DropFd (buffer 해제) / DropContext (contextFree 전)에서 memDeRegister.
+class QnnMemHandlePool{
+    public:
+    static QnnMemHandlePool& Instance();
+
+    static QnnMemHandleKey MakeKey(Qnn_ContextHandle_t ctx, int32_t fd, uint64_t offset, const Qnn_Tensor_t& t);
+
+    // refcount+1, nullptr on miss
+    Qnn_MemHandle_t Acquire(const QnnMemHandleKey& key);
+
+    // a fresh registration with refcount 1. If another session inserted the same key meanwhile,
+    // that handle is returned (refcount+1) and the caller must memDeRegister its own.
+    Qnn_MemHandle_t Insert(const QnnMemHandleKey& key, Qnn_MemHandle_t h, const QnnInterface_t* be);
+
+    // refcount-1; at 0 the handle stays registered (idle). false if h is not pooled
+    bool Release(Qnn_MemHandle_t h);
+
+    // memDeRegister idle handles (one batch), returns how many
+    size_t Trim();
+    // the buffer behind fd is going away (SharedBuffer hook)
+    void DropFd(int32_t fd);
+    // call before contextFree: every handle of ctx is deregistered
+    void DropContext(Qnn_ContextHandle_t ctx);
+
+    void SetMaxIdle(size_t n);
+
+    struct Stats{
+        size_t entries{0};
+        size_t idle{0};
+        uint64_t hits{0};
+        uint64_t inserts{0};
+        uint64_t deregistered{0};
+    };
+    Stats GetStats() const;
+
+    private:
+    QnnMemHandlePool();
+    QnnMemHandlePool(const QnnMemHandlePool&) = delete;
+    QnnMemHandlePool& operator=(const QnnMemHandlePool&) = delete;
+
+    struct Entry{
+        Qnn_MemHandle_t handle{nullptr};
+        const QnnInterface_t* be{nullptr};
+        uint32_t refs{0};
+        uint64_t idle_tick{0};  // for evicting the oldest idle entry
+    };
+    using Map = std::unordered_map<QnnMemHandleKey, Entry, QnnMemHandleKeyHash>;
+
+    // remove matching entries (idle_only => skip in-use ones), collect their handles
+    template <typename Pred>
+    void EraseLocked(Pred pred, bool idle_only, std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& out);
+    void EvictLocked(std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& out);
+    void DeRegister(const std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& handles);
+
+    mutable std::mutex mu_;
+    Map entries_;
+    // points at the key inside entries_ (node based => stable across rehash, unlike iterators)
+    std::unordered_map<Qnn_MemHandle_t, const QnnMemHandleKey*> by_handle_;
+    size_t idle_{0};
+    size_t max_idle_{1024};
+    uint64_t tick_{0};
+
+    uint64_t hits_{0};
+    uint64_t inserts_{0};
+    uint64_t deregistered_{0};
+};
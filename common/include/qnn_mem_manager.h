@@ -2,7 +2,11 @@
 #include <cstdint>
 #include <cstring>
 #include <iostream>
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "QnnTypes.h"
 #include "QnnInterface.h"
@@ -12,10 +16,30 @@
 #include "qnn_sharedbuffer.h"
 #include "qnn_tensor.h"
 #include "qnn_context.h"
+#include "qnn_mem_handle_pool.h"
 
 class QnnConextRuntime;
 class SharedBuffer;
 
+// named arena slices for cross-graph aliasing: graph A의 output과 graph B의 input을 같은 (fd, offset)에
+// bind하면 B는 A가 쓴 값을 그대로 읽는다 (copy 없음). arena 하나에 하나, context와는 무관.
+class QnnArenaAliasMap{
+    public:
+    // slice of `name`: allocated on the first call, later binds must fit in it
+    bool GetOrAlloc(SharedBuffer& sb, SharedBuffer::Arena& arena, const std::string& name,
+                    size_t bytes, size_t alignment, size_t* out_offset);
+    bool Find(const std::string& name, size_t* out_offset, size_t* out_bytes = nullptr) const;
+    size_t Size() const { return slices_.size(); }
+    void Clear() { slices_.clear(); }
+
+    private:
+    struct Slice{
+        size_t offset{0};
+        size_t bytes{0};
+    };
+    std::unordered_map<std::string, Slice> slices_;
+};
+
 class QnnMemManagerRuntime{
     public:
     QnnMemManagerRuntime() = default;
@@ -44,6 +68,14 @@ class QnnMemManagerRuntime{
 
     bool IsReigstered(Qnn_MemHandle_t handle, void* mem_ptr) const;
 
+    struct Stats{
+        size_t handles{0};  // registered through this manager (pooled included)
+        size_t pooled{0};   // of which held from QnnMemHandlePool
+        size_t bytes{0};    // tensor bytes behind those handles
+    };
+    Stats GetStats() const;
+
+    // handles from QnnMemHandlePool are released (stay registered, idle), the rest go in one memDeRegister
     void DeRegisterAll();
 
     // out_ptr : host에서 접근할 pointer
@@ -53,12 +85,52 @@ class QnnMemManagerRuntime{
         Qnn_Tensor_t& tensor_meta, size_t tensor_bytes,
         size_t alignment, void** out_ptr, Qnn_MemHandle_t* out_handle, size_t* out_offset = nullptr);
 
+    // register a tensor on an already-allocated arena slice (arena cursor untouched).
+    // same (fd, offset) in another context => alias of the same memory
+    bool RegisterTensorAtArenaOffset(
+        SharedBuffer::Arena& arena, Qnn_Tensor_t& tensor_meta,
+        size_t offset, void** out_ptr, Qnn_MemHandle_t* out_handle);
+
+    // batch version: hits come from this manager / QnnMemHandlePool, every miss goes in ONE memRegister.
+    // tensor 수가 많은 graph (KV cache 등)에서 per-tensor memRegister round trip을 없앤다.
+    bool RegisterTensorsAtArenaOffsets(
+        SharedBuffer::Arena& arena, const std::vector<Qnn_Tensor_t*>& tensors,
+        const std::vector<size_t>& offsets,
+        std::vector<void*>* out_ptrs, std::vector<Qnn_MemHandle_t>* out_handles);
+
+    // ArenaAlloc for each tensor (in order), then RegisterTensorsAtArenaOffsets
+    bool RegisterTensorsInSharedArena(
+        SharedBuffer& sb, SharedBuffer::Arena& arena,
+        const std::vector<Qnn_Tensor_t*>& tensors, const std::vector<size_t>& tensor_bytes,
+        size_t alignment, std::vector<void*>* out_ptrs, std::vector<Qnn_MemHandle_t>* out_handles,
+        std::vector<size_t>* out_offsets = nullptr);
+
+    // bind tensor_meta on the alias slice `alias` (allocated by the first binder).
+    // producer output과 consumer input이 같은 context면 sb_handle_by_key_ hit이라 no-op (같은 handle),
+    // 다른 context면 그 context에 한 번 memRegister (이후 session은 QnnMemHandlePool hit)
+    bool BindAlias(SharedBuffer& sb, SharedBuffer::Arena& arena, QnnArenaAliasMap& aliases,
+                   const std::string& alias, Qnn_Tensor_t& tensor_meta, size_t tensor_bytes,
+                   void** out_ptr, Qnn_MemHandle_t* out_handle);
+
+    // graph output setup before execute: outputs[i] goes on the alias slice *alias_of[i] if set
+    // (BindAlias), the rest in one RegisterTensorsInSharedArena. size = QnnTensor::MetaBytes.
+    // alias_of empty => no aliasing. out_ptrs / out_bytes: one per output, same order.
+    bool BindOutputsInSharedArena(SharedBuffer& sb, SharedBuffer::Arena& arena,
+                                  std::vector<Qnn_Tensor_t>& outputs, QnnArenaAliasMap* aliases,
+                                  const std::vector<const std::string*>& alias_of,
+                                  std::vector<void*>* out_ptrs, std::vector<size_t>* out_bytes);
+
     private:
+        // registered_ + telemetry counters
+        void Track(Qnn_MemHandle_t h, void* mem_ptr, size_t bytes);
+
         const QnnInterface_t* be_{nullptr};
         QnnContextRuntime* ctx_{nullptr};
 
     std::unordered_map<Qnn_MemHandle_t, void*> registered_;
+    size_t registered_bytes_{0};
     std::vector<std::unique_ptr<QnnMemHtp_Descriptor_t>> htp_desc_storage_;
-    std::unordered_map<uint64_t, Qnn_MemHandle_t> sb_handle_by_key_;
+    std::unordered_map<QnnMemHandleKey, Qnn_MemHandle_t, QnnMemHandleKeyHash> sb_handle_by_key_;
+    std::unordered_set<Qnn_MemHandle_t> pooled_;  // one QnnMemHandlePool ref each
 
 };
\ No newline at end of file
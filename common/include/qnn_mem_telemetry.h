@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// process-wide memory metrics: where does memory go?
+//   arenas     : capacity / used / high-water / alignment padding (SharedBuffer::Arena*)
+//   mem handles: registered handles + bytes (QnnMemManagerRuntime), QnnMemHandlePool
+//   rpcmem     : SharedBuffer::GetStats
+//   DSP heap   : "DSP:*" profile events at every context lifecycle point (create / free)
+//   host       : VmRSS / VmHWM
+// 갱신은 lifecycle 시점(arena create/alloc, register, context create/free)에만 일어나서 execute path에는 비용이 없다.
+class QnnMemTelemetry{
+    public:
+    static QnnMemTelemetry& Instance();
+
+    struct ArenaStats{
+        uintptr_t base{0};
+        size_t capacity{0};
+        size_t used{0};        // cursor after the last ArenaAlloc
+        size_t high_water{0};  // max cursor seen
+        uint64_t allocs{0};
+        size_t padding{0};     // alignment gaps between slices
+        // bytes lost to alignment, relative to what was handed out
+        double Fragmentation() const { return high_water ? double(padding) / double(high_water) : 0.0; }
+    };
+
+    struct DspHeapSample{
+        uint64_t ts_us{0};
+        std::string point;  // profile event identifier, e.g. DSP:before_context_created
+        uint64_t value{0};
+    };
+
+    struct Snapshot{
+        uint64_t ts_us{0};
+        std::vector<ArenaStats> arenas;
+        int64_t registered_handles{0};
+        int64_t registered_bytes{0};
+        std::vector<DspHeapSample> dsp_heap;
+        uint64_t rss_kb{0};
+        uint64_t peak_rss_kb{0};
+    };
+
+    // SharedBuffer arena hooks
+    void OnArenaCreate(const void* base, size_t capacity);
+    void OnArenaAlloc(const void* base, size_t cursor, size_t padding);
+    void OnArenaDestroy(const void* base);
+
+    // QnnMemManagerRuntime: +register / -deregister
+    void AddRegistered(int64_t handles, int64_t bytes){
+        registered_handles_.fetch_add(handles, std::memory_order_relaxed);
+        registered_bytes_.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    void RecordDspHeap(const std::string& point, uint64_t value);
+
+    Snapshot Snap() const;
+    // Snap + SharedBuffer / QnnMemHandlePool stats as one JSON object
+    void DumpJson(std::ostream& os) const;
+    // tmp file + rename, so a reader never sees half a dump
+    bool WriteJson(const std::string& path) const;
+
+    // WriteJson(path) every interval_ms until StopPeriodicDump()
+    void StartPeriodicDump(uint32_t interval_ms, const std::string& path);
+    void StopPeriodicDump();
+
+    static uint64_t RssKb();      // VmRSS
+    static uint64_t PeakRssKb();  // VmHWM
+
+    static constexpr size_t kMaxDspSamples = 256;
+
+    ~QnnMemTelemetry() { StopPeriodicDump(); }
+
+    private:
+    QnnMemTelemetry() = default;
+    QnnMemTelemetry(const QnnMemTelemetry&) = delete;
+    QnnMemTelemetry& operator=(const QnnMemTelemetry&) = delete;
+
+    mutable std::mutex mu_;
+    std::unordered_map<uintptr_t, ArenaStats> arenas_;
+    std::deque<DspHeapSample> dsp_heap_;  // oldest dropped past kMaxDspSamples
+
+    std::atomic<int64_t> registered_handles_{0};
+    std::atomic<int64_t> registered_bytes_{0};
+
+    std::mutex dump_mu_;
+    std::condition_variable dump_cv_;
+    std::thread dump_thread_;
+    bool dump_stop_{false};
+};
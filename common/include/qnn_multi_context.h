@@ -0,0 +1,83 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "QnnInterface.h"
+#include "System/QnnSystemInterface.h"
+
+#include "qnn_backendcache.h"
+#include "qnn_context.h"
+
+// Loads several context binaries into one backend/device.
+// Every binary is parsed first (HtpBackendCacheRuntime) so the max spill-fill
+// size is known before any context is created; then all contexts are created
+// with REGISTER_MULTI_CONTEXTS so they share a single spill-fill buffer.
+// Create() activates everything; Prepare() + Activate(i) creates contexts on demand
+// (QnnGraphRegistry does this on the first Get of a graph).
+class QnnMultiContextRuntime{
+    public:
+    QnnMultiContextRuntime() = default;
+    ~QnnMultiContextRuntime() { Destroy(); }
+
+    QnnMultiContextRuntime(const QnnMultiContextRuntime&) = delete;
+    QnnMultiContextRuntime& operator=(const QnnMultiContextRuntime&) = delete;
+
+    // read every file into host memory and parse its binary info
+    bool LoadBinaries(const QnnSystemInterface_t* sys_iface,
+                      const std::vector<std::string>& paths);
+
+    // LoadBinaries split in two, so file I/O can overlap dlopen(libQnnSystem.so)
+    bool ReadBinaries(const std::vector<std::string>& paths);
+    bool ParseBinaries(const QnnSystemInterface_t* sys_iface);
+
+    // contextCreateFromBinary for every loaded binary (one spill-fill group)
+    bool Create(const QnnInterface_t* be,
+                Qnn_BackendHandle_t backend_handle,
+                Qnn_DeviceHandle_t device_handle,
+                Qnn_ProfileHandle_t profile_handle);
+
+    // on-demand 버전: Prepare는 handle만 저장하고 context object를 만들어 둔다 (Context(i) 참조 가능).
+    // 실제 contextCreateFromBinary는 Activate(i)에서 (thread-safe, 두 번째부터 no-op)
+    bool Prepare(const QnnInterface_t* be,
+                 Qnn_BackendHandle_t backend_handle,
+                 Qnn_DeviceHandle_t device_handle,
+                 Qnn_ProfileHandle_t profile_handle);
+    bool Activate(size_t i);
+    bool IsActive(size_t i) const;
+
+    void Destroy();
+
+    size_t Size() const { return entries_.size(); }
+    uint64_t MaxSpillFillSize() const { return max_sf_buf_size_; }
+
+    QnnContextRuntime& Context(size_t i) { return *entries_[i].ctx; }
+    HtpBackendCacheRuntime& Cache(size_t i) { return *entries_[i].cache; }
+    const std::string& Path(size_t i) const { return entries_[i].path; }
+
+    // index of the binary that contains graph_name, -1 if none
+    int FindGraph(const std::string& graph_name) const;
+
+    private:
+    struct Entry{
+        std::string path;
+        std::vector<uint8_t> blob;
+        std::unique_ptr<HtpBackendCacheRuntime> cache;
+        std::unique_ptr<QnnContextRuntime> ctx;
+    };
+
+    static bool ReadFile(const std::string& path, std::vector<uint8_t>& out);
+
+    std::vector<Entry> entries_;
+    uint64_t max_sf_buf_size_{0};
+
+    const QnnInterface_t* be_{nullptr};
+    Qnn_BackendHandle_t backend_{nullptr};
+    Qnn_DeviceHandle_t device_{nullptr};
+    Qnn_ProfileHandle_t profile_{nullptr};
+
+    mutable std::mutex activate_mu_;
+    std::vector<size_t> active_order_;  // first one owns the spill-fill group
+};
@@ -0,0 +1,89 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "QnnInterface.h"
+#include "HTP/QnnHtpDevice.h"
+#include "HTP/QnnHtpPerfInfrastructure.h"
+
+// HTP power profile, ordered by priority (higher wins when several votes are active)
+enum class QnnHtpPowerProfile : uint8_t{
+    kPowerSaver = 0,
+    kBalanced = 1,
+    kSustained = 2,
+    kBurst = 3,
+};
+constexpr size_t kNumHtpPowerProfiles = 4;
+
+// HTP perf vote (DCVS v3 + RPC polling / control latency) through deviceGetInfrastructure.
+// vote가 없으면 token 사이에 HTP clock이 내려가서 per-token latency가 크게 흔들린다.
+// Acquire/Release는 refcount: 가장 높은 active profile이 적용되고, 아무것도 없으면 idle profile로 돌아간다.
+// 같은 profile로의 전환은 setPowerConfig를 다시 부르지 않는다.
+class QnnHtpPerfRuntime{
+    public:
+    struct RpcSetting{
+        uint32_t polling_us{0};          // 0 = no polling (FastRPC sleeps on interrupt)
+        // sent on every vote, so the burst value does not stay in effect after leaving burst
+        uint32_t control_latency_us{kDefaultControlLatencyUs};
+        static constexpr uint32_t kDefaultControlLatencyUs = 1000;  // relaxed, no low-latency QoS request
+    };
+
+    QnnHtpPerfRuntime();
+    ~QnnHtpPerfRuntime() { Destroy(); }
+
+    QnnHtpPerfRuntime(const QnnHtpPerfRuntime&) = delete;
+    QnnHtpPerfRuntime& operator=(const QnnHtpPerfRuntime&) = delete;
+
+    // createPowerConfigId + vote for idle
+    bool Create(const QnnInterface_t* be_iface, QnnHtpPowerProfile idle,
+                uint32_t device_id = 0, uint32_t core_id = 0);
+    void Destroy();
+    bool IsValid() const { return power_config_id_valid_; }
+
+    bool Acquire(QnnHtpPowerProfile p);
+    bool Release(QnnHtpPowerProfile p);
+    bool SetIdleProfile(QnnHtpPowerProfile p);
+
+    // per-profile RPC knobs, used from the next vote on
+    void SetRpc(QnnHtpPowerProfile p, const RpcSetting& rpc);
+
+    QnnHtpPowerProfile Current() const;
+    uint64_t NumVotes() const;  // setPowerConfig calls
+
+    static const char* ProfileToStr(QnnHtpPowerProfile p);
+    static bool ProfileFromStr(const std::string& s, QnnHtpPowerProfile* out);
+
+    private:
+    QnnHtpPowerProfile EffectiveLocked() const;
+    bool ApplyLocked(QnnHtpPowerProfile p);
+
+    mutable std::mutex mu_;
+    QnnHtpDevice_PerfInfrastructure_t perf_infra_{};
+    uint32_t power_config_id_{0};
+    bool power_config_id_valid_{false};
+
+    QnnHtpPowerProfile idle_{QnnHtpPowerProfile::kBalanced};
+    QnnHtpPowerProfile current_{QnnHtpPowerProfile::kBalanced};
+    bool applied_{false};
+    std::array<uint32_t, kNumHtpPowerProfiles> active_{};
+    std::array<RpcSetting, kNumHtpPowerProfiles> rpc_{};
+    uint64_t votes_{0};
+};
+
+// RAII vote, e.g. kBurst around a decode loop. perf == nullptr => no-op
+class QnnHtpPerfScope{
+    public:
+    QnnHtpPerfScope(QnnHtpPerfRuntime* perf, QnnHtpPowerProfile p)
+        : perf_(perf), p_(p) { if (perf_) perf_->Acquire(p_); }
+    ~QnnHtpPerfScope() { if (perf_) perf_->Release(p_); }
+
+    QnnHtpPerfScope(const QnnHtpPerfScope&) = delete;
+    QnnHtpPerfScope& operator=(const QnnHtpPerfScope&) = delete;
+
+    private:
+    QnnHtpPerfRuntime* perf_;
+    QnnHtpPowerProfile p_;
+};
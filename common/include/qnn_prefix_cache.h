@@ -0,0 +1,99 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+// rolling (chained) hash of a prompt prefix: key of chunk i covers chunk 0..i
+//   hash  : table key
+//   check : independent second hash, a hash hit with a different check is treated as a miss
+struct QnnPrefixKey{
+    uint64_t hash{0};
+    uint64_t check{0};
+    bool operator==(const QnnPrefixKey& o) const { return hash == o.hash && check == o.check; }
+};
+
+// Prompt prefix -> KV pages of earlier requests.
+//   - 프롬프트를 chunk_tokens 단위로 자르고, chunk마다 이전 chunk key에 이어서 hash (Extend)
+//   - chunk 하나 = page 하나 (SharedBuffer block, page_bytes). page 내용(그 chunk의 K/V rows 등)은 caller가 정한다
+//   - Lookup은 앞에서부터 맞는 chunk까지의 page를 pin해서 돌려준다 => 그 뒤(suffix)만 prefill 하면 됨
+//   - budget_bytes를 넘으면 pin 안 된 leaf(자식 chunk가 없는 entry)부터 LRU로 evict
+//     (parent를 먼저 지우면 자식은 다시는 match 안 되는데 메모리만 잡고 있게 됨)
+// thread-safe (mutex 하나, request 당 Lookup/Insert 몇 번이라 충분).
+class QnnPrefixCache{
+    public:
+    QnnPrefixCache() = default;
+    ~QnnPrefixCache() { Clear(); }
+    QnnPrefixCache(const QnnPrefixCache&) = delete;
+    QnnPrefixCache& operator=(const QnnPrefixCache&) = delete;
+
+    bool Init(size_t chunk_tokens, size_t page_bytes, size_t budget_bytes);
+    size_t ChunkTokens() const { return chunk_tokens_; }
+    size_t PageBytes() const { return page_bytes_; }
+
+    // root key for a prompt; seed = everything besides the tokens that changes the KV (e.g. other inputs)
+    static QnnPrefixKey Root(uint64_t seed = 0);
+    // key of the chunk that follows parent; call several times to cover several buffers of one chunk
+    static QnnPrefixKey Extend(const QnnPrefixKey& parent, const void* data, size_t bytes);
+
+    // chain[i] = key of chunk i. Returns how many leading chunks hit; their pages are pinned
+    // (pages->at(i) for chunk i) until Unpin
+    size_t Lookup(const std::vector<QnnPrefixKey>& chain, std::vector<const void*>* pages);
+
+    // new page for key (child of parent, parent == Root(...) for chunk 0), pinned, to be filled by the caller.
+    // nullptr if key is already cached or the budget cannot be met (everything else pinned)
+    void* Insert(const QnnPrefixKey& parent, const QnnPrefixKey& key);
+
+    // drops one pin taken by Lookup or Insert
+    void Unpin(const QnnPrefixKey& key);
+
+    // frees every unpinned page, returns how many
+    size_t Trim();
+    void Clear();
+
+    struct Stats{
+        size_t entries{0};
+        size_t bytes{0};         // pages held
+        size_t pinned{0};        // entries with refs > 0
+        uint64_t lookups{0};
+        uint64_t hit_chunks{0};
+        uint64_t miss_chunks{0};  // chunks after the first miss of a lookup
+        uint64_t inserts{0};
+        uint64_t evictions{0};
+        uint64_t insert_failures{0};
+    };
+    Stats GetStats() const;
+
+    private:
+    struct Entry{
+        uint64_t check{0};
+        uint64_t parent{0};     // parent hash, 0 = root
+        bool has_parent{false};
+        void* page{nullptr};
+        uint32_t refs{0};
+        uint32_t children{0};
+        std::list<uint64_t>::iterator lru;  // front = most recent
+    };
+
+    Entry* FindLocked(const QnnPrefixKey& key);
+    bool EvictOneLocked();  // oldest unpinned leaf
+    void EraseLocked(std::unordered_map<uint64_t, Entry>::iterator it);
+
+    size_t chunk_tokens_{0};
+    size_t page_bytes_{0};
+    size_t budget_bytes_{0};
+
+    mutable std::mutex mu_;
+    std::unordered_map<uint64_t, Entry> entries_;  // by hash
+    std::list<uint64_t> lru_;
+    size_t bytes_{0};
+
+    uint64_t lookups_{0};
+    uint64_t hit_chunks_{0};
+    uint64_t miss_chunks_{0};
+    uint64_t inserts_{0};
+    uint64_t evictions_{0};
+    uint64_t insert_failures_{0};
+};
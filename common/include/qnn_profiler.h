@@ -1,9 +1,15 @@
 #pragma once
 #include <array>
+#include <condition_variable>
 #include <cstdint>
+#include <deque>
 #include <iostream>
-#include <list>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "QnnInterface.h"
 #include "System/QnnSystemInterface.h"
@@ -11,6 +17,38 @@
 #include "QnnCommon.h"
 #include "System/QnnSystemProfile.h"
 
+class QnnTraceWriter;
+
+// profileGetEvents 결과를 system-profile event 형태로 복사한 tree.
+// serialization(systemProfileSerializeEventData)과 chrome trace export가 같이 쓴다.
+//
+// Clear()는 capacity를 유지하므로 같은 tree를 재사용하면 execute마다 재할당이 없다.
+// deep_copy: identifier / opaque payload 까지 tree 안으로 복사 (다른 thread로 넘길 때).
+// backend 쪽 포인터는 다음 execute 때 바뀔 수 있다.
+struct QnnProfileEventTree{
+    using Event = QnnSystemProfile_ProfileEventV1_t;
+
+    std::vector<Event> top;
+    // deque: push_back keeps element addresses, sub-event pointers stay valid
+    std::deque<std::vector<Event>> arena;
+    std::deque<std::string> strings;
+    std::deque<std::vector<uint8_t>> blobs;
+    size_t arena_used{0};
+    size_t strings_used{0};
+    size_t blobs_used{0};
+    bool deep_copy{false};
+
+    // header for serialization
+    std::string graph_name;
+    uint64_t start_us{0};
+    uint64_t stop_us{0};
+
+    std::vector<Event>& NextSubVector();
+    const char* CopyString(const char* s);
+    void* CopyBytes(const void* p, uint64_t len);
+    void Clear();
+};
+
 enum class QnnProfileLevel{
     Off = 0,
     Basic,
@@ -35,6 +73,12 @@ class QnnProfilerRuntime{
 
     bool SerializeAfterExecute(const char* graphName);
 
+    // serialization을 writer thread로 넘긴다. execute thread는 snapshot(deep copy)만 한다.
+    // queue가 차면 그 snapshot은 drop (execute latency 우선), drop 수는 종료 시 출력
+    bool EnableAsyncSerialization(size_t queue_capacity = 4);
+    // wait until every queued snapshot is written
+    void FlushSerialization();
+
     bool IsValid() const {return handle_ != nullptr;}
 
     Qnn_ProfileHandle_t GetProfiler(){
@@ -43,6 +87,18 @@ class QnnProfilerRuntime{
 
     bool DumpEventsRecursive(bool dump_sub_events, int max_depth);
 
+    // walk every event (+ sub events) once
+    bool ExtractEventTree(QnnProfileEventTree& out);
+
+    // same tree -> chrome trace. backend times are anchored at exec_start_us (QnnTraceWriter::NowUs clock)
+    bool AppendToTrace(QnnTraceWriter& trace, const std::string& graph_name, uint64_t exec_start_us);
+
+    // value of the last event of this type (e.g. HTP_EXEC_ACCEL_US, Basic level is enough)
+    bool FindEventValue(uint32_t event_type, uint64_t* out_value);
+
+    static const char* UnitToStr(uint32_t unit);
+    static const char* TypeToStr(uint32_t type);
+
     private:
     bool TryDumpOpaqueObjectToFile(const QnnProfile_ExtendedEventDataV1_t& v,
                                  const std::string& tag,
@@ -63,9 +119,27 @@ class QnnProfilerRuntime{
     bool CreateSerializationTarget();
     void FreeSerializationTarget();
     bool ExtractBackendProfilingInfo(QnnSystemProfile_ProfileData_t* profileData);
-    bool ExtractProfileingEvent(QnnProfile_EventId_t profileEventId, QnnSystemProfile_ProfileEventV1_t& out);
+    bool SerializeTree(QnnProfileEventTree& tree);
+    bool ExtractProfileingEvent(QnnProfile_EventId_t profileEventId, QnnSystemProfile_ProfileEventV1_t& out,
+                        QnnProfileEventTree& tree);
     bool ExtractProfilingSubEvents(QnnProfile_EventId_t profileEventId, QnnSystemProfile_ProfileEventV1_t& parent,
-                        std::list<std::vector<QnnSystemProfile_ProfileEventV1_t>>& arena);
+                        QnnProfileEventTree& tree);
+
+    // async serialization
+    void WriterLoop();
+    void StopWriter();
+    std::unique_ptr<QnnProfileEventTree> AcquireTree();
+
+    std::thread writer_;
+    std::mutex q_mu_;
+    std::condition_variable q_cv_;        // queue not empty / stop
+    std::condition_variable q_idle_cv_;   // queue drained
+    std::deque<std::unique_ptr<QnnProfileEventTree>> queue_;
+    std::vector<std::unique_ptr<QnnProfileEventTree>> pool_;
+    size_t queue_capacity_{0};
+    bool writer_busy_{false};
+    bool writer_stop_{false};
+    uint64_t dropped_{0};
 
     static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what){
         if(err != QNN_SUCCESS){
@@ -84,6 +158,4 @@ class QnnProfilerRuntime{
             default: return "";
         }
     }
-    static const char* UnitToStr(uint32_t unit);
-    static const char* TypeToStr(uint32_t type);
 };
\ No newline at end of file
@@ -0,0 +1,11 @@
+#pragma once
+
+// device runtime code (rpcmem, memRegister, contextCreateFromBinary, HTP context configs)
+// is compiled for aarch64 only; on x86 those calls are noops.
+// -DQNN_HOST_RUNTIME=ON (compile definition QNN_HOST_RUNTIME=1) turns them on for x86 too,
+// so the same paths can run against a stand-in backend (benchmarks, CI).
+#if defined(__aarch64__) || (defined(QNN_HOST_RUNTIME) && QNN_HOST_RUNTIME)
+#define QNN_RUNTIME_ENABLED 1
+#else
+#define QNN_RUNTIME_ENABLED 0
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+
+#include "QnnInterface.h"
+#include "System/QnnSystemInterface.h"
+
+#include "qnn_profiler.h"
+
+// profile level은 handle 생성 시 고정이라, handle을 두 종류 들고 있다가
+// graphExecute마다 어느 쪽을 넘길지 고른다.
+//   light    : Off(nullptr) or Basic. 평소 execute
+//   detailed : Detailed. graph마다 자기 execute N번째 마다 / RequestDetailed() 직후 한 번
+// call 수와 detailed handle은 graph별이다 (shard처럼 graph 여러 개가 번갈아 돌아도
+// 각 graph가 every_n 마다 sample되고, event가 다른 graph로 섞이지 않는다).
+// detailed로 돈 execute의 event tree는 per-op running stat에 누적된다.
+class QnnSamplingProfilerRuntime{
+    public:
+    struct OpStat{
+        uint64_t count{0};
+        uint64_t sum{0};
+        uint64_t min{UINT64_MAX};
+        uint64_t max{0};
+        uint32_t unit{0};
+    };
+
+    QnnSamplingProfilerRuntime() = default;
+
+    QnnSamplingProfilerRuntime(const QnnSamplingProfilerRuntime&) = delete;
+    QnnSamplingProfilerRuntime& operator=(const QnnSamplingProfilerRuntime&) = delete;
+
+    // every_n == 0 => only on RequestDetailed()
+    bool Create(const QnnInterface_t* be_iface, const QnnSystemInterface_t* sys_iface,
+                Qnn_BackendHandle_t backend_handle,
+                QnnProfileLevel light_level, uint32_t every_n);
+    void Destroy();
+
+    // handle to pass to the next graphExecute of graph_name
+    Qnn_ProfileHandle_t NextHandle(const std::string& graph_name);
+    // call after that graphExecute; aggregates if it was a detailed one
+    bool AfterExecute(const std::string& graph_name);
+
+    void RequestDetailed() { force_detailed_.store(true, std::memory_order_relaxed); }
+
+    uint64_t NumExecutes() const { return calls_; }
+    uint64_t NumSampled() const { return sampled_; }
+
+    void Dump(std::ostream& os) const;
+    void ResetStats();
+
+    private:
+    struct GraphState{
+        uint64_t calls{0};
+        // created on the first sampled execute of the graph
+        std::unique_ptr<QnnProfilerRuntime> detailed;
+        bool detailed_failed{false};
+        // events on a handle can accumulate across executes; only new top-level ones are aggregated
+        size_t seen_top{0};
+    };
+
+    void Accumulate(const std::string& graph_name,
+                    const QnnSystemProfile_ProfileEventV1_t* events, uint32_t n);
+
+    const QnnInterface_t* be_{nullptr};
+    const QnnSystemInterface_t* sys_{nullptr};
+    Qnn_BackendHandle_t backend_{nullptr};
+    QnnProfilerRuntime light_;
+    uint32_t every_n_{0};
+
+    std::atomic<bool> force_detailed_{false};
+    uint64_t calls_{0};
+    uint64_t sampled_{0};
+    GraphState* last_detailed_{nullptr};  // graph whose execute got a detailed handle
+    std::map<std::string, GraphState> graphs_;
+
+    mutable std::mutex mu_;
+    std::map<std::string, OpStat> stats_; // key: "graph/op"
+};
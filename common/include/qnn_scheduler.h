@@ -0,0 +1,123 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "qnn_latency.h"
+
+// one graph of the context binary the scheduler can launch; x input is [batch, tokens, C]
+struct QnnStepGraph{
+    std::string name;
+    uint32_t batch{1};   // sequences per execute
+    uint32_t tokens{1};  // tokens per sequence: 1 = decode graph, > 1 = prefill chunk graph
+};
+
+// tokens [pos, pos + n) of sequence id; rows[i] of a launch is batch row i of x
+struct QnnStepRow{
+    uint64_t id{0};
+    uint32_t pos{0};
+    uint32_t n{0};
+};
+
+struct QnnStepLaunch{
+    size_t graph{0};               // index into the graph list given to Init
+    bool decode{false};
+    std::vector<QnnStepRow> rows;  // <= batch, the remaining rows (and tokens past n) are padding
+};
+
+// everything executed in one step; launches are independent of each other
+struct QnnStepPlan{
+    std::vector<QnnStepLaunch> launches;
+    uint32_t decode_tokens{0};
+    uint32_t prefill_tokens{0};
+    uint32_t padded_tokens{0};  // executed but unused (batch rows / chunk tail)
+};
+
+// Continuous batching over fixed-shape graphs.
+//   - Submit()은 queue에 넣기만 한다 (thread-safe, serve loop 도중에도 가능)
+//   - Schedule()이 매 step 다음 batch를 만든다:
+//       1) 실행 중인 sequence의 decode token 전부 -> decode graph들에 batch bucket 단위로 packing
+//       2) 남은 token budget으로 prefill chunk: 진행 중인 prompt 먼저, 그 다음 queue에서 admit (max_running까지)
+//          sequence 하나는 step 당 chunk 하나 (chunk 순서대로 KV가 쌓이니까)
+//   - Complete()가 결과를 반영: 마지막 prefill chunk => 첫 token (TTFT), decode => token 하나,
+//     max_new_tokens에 닿은 sequence는 그 자리에서 evict (slot이 바로 다음 step의 admit에 쓰임)
+// graph를 고르는 규칙: padding이 가장 적은 bucket (batch/tokens가 남은 양 이상인 것 중 가장 작은 것,
+// 없으면 가장 큰 것으로 여러 번).
+class QnnBatchScheduler{
+    public:
+    struct Options{
+        uint32_t max_running{8};        // sequences admitted at once (KV slots)
+        uint32_t max_step_tokens{256};  // executed tokens per step, padding included; decode always fits
+    };
+
+    QnnBatchScheduler() = default;
+    QnnBatchScheduler(const QnnBatchScheduler&) = delete;
+    QnnBatchScheduler& operator=(const QnnBatchScheduler&) = delete;
+
+    // needs at least one decode (tokens == 1) and one prefill (tokens > 1) graph
+    bool Init(const std::vector<QnnStepGraph>& graphs, const Options& opt);
+    const QnnStepGraph& Graph(size_t i) const { return graphs_[i]; }
+    size_t NumGraphs() const { return graphs_.size(); }
+
+    // returns the request id (> 0), 0 if the request is empty
+    uint64_t Submit(uint32_t prompt_tokens, uint32_t max_new_tokens);
+
+    // next step, false if nothing is queued or running
+    bool Schedule(QnnStepPlan* plan);
+    // the plan returned by the last Schedule() has executed
+    void Complete(const QnnStepPlan& plan);
+
+    bool Idle() const;
+
+    struct Stats{
+        uint64_t submitted{0};
+        uint64_t finished{0};
+        size_t queued{0};
+        size_t running{0};
+        uint64_t steps{0};
+        uint64_t launches{0};
+        uint64_t decode_tokens{0};
+        uint64_t prefill_tokens{0};
+        uint64_t padded_tokens{0};
+        uint64_t max_batch{0};  // most sequences in one step
+        QnnLatencyHistogram::Snapshot ttft_us;  // submit -> first token
+        QnnLatencyHistogram::Snapshot e2e_us;   // submit -> last token
+    };
+    Stats GetStats() const;
+
+    private:
+    struct Seq{
+        uint64_t id{0};
+        uint32_t prompt{0};
+        uint32_t max_new{0};
+        uint32_t prefilled{0};
+        uint32_t generated{0};
+        uint64_t submit_us{0};
+    };
+
+    Seq* FindRunning(uint64_t id);
+    // smallest graph of the kind with size(g) >= need, else the largest; SIZE_MAX if there is none
+    size_t PickGraph(bool decode, uint32_t need) const;
+
+    std::vector<QnnStepGraph> graphs_;
+    Options opt_;
+
+    mutable std::mutex mu_;
+    uint64_t next_id_{1};
+    std::deque<Seq> queue_;
+    std::vector<Seq> running_;  // admission order
+
+    uint64_t submitted_{0};
+    uint64_t finished_{0};
+    uint64_t steps_{0};
+    uint64_t launches_{0};
+    uint64_t decode_tokens_{0};
+    uint64_t prefill_tokens_{0};
+    uint64_t padded_tokens_{0};
+    uint64_t max_batch_{0};
+    QnnLatencyHistogram ttft_;
+    QnnLatencyHistogram e2e_;
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "QnnInterface.h"
+#include "System/QnnSystemInterface.h"
+
+#include "qnn_backendcache.h"
+#include "qnn_context.h"
+#include "qnn_graph.h"
+#include "qnn_mapped_file.h"
+#include "qnn_mem_manager.h"
+#include "qnn_sampling_profiler.h"
+#include "qnn_sharedbuffer.h"
+
+// A model split into K context binaries (shard_0.bin ... shard_{K-1}.bin),
+// each holding one graph: hidden_in -> [layers] -> hidden_out.
+//
+// hidden state는 arena 안의 slice 두 개를 ping-pong 으로 쓴다.
+//   shard i : reads slice[i % 2], writes slice[(i + 1) % 2]
+// 각 shard context가 같은 (fd, offset)에 memRegister 하므로 복사 없이 alias 된다.
+//
+// shard i가 execute 되는 동안 shard i+1 을 std::async 로 load
+// (mmap + binary info parse + contextCreateFromBinary + memRegister).
+class QnnShardedModelRuntime{
+    public:
+    struct Options{
+        bool prefetch{true};       // load shard i+1 while shard i executes
+        bool keep_resident{false}; // false => free shard i right after it runs
+    };
+
+    QnnShardedModelRuntime() = default;
+    ~QnnShardedModelRuntime() { Destroy(); }
+
+    QnnShardedModelRuntime(const QnnShardedModelRuntime&) = delete;
+    QnnShardedModelRuntime& operator=(const QnnShardedModelRuntime&) = delete;
+
+    // loads shard 0 and carves the two hidden slices out of arena
+    bool Init(const QnnInterface_t* be,
+              const QnnSystemInterface_t* sys_iface,
+              Qnn_BackendHandle_t backend_handle,
+              Qnn_DeviceHandle_t device_handle,
+              Qnn_ProfileHandle_t profile_handle,
+              const std::vector<std::string>& paths,
+              SharedBuffer& sb, SharedBuffer::Arena& arena,
+              const Options& opt);
+
+    // run every shard in order. input: Input(), result: Output()
+    bool Run();
+
+    void Destroy();
+
+    // per-execute profile handle from sampler (overrides profile_handle given to Init)
+    void SetSampler(QnnSamplingProfilerRuntime* sampler) { sampler_ = sampler; }
+
+    size_t NumShards() const { return shards_.size(); }
+    size_t HiddenBytes() const { return hidden_bytes_; }
+    void* Input() const { return SlicePtr(0); }
+    void* Output() const { return SlicePtr(shards_.size() % 2); }
+
+    private:
+    struct Shard{
+        std::string path;
+        std::unique_ptr<QnnMappedFile> file;
+        std::unique_ptr<HtpBackendCacheRuntime> cache;
+        std::unique_ptr<QnnContextRuntime> ctx;
+        std::unique_ptr<QnnGraphRuntime> graph;
+        std::unique_ptr<QnnMemManagerRuntime> mem;
+        QnnGraphBinding io;
+        bool loaded{false};
+    };
+
+    bool Load(size_t i);
+    void Unload(size_t i);
+    bool Execute(size_t i);
+    void* SlicePtr(size_t slot) const;
+
+    const QnnInterface_t* be_{nullptr};
+    const QnnSystemInterface_t* sys_{nullptr};
+    Qnn_BackendHandle_t backend_{nullptr};
+    Qnn_DeviceHandle_t device_{nullptr};
+    Qnn_ProfileHandle_t profile_{nullptr};
+    Options opt_{};
+    QnnSamplingProfilerRuntime* sampler_{nullptr};
+
+    std::vector<Shard> shards_;
+    std::future<bool> pending_;   // shard being prefetched
+    size_t pending_idx_{0};
+
+    SharedBuffer* sb_{nullptr};
+    SharedBuffer::Arena* arena_{nullptr};
+    size_t hidden_bytes_{0};
+    size_t slice_off_[2]{0, 0};
+};
@@ -1,14 +1,25 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <cstdint>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 using RpcMemAllocFn_t = void* (*)(int, uint32_t, int);
 using RpcMemFreeFn_t = void(*)(void*);
 using RpcMemToFdFn_t = int (*)(void*);
+// called right before a block whose fd is known goes back to rpcmem_free (e.g. drop mem handles on it)
+using SharedBufferFdReleaseHook_t = void (*)(int32_t fd);
 
+// rpcmem wrapper, process-wide singleton. Thread-safe:
+//   Instance()   : lock-free once loaded (mutex only while Load() has not succeeded)
+//   alloc table  : kNumShards shards (ptr hash), one mutex each
+//   thread cache : small per-thread list of freed blocks, reused by exact size
+//   size classes : 4KiB .. 64MiB (4 steps per power of two); freed blocks (and their fds) go
+//                  to a process-wide pool up to a high-water cap. Larger blocks bypass the pool.
+// 여러 inference session이 한 process에서 동시에 alloc/free 해도 된다. Arena 자체는 caller 소유라 session마다 따로.
 class SharedBuffer{
     public:
     SharedBuffer(const SharedBuffer&) = delete;
@@ -21,8 +32,41 @@ class SharedBuffer{
     int32_t MemToFd(void* buf);
     void FreeMem(void* buf);
     bool IsAllocated(void* buf) const;
+    // usable bytes from buf (>= requested bytes), 0 if buf is not from AllocMem
     size_t GetAllocatedSize(void* buf) const;
 
+    struct Stats{
+        uint64_t allocs{0};             // AllocMem calls that succeeded
+        uint64_t frees{0};
+        uint64_t rpcmem_allocs{0};      // driver calls
+        uint64_t rpcmem_frees{0};
+        uint64_t thread_cache_hits{0};
+        uint64_t pool_hits{0};
+        uint64_t pooled_bytes{0};       // cached in the pool right now (thread caches not included)
+        uint64_t live{0};               // outstanding AllocMem blocks
+    };
+    Stats GetStats() const;
+
+    // high-water cap of the pool; a free beyond it goes straight to rpcmem_free
+    void SetPoolLimit(size_t max_pooled_bytes);
+    size_t PoolLimit() const { return pool_limit_.load(std::memory_order_relaxed); }
+    // give cached blocks back to rpcmem (every thread cache, then the pool down to keep_bytes).
+    // returns released bytes. e.g. after a session is torn down, or on memory pressure
+    size_t Trim(size_t keep_bytes = 0);
+
+    // one hook per process (QnnMemHandlePool), nullptr to clear
+    void SetFdReleaseHook(SharedBufferFdReleaseHook_t hook){ fd_release_hook_.store(hook, std::memory_order_release); }
+
+    // blocks up to this size are kept in the per-thread cache on FreeMem
+    static constexpr size_t kThreadCacheMaxBytes = 1 << 20;
+    static constexpr size_t kThreadCacheSlots = 8;
+    static constexpr size_t kDefaultPoolLimit = size_t(64) << 20;
+
+    // size class helpers (public for the microbench)
+    static constexpr int kNumSizeClasses = 1 + (26 - 12) * 4;
+    static int SizeClassOf(size_t bytes);     // -1 => too large, not pooled
+    static size_t SizeClassBytes(int cls);
+
     struct Arena{
         void* base{nullptr};   // AllocMem이 반환한 aligned base ptr
         int fd{-1};            // base로부터 얻은 fd
@@ -46,16 +90,56 @@ class SharedBuffer{
     bool Load();
     void Unload();
 
+    // one rpcmem block: raw pointer from rpcmem_alloc + its size
+    struct Block{
+        void* raw{nullptr};
+        size_t bytes{0};
+        int32_t fd{-1};  // rpcmem_to_fd, filled on first MemToFd and kept while cached
+        int cls{-1};     // size class, -1 => exact size (not pooled)
+    };
+    struct ThreadCache;
+    ThreadCache& LocalCache();
+    void ReleaseBlock(const Block& b);  // rpcmem_free
+    size_t DrainThreadCaches();
+    bool PoolPut(const Block& b);
+    bool PoolGet(int cls, Block* out);
+
+    struct alignas(64) PoolClass{
+        std::mutex mu;
+        std::vector<Block> blocks;
+    };
+
+    static constexpr size_t kNumShards = 16;
+    struct alignas(64) Shard{
+        mutable std::mutex mu;
+        std::unordered_map<void*, Block> blocks;  // aligned ptr -> block
+    };
+    Shard& ShardOf(const void* aligned) const;
+
     static std::mutex init_mutex_;
     std::atomic_bool initialized_{false};
 
-    void* lib_cdsp_rpc_;
+    void* lib_cdsp_rpc_{nullptr};
     RpcMemAllocFn_t rpc_mem_alloc_{nullptr};
     RpcMemFreeFn_t rpc_mem_free_{nullptr};
     RpcMemToFdFn_t rpc_mem_to_fd_{nullptr};
 
-    std::unordered_map<void*, void*> restore_map_;
-    std::unordered_map<void*, size_t> allocated_size_map_;
+    mutable std::array<Shard, kNumShards> shards_;
+    std::array<PoolClass, kNumSizeClasses> pool_;
+    std::atomic<size_t> pooled_bytes_{0};
+    std::atomic<size_t> pool_limit_{kDefaultPoolLimit};
+    std::atomic<SharedBufferFdReleaseHook_t> fd_release_hook_{nullptr};
+
+    // every live thread cache, so Unload() can give their blocks back
+    std::mutex caches_mu_;
+    std::vector<ThreadCache*> caches_;
+
+    std::atomic<uint64_t> stat_allocs_{0};
+    std::atomic<uint64_t> stat_frees_{0};
+    std::atomic<uint64_t> stat_rpcmem_allocs_{0};
+    std::atomic<uint64_t> stat_rpcmem_frees_{0};
+    std::atomic<uint64_t> stat_thread_cache_hits_{0};
+    std::atomic<uint64_t> stat_pool_hits_{0};
 
     // TODO
     // std::unordered_map<void*, void*> tensor_addr_to_custom_mem_;
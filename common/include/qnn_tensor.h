@@ -51,6 +51,8 @@ class QnnTensor{
 
     static uint32_t DataTypeSize(Qnn_DataType_t dt);
     static uint32_t CalcBytes(Qnn_DataType_t dt, const std::vector<uint32_t>& dims);
+    // bytes of a tensor meta (e.g. binary info, clientBuf.dataSize is 0 there): dims x dtype size
+    static size_t MetaBytes(const Qnn_Tensor_t& t);
     bool SetName(const std::string& new_name);
 
     private:
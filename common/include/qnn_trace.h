@@ -0,0 +1,102 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "System/QnnSystemProfile.h"
+
+// In-process Chrome trace (chrome://tracing, ui.perfetto.dev) writer.
+// host span(register/execute/post-process)과 QNN profile event tree를 같은 timeline에 올린다.
+// qnn-profile-viewer / schematic 없이 trace.json 하나로 op timeline 확인 가능.
+//
+// tid 구분
+//   kHostTid    : host side spans
+//   kBackendTid : graph execute totals (EXECUTE > HOST_RPC > HTP_RPC > ACCEL, nested)
+//   kOpTid      : node(op) events, laid out back-to-back from execute start
+class QnnTraceWriter{
+    public:
+    static constexpr int kHostTid = 1;
+    static constexpr int kBackendTid = 2;
+    static constexpr int kOpTid = 3;
+
+    QnnTraceWriter() = default;
+
+    QnnTraceWriter(const QnnTraceWriter&) = delete;
+    QnnTraceWriter& operator=(const QnnTraceWriter&) = delete;
+
+    // steady clock, us. every timestamp handed to the writer must use this clock
+    static uint64_t NowUs();
+
+    void AddSpan(const std::string& name, const std::string& cat,
+                 uint64_t ts_us, uint64_t dur_us, int tid = kHostTid,
+                 const std::string& args_json = "");
+    void AddCounter(const std::string& name, uint64_t ts_us, double value);
+    void AddInstant(const std::string& name, const std::string& cat,
+                    uint64_t ts_us, int tid, const std::string& args_json = "");
+
+    // walk the tree QnnProfilerRuntime::ExtractEventTree builds
+    void AddProfileEvents(const std::string& graph_name,
+                          const QnnSystemProfile_ProfileEventV1_t* events,
+                          uint32_t num_events,
+                          uint64_t exec_start_us);
+
+    // extra tracks (e.g. parallel init workers). tid 1-3 are named already
+    void SetThreadName(int tid, const std::string& name);
+
+    // spans of one category, ordered by start (e.g. "init" => startup stage table)
+    void DumpSpans(std::ostream& os, const std::string& cat) const;
+
+    bool WriteJson(const std::string& path) const;
+    void Clear();
+    size_t Size() const;
+
+    private:
+    struct Event{
+        std::string name;
+        std::string cat;
+        char ph{'X'};      // X: complete span, C: counter, i: instant
+        uint64_t ts{0};
+        uint64_t dur{0};
+        int tid{kHostTid};
+        double value{0};   // counter only
+        std::string args;  // pre-rendered json object body (without braces)
+    };
+
+    void WalkLocked(const std::string& graph_name,
+                    const QnnSystemProfile_ProfileEventV1_t* events,
+                    uint32_t num_events,
+                    uint64_t start_us,
+                    double cycles_per_us);
+    static std::string Escape(const std::string& s);
+
+    mutable std::mutex mu_;
+    std::vector<Event> events_;
+    std::map<int, std::string> thread_names_;
+};
+
+// RAII host span. trace == nullptr => no-op
+class QnnTraceScope{
+    public:
+    QnnTraceScope(QnnTraceWriter* trace, std::string name, std::string cat = "host",
+                  int tid = QnnTraceWriter::kHostTid)
+        : trace_(trace), name_(std::move(name)), cat_(std::move(cat)), tid_(tid),
+          start_(trace ? QnnTraceWriter::NowUs() : 0) {}
+    ~QnnTraceScope(){
+        if (trace_) trace_->AddSpan(name_, cat_, start_, QnnTraceWriter::NowUs() - start_, tid_);
+    }
+
+    QnnTraceScope(const QnnTraceScope&) = delete;
+    QnnTraceScope& operator=(const QnnTraceScope&) = delete;
+
+    uint64_t StartUs() const { return start_; }
+
+    private:
+    QnnTraceWriter* trace_;
+    std::string name_;
+    std::string cat_;
+    int tid_;
+    uint64_t start_;
+};
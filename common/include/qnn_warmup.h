@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "QnnInterface.h"
+#include "QnnTypes.h"
+
+#include "qnn_profiler.h"
+#include "qnn_sharedbuffer.h"
+
+// Session start warm-up.
+// contextCreateFromBinary 직후 첫 graphExecute는 HTP power-up, VTCM acquire,
+// shared buffer first-touch page fault 비용을 같이 낸다. 그걸 첫 user request 전에 미리 낸다.
+//   PrefaultArena : arena의 모든 page를 한 번씩 touch (내용은 그대로)
+//   WarmGraph     : zero input / scratch output(RAW)으로 graphExecute 한 번
+//   Report        : warm-up(cold) execute vs 첫 실제 request latency
+class QnnWarmupRuntime{
+    public:
+    // returns number of pages touched
+    static size_t PrefaultArena(const SharedBuffer::Arena& a);
+
+    // inputs/outputs are graph IO metadata (e.g. HtpBackendCacheRuntime::GraphInputs); they are copied
+    bool WarmGraph(const QnnInterface_t* be,
+                   Qnn_GraphHandle_t graph,
+                   const std::string& graph_name,
+                   const std::vector<Qnn_Tensor_t>& inputs,
+                   const std::vector<Qnn_Tensor_t>& outputs);
+
+    // 0 if graph_name was not warmed up
+    uint64_t ColdUs(const std::string& graph_name) const;
+
+    // profiler (optional, must have profiled the first request) adds HTP_POWERUP_US / HTP_VTCM_ACQUIRE_US
+    void Report(const std::string& graph_name, uint64_t first_request_us,
+                QnnProfilerRuntime* profiler = nullptr) const;
+
+    private:
+    std::map<std::string, uint64_t> cold_us_;
+};
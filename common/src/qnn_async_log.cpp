@@ -0,0 +1,220 @@
+#include "qnn_async_log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <unordered_map>
+
+static double NowMs(){
+    using namespace std::chrono;
+    static const auto t0 = steady_clock::now();
+    return duration<double, std::milli>(steady_clock::now() - t0).count();
+}
+
+static const char* LevelStr(uint8_t level){
+    switch (level){
+        case QNN_LOG_LEVEL_ERROR:   return "ERROR";
+        case QNN_LOG_LEVEL_WARN:    return "WARN";
+        case QNN_LOG_LEVEL_INFO:    return "INFO";
+        case QNN_LOG_LEVEL_DEBUG:   return "DEBUG";
+        case QNN_LOG_LEVEL_VERBOSE: return "VERBOSE";
+        default:                    return "UNKNOWN";
+    }
+}
+
+// single producer (the owning thread) / single consumer (drain, under drain_mu_)
+struct QnnAsyncLogger::Ring{
+    alignas(64) std::atomic<uint64_t> head{0};  // next slot to write, producer
+    alignas(64) std::atomic<uint64_t> tail{0};  // next slot to read, consumer
+    std::unique_ptr<Slot[]> slots{new Slot[kRingSlots]};
+    uint32_t tid{0};
+
+    // producer only: per call site rate limit window
+    struct Rate{
+        uint64_t window{0};  // second since start
+        uint32_t count{0};
+        uint32_t suppressed{0};
+    };
+    std::unordered_map<const char*, Rate> rates;
+};
+
+QnnAsyncLogger& QnnAsyncLogger::Instance(){
+    static QnnAsyncLogger* logger = []{
+        auto* l = new QnnAsyncLogger();
+        std::atexit([]{ QnnAsyncLogger::Instance().Stop(); });
+        return l;
+    }();
+    return *logger;
+}
+
+QnnAsyncLogger::Ring& QnnAsyncLogger::LocalRing(){
+    thread_local Ring* ring = nullptr;
+    if (!ring){
+        auto r = std::make_unique<Ring>();
+        std::lock_guard<std::mutex> lk(rings_mu_);
+        r->tid = static_cast<uint32_t>(rings_.size());
+        ring = r.get();
+        rings_.push_back(std::move(r));
+    }
+    return *ring;
+}
+
+bool QnnAsyncLogger::Push(Ring& r, QnnLog_Level_t level, const char* fmt, va_list argp){
+    const uint64_t h = r.head.load(std::memory_order_relaxed);
+    const uint64_t used = h - r.tail.load(std::memory_order_acquire);
+    if (used >= kRingSlots){
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        cv_.notify_one();
+        return false;
+    }
+    Slot& s = r.slots[h & (kRingSlots - 1)];
+    s.ms = NowMs();
+    s.level = static_cast<uint8_t>(level);
+    const int n = std::vsnprintf(s.text, kSlotText, fmt, argp);
+    s.len = n < 0 ? 0u : static_cast<uint32_t>(std::min<size_t>(static_cast<size_t>(n), kSlotText - 1));
+    r.head.store(h + 1, std::memory_order_release);
+
+    // half full: wake the drain thread now instead of at the next interval (once per crossing)
+    if (used + 1 == kRingSlots / 2) cv_.notify_one();
+    return true;
+}
+
+void QnnAsyncLogger::PushLine(Ring& r, QnnLog_Level_t level, const char* fmt, ...){
+    va_list ap;
+    va_start(ap, fmt);
+    (void)Push(r, level, fmt, ap);
+    va_end(ap);
+}
+
+void QnnAsyncLogger::Log(QnnLog_Level_t level, const char* fmt, va_list argp){
+    if (static_cast<int>(level) > level_.load(std::memory_order_relaxed)) return;
+    if (!running_.load(std::memory_order_acquire)){
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ring& r = LocalRing();
+
+    const uint32_t limit = rate_limit_.load(std::memory_order_relaxed);
+    if (limit){
+        const uint64_t sec = static_cast<uint64_t>(NowMs()) / 1000;
+        Ring::Rate& rt = r.rates[fmt];
+        if (rt.window != sec){
+            if (rt.suppressed){
+                PushLine(r, level, "[suppressed %u lines like: %.200s]", rt.suppressed, fmt);
+            }
+            rt.window = sec;
+            rt.count = 0;
+            rt.suppressed = 0;
+        }
+        if (++rt.count > limit){
+            ++rt.suppressed;
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+    (void)Push(r, level, fmt, argp);
+}
+
+void QnnAsyncLogger::Callback(const char* fmt, QnnLog_Level_t level, uint64_t timestamp, va_list argp){
+    (void)timestamp;  // backend-specific unit; host ms is stamped instead (same as logStdoutCallback)
+    Instance().Log(level, fmt, argp);
+}
+
+size_t QnnAsyncLogger::DrainLocked(){
+    if (!out_) return 0;
+    std::vector<Ring*> rings;
+    {
+        std::lock_guard<std::mutex> lk(rings_mu_);
+        rings.reserve(rings_.size());
+        for (auto& r : rings_) rings.push_back(r.get());
+    }
+    size_t n = 0;
+    for (Ring* r : rings){
+        const uint64_t t = r->tail.load(std::memory_order_relaxed);
+        const uint64_t h = r->head.load(std::memory_order_acquire);
+        for (uint64_t i = t; i < h; ++i){
+            const Slot& s = r->slots[i & (kRingSlots - 1)];
+            std::fprintf(out_, "%8.1fms [%-7s] [t%u] %.*s\n", s.ms, LevelStr(s.level), r->tid,
+                         static_cast<int>(s.len), s.text);
+        }
+        r->tail.store(h, std::memory_order_release);
+        n += static_cast<size_t>(h - t);
+    }
+    if (n){
+        std::fflush(out_);
+        written_.fetch_add(n, std::memory_order_relaxed);
+    }
+    return n;
+}
+
+bool QnnAsyncLogger::Start(const std::string& path, QnnLog_Level_t level, uint32_t flush_interval_ms){
+    Stop();
+    {
+        std::lock_guard<std::mutex> lk(drain_mu_);
+        if (path == "-"){
+            out_ = stdout;
+            owns_out_ = false;
+        } else {
+            out_ = std::fopen(path.c_str(), "w");
+            owns_out_ = true;
+            if (!out_){
+                std::cerr << "[QNN] AsyncLogger: failed to open " << path << "\n";
+                return false;
+            }
+        }
+    }
+    SetLevel(level);
+    {
+        std::lock_guard<std::mutex> lk(thread_mu_);
+        stop_ = false;
+        flush_interval_ms_ = flush_interval_ms ? flush_interval_ms : 1;
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this]{
+        std::unique_lock<std::mutex> lk(thread_mu_);
+        while (!stop_){
+            cv_.wait_for(lk, std::chrono::milliseconds(flush_interval_ms_));
+            lk.unlock();
+            {
+                std::lock_guard<std::mutex> dlk(drain_mu_);
+                DrainLocked();
+            }
+            lk.lock();
+        }
+    });
+    return true;
+}
+
+void QnnAsyncLogger::Stop(){
+    if (!running_.exchange(false, std::memory_order_acq_rel)) return;
+    {
+        std::lock_guard<std::mutex> lk(thread_mu_);
+        stop_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    std::lock_guard<std::mutex> lk(drain_mu_);
+    DrainLocked();
+    if (out_){
+        std::fprintf(out_, "[QNN] async log: written=%llu dropped=%llu suppressed=%llu\n",
+                     static_cast<unsigned long long>(written_.load()),
+                     static_cast<unsigned long long>(dropped_.load()),
+                     static_cast<unsigned long long>(suppressed_.load()));
+        std::fflush(out_);
+        if (owns_out_) std::fclose(out_);
+    }
+    out_ = nullptr;
+    owns_out_ = false;
+}
+
+QnnAsyncLogger::Stats QnnAsyncLogger::GetStats() const{
+    Stats st;
+    st.written = written_.load(std::memory_order_relaxed);
+    st.dropped = dropped_.load(std::memory_order_relaxed);
+    st.suppressed = suppressed_.load(std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lk(rings_mu_);
+    st.threads = rings_.size();
+    return st;
+}
@@ -4,6 +4,7 @@
 #include <iostream>
 
 #include "QnnCommon.h"  // QNN_GET_ERROR_CODE
+#include "qnn_tensor.h"  // QNN_TENSOR_VER_PTR
 #include "HTP/QnnHtpSystemContext.h"  // HTP spill/fill parsing용 (없으면 제거)
 
 static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what) {
@@ -14,6 +15,34 @@ static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what) {
   return true;
 }
 
+static const std::vector<Qnn_Tensor_t> kNoTensors;
+
+Qnn_Tensor_t QnnGraphIoStorage::Own(const Qnn_Tensor_t& src) {
+  Qnn_Tensor_t t = src;
+  auto* tv = QNN_TENSOR_VER_PTR(t);
+
+  names_.emplace_back(tv->name ? tv->name : "");
+  tv->name = names_.back().c_str();
+
+  dims_.emplace_back(tv->dimensions, tv->dimensions + (tv->dimensions ? tv->rank : 0));
+  tv->dimensions = dims_.back().empty() ? nullptr : dims_.back().data();
+
+  if (t.version == QNN_TENSOR_VERSION_2 && tv->isDynamicDimensions) {
+    dynamic_dims_.emplace_back(tv->isDynamicDimensions, tv->isDynamicDimensions + tv->rank);
+    tv->isDynamicDimensions = dynamic_dims_.back().data();
+  }
+
+  // per-axis scale 배열도 parsed memory를 가리킴 (block-wise encoding은 안 씀)
+  auto& q = tv->quantizeParams;
+  if (q.quantizationEncoding == QNN_QUANTIZATION_ENCODING_AXIS_SCALE_OFFSET &&
+      q.axisScaleOffsetEncoding.scaleOffset) {
+    const auto& a = q.axisScaleOffsetEncoding;
+    scale_offsets_.emplace_back(a.scaleOffset, a.scaleOffset + a.numScaleOffsets);
+    q.axisScaleOffsetEncoding.scaleOffset = scale_offsets_.back().data();
+  }
+  return t;
+}
+
 QnnBackendCacheRuntime::~QnnBackendCacheRuntime() {
   Destroy();
 }
@@ -51,24 +80,45 @@ void QnnBackendCacheRuntime::Destroy() {
 
   state_ = INVALID;
   graph_names_.clear();
-  input_tensor_structs_.clear();
-  output_tensor_structs_.clear();
+  // bindings handed out keep their own reference
+  graph_io_.clear();
+}
+
+const std::vector<Qnn_Tensor_t>& QnnBackendCacheRuntime::GraphInputs(
+    const std::string& graph_name) const {
+  if (state_ != DESERIALIZE) return kNoTensors;
+  auto it = graph_io_.find(graph_name);
+  if (it == graph_io_.end()) return kNoTensors;
+  return it->second->inputs;
+}
+
+const std::vector<Qnn_Tensor_t>& QnnBackendCacheRuntime::GraphOutputs(
+    const std::string& graph_name) const {
+  if (state_ != DESERIALIZE) return kNoTensors;
+  auto it = graph_io_.find(graph_name);
+  if (it == graph_io_.end()) return kNoTensors;
+  return it->second->outputs;
+}
+
+QnnGraphBinding QnnBackendCacheRuntime::MakeBinding(const std::string& graph_name) const {
+  QnnGraphBinding b;
+  if (state_ != DESERIALIZE) return b;
+  auto it = graph_io_.find(graph_name);
+  if (it == graph_io_.end()) return b;
+  b.meta = it->second;
+  b.inputs = it->second->inputs;
+  b.outputs = it->second->outputs;
+  return b;
 }
 
 std::vector<Qnn_Tensor_t> QnnBackendCacheRuntime::GetGraphInputs(
     const std::string& graph_name) const {
-  if (state_ != DESERIALIZE) return {};
-  auto it = input_tensor_structs_.find(graph_name);
-  if (it == input_tensor_structs_.end()) return {};
-  return it->second;
+  return GraphInputs(graph_name);
 }
 
 std::vector<Qnn_Tensor_t> QnnBackendCacheRuntime::GetGraphOutputs(
     const std::string& graph_name) const {
-  if (state_ != DESERIALIZE) return {};
-  auto it = output_tensor_structs_.find(graph_name);
-  if (it == output_tensor_structs_.end()) return {};
-  return it->second;
+  return GraphOutputs(graph_name);
 }
 
 bool QnnBackendCacheRuntime::RetrieveBackendBinaryInfo(
@@ -82,21 +132,23 @@ void QnnBackendCacheRuntime::RetrieveGraphInfo(const INFO& info) {
   // graph name
   graph_names_.push_back(info.graphName);
 
+  auto io = std::make_shared<QnnGraphIoStorage>();
+
   // inputs
   uint32_t numGraphInputs = info.numGraphInputs;
-  auto& in_vec = input_tensor_structs_[graph_names_.back()];
-  in_vec.reserve(numGraphInputs);
+  io->inputs.reserve(numGraphInputs);
   for (uint32_t i = 0; i < numGraphInputs; ++i) {
-    in_vec.emplace_back(info.graphInputs[i]);
+    io->inputs.push_back(io->Own(info.graphInputs[i]));
   }
 
   // outputs
   uint32_t numGraphOutputs = info.numGraphOutputs;
-  auto& out_vec = output_tensor_structs_[graph_names_.back()];
-  out_vec.reserve(numGraphOutputs);
+  io->outputs.reserve(numGraphOutputs);
   for (uint32_t i = 0; i < numGraphOutputs; ++i) {
-    out_vec.emplace_back(info.graphOutputs[i]);
+    io->outputs.push_back(io->Own(info.graphOutputs[i]));
   }
+
+  graph_io_[graph_names_.back()] = std::move(io);
 }
 
 bool QnnBackendCacheRuntime::GetQnnGraphInfoFromBinary(void* buffer, uint32_t nbytes) {
@@ -162,8 +214,7 @@ bool QnnBackendCacheRuntime::Configure() {
   // DESERIALIZE only
   state_ = INVALID;
   graph_names_.clear();
-  input_tensor_structs_.clear();
-  output_tensor_structs_.clear();
+  graph_io_.clear();
 
   if (!blob_.buffer || blob_.nbytes == 0) {
     std::cerr << "[QNN] Configure: context blob is null/empty\n";
@@ -1,4 +1,7 @@
 #include "qnn_context.h"
+#include "qnn_mem_handle_pool.h"
+#include "qnn_mem_telemetry.h"
+#include "qnn_runtime_gate.h"
 #include "HTP/QnnHtpContext.h"
 #include "QnnCommon.h"
 #include "QnnContext.h"
@@ -6,6 +9,9 @@
 #include "QnnTypes.h"
 #include "QnnProfile.h"
 
+#include <mutex>
+#include <unordered_set>
+
 static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what) {
   if (err != QNN_SUCCESS) {
     std::cerr << "[QNN] " << what << " failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
@@ -14,6 +20,29 @@ static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what) {
   return true;
 }
 
+// "DSP:*" events (DSP_MEMORY_PROFILING_ENABLED): DSP heap usage at context create / free.
+// the profile handle keeps older events, so each event id is recorded once
+static void RecordDspHeapEvents(const QnnInterface_t* be, Qnn_ProfileHandle_t profile){
+  if (!be || !profile) return;
+  static std::mutex seen_mu;
+  static std::unordered_set<QnnProfile_EventId_t> seen;
+
+  const QnnProfile_EventId_t* events = nullptr;
+  uint32_t numEvents = 0;
+  if (be->QNN_INTERFACE_VER_NAME.profileGetEvents(profile, &events, &numEvents) != QNN_SUCCESS) return;
+  for(uint32_t i=0; i < numEvents; ++i){
+    QnnProfile_EventData_t eventData;
+    if (be->QNN_INTERFACE_VER_NAME.profileGetEventData(events[i], &eventData) != QNN_SUCCESS) continue;
+    if (!eventData.identifier || strncmp(eventData.identifier, "DSP:", 4) != 0) continue;
+    {
+      std::lock_guard<std::mutex> lk(seen_mu);
+      if (!seen.insert(events[i]).second) continue;
+    }
+    std::cout << "[QNN] DspHeap " << eventData.identifier << " : " << eventData.value << std::endl;
+    QnnMemTelemetry::Instance().RecordDspHeap(eventData.identifier, eventData.value);
+  }
+}
+
 // ---- 내부: context config 구성 ----
 // Device 코드랑 동일한 패턴: cfg_storage_ + htp_custom_cfg_ 보관 후
 // out_cfg에는 const QnnContext_Config_t* 포인터 배열을 넘김(마지막 nullptr)
@@ -31,7 +60,7 @@ bool QnnContextRuntime::MakeConfig(std::vector<const QnnContext_Config_t*>& out_
 
   std::vector<QnnContext_CustomConfig_t> custom_cfgs;
 
-#if defined(__aarch64__)
+#if QNN_RUNTIME_ENABLED
   QnnHtpContext_CustomConfig_t* p;
   if (use_multi_contexts_ && max_sf_buf_size_ != 0){
     p = alloc_htp_custom();
@@ -69,7 +98,7 @@ bool QnnContextRuntime::MakeConfig(std::vector<const QnnContext_Config_t*>& out_
 }
 
 bool QnnContextRuntime::AfterCreate(){
-#if defined (__aarch64__)
+#if QNN_RUNTIME_ENABLED
   if (sf_handle_ == 0x0 && ctx_ != nullptr){
     sf_handle_ = ctx_;
   }
@@ -140,19 +169,11 @@ bool QnnContextRuntime::CreateFromBinary(const QnnInterface_t* be,
   }
 
   const QnnContext_Config_t** cfg_ptr = cfg.empty() ? nullptr : cfg.data();
-#if defined (__aarch64__)
+#if QNN_RUNTIME_ENABLED
   Qnn_ErrorHandle_t err = api.contextCreateFromBinary(backend_handle, device_handle, cfg_ptr, ctx_bin, ctx_bin_bytes, &ctx_, /*profile=*/profileHandle);
   
-  const QnnProfile_EventId_t* events;
-  uint32_t numEvents;
-  be_->QNN_INTERFACE_VER_NAME.profileGetEvents(profileHandle, &events, &numEvents);
-  for(uint32_t i=0; i < numEvents; ++i){
-    QnnProfile_EventData_t eventData;
-    be_->QNN_INTERFACE_VER_NAME.profileGetEventData(events[i], &eventData);
-    if (strcmp(eventData.identifier, "DSP:before_context_created") == 0){
-      std::cout << "total DspHeap Usage Before Context Created : " << eventData.value << std::endl;
-    }
-  }
+  // shards can be loaded without a profiler
+  RecordDspHeapEvents(be_, profileHandle);
   if(!CheckQnnOk(err, "contextCreateFromBinary")) return false;
 #else
   std::cerr << "[QNN] CreateFromBinary is intended for aarch64 runtime only\n";
@@ -195,23 +216,18 @@ void QnnContextRuntime::Destroy() {
 
   auto& api = be_->QNN_INTERFACE_VER_NAME;
 
+  // pooled mem handles of this context must go before the context itself
+  QnnMemHandlePool::Instance().DropContext(ctx_);
+
   // ExecuTorch가 쓰는 형태: contextFree(handle, profile=nullptr)
   // 네 SDK가 인자를 2개 요구하면 이게 맞고,
   // 1개만 요구하면 두 번째 인자를 지우면 됨.
   (void)CheckQnnOk(api.contextFree(ctx_, /*profile=*/profiler_), "contextFree");
 
-  if(profiler_){
-    const QnnProfile_EventId_t* events;
-    uint32_t numEvents;
-    be_->QNN_INTERFACE_VER_NAME.profileGetEvents(profiler_, &events, &numEvents);
-    for(uint32_t i=0; i < numEvents; ++i){
-      QnnProfile_EventData_t eventData;
-      be_->QNN_INTERFACE_VER_NAME.profileGetEventData(events[i], &eventData);
-      if (strcmp(eventData.identifier, "DSP:after_context_freed") == 0){
-        std::cout << "total DspHeap Usage After Context Created : " << eventData.value << std::endl;
-      }
-    }
-  }
+  RecordDspHeapEvents(be_, profiler_);
+
+  // group owner is gone; next multi-context group starts fresh
+  if (sf_handle_ == ctx_) sf_handle_ = nullptr;
 
   ctx_ = nullptr;
   profiler_ = nullptr;
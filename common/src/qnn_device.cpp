@@ -100,8 +100,16 @@ bool QnnDeviceRuntime::MakeConfig(std::vector<const QnnDevice_Config_t*>& out_cf
 }
 
 bool QnnDeviceRuntime::AfterCreateDevice(){
-    // TODO - HTP perf vote / rpc polling / platform info
+    // TODO - platform info
     // see HtpDevice.cpp & HtpDevicePlatformInfoConfig.h
+    if (!perf_enabled_) return true;
+
+    // no vote is a performance problem, not a correctness one => keep the device
+    if (!perf_.Create(be_, perf_idle_)){
+        std::cerr << "[QNN] Device: perf vote unavailable, running without it\n";
+        return true;
+    }
+    std::cout << "[QNN] Device: perf vote idle=" << QnnHtpPerfRuntime::ProfileToStr(perf_idle_) << "\n";
     return true;
 }
 
@@ -146,6 +154,8 @@ bool QnnDeviceRuntime::Create(const QnnInterface_t* be_iface, Qnn_LogHandle_t lo
 void QnnDeviceRuntime::Destroy() {
   if (!be_ || !device_handle_) return;
 
+  perf_.Destroy();
+
   auto& api = be_->QNN_INTERFACE_VER_NAME;
   (void)CheckQnnOk(api.deviceFree(device_handle_), "deviceFree");
   device_handle_ = nullptr;
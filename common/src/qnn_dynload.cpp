@@ -1,4 +1,5 @@
 #include "qnn_dynload.h"
+#include <cstdlib>
 #include <dlfcn.h>
 #include <iostream>
 
@@ -16,6 +17,12 @@ static void* OpenSo(const std::string& p, int flags){
     return h; 
 }
 
+// QNN_BACKEND_LIB / QNN_SYSTEM_LIB override the .so names (e.g. libQnnNull.so on host)
+static std::string EnvOr(const char* name, const std::string& def){
+    const char* v = std::getenv(name);
+    return (v && *v) ? std::string(v) : def;
+}
+
 template<typename Fn>
 static Fn LoadSym(void* handle, const char* name){
     // dlsym returns void*, need to cast
@@ -25,21 +32,26 @@ static Fn LoadSym(void* handle, const char* name){
 bool QnnDynLoad::LoadAll(const std::string& backend_so,
                              const std::string& system_so,
                              const QnnSaver_Config_t** saver_config) {
-    std::lock_guard<std::mutex> lock(mu_);
-
-    if (qnn_backend_iface_ && qnn_system_iface_) {
-        // Already loaded
-        return true;
-    }
-    if (!LoadBackend_(backend_so, saver_config)) {
+    if (!LoadBackend(backend_so, saver_config)) {
         return false;
     }
-    if (!LoadSystem_(system_so)) {
+    if (!LoadSystem(system_so)) {
         return false;
     }
     return true;
 }
 
+bool QnnDynLoad::LoadBackend(const std::string& backend_so,
+                             const QnnSaver_Config_t** saver_config) {
+    std::lock_guard<std::mutex> lock(backend_mu_);
+    return LoadBackend_(EnvOr("QNN_BACKEND_LIB", backend_so), saver_config);
+}
+
+bool QnnDynLoad::LoadSystem(const std::string& system_so) {
+    std::lock_guard<std::mutex> lock(system_mu_);
+    return LoadSystem_(EnvOr("QNN_SYSTEM_LIB", system_so));
+}
+
 bool QnnDynLoad::LoadBackend_(const std::string& so_path,
                                    const QnnSaver_Config_t** saver_config) {
     if(qnn_backend_iface_){
@@ -122,7 +134,8 @@ bool QnnDynLoad::LoadSystem_(const std::string& so_path) {
 }
 
 bool QnnDynLoad::UnloadAll() {
-    std::lock_guard<std::mutex> lock(mu_);
+    std::lock_guard<std::mutex> backend_lock(backend_mu_);
+    std::lock_guard<std::mutex> system_lock(system_mu_);
 
     bool success = true;
 
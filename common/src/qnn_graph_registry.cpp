@@ -0,0 +1,112 @@
+#include "qnn_graph_registry.h"
+
+#include <chrono>
+#include <iostream>
+
+bool QnnGraphRegistry::Init(const QnnInterface_t* be,
+                            QnnMultiContextRuntime* contexts,
+                            Qnn_ProfileHandle_t profile_handle){
+    if (!be || !contexts || contexts->Size() == 0){
+        std::cerr << "[QNN] GraphRegistry Init: invalid be/contexts\n";
+        return false;
+    }
+    Destroy();
+    be_ = be;
+    contexts_ = contexts;
+    profile_ = profile_handle;
+
+    for (size_t i = 0; i < contexts_->Size(); ++i){
+        for (const auto& name : contexts_->Cache(i).GraphNames()){
+            if (entries_.count(name)){
+                std::cerr << "[QNN] GraphRegistry: duplicate graph " << name
+                          << " in " << contexts_->Path(i) << ", keeping first\n";
+                continue;
+            }
+            auto e = std::make_unique<Entry>();
+            e->ctx_idx = i;
+            entries_.emplace(name, std::move(e));
+        }
+    }
+    std::cout << "[QNN] GraphRegistry: " << entries_.size() << " graphs in "
+              << contexts_->Size() << " binaries\n";
+    return true;
+}
+
+QnnGraphRuntime* QnnGraphRegistry::Get(const std::string& name){
+    auto it = entries_.find(name);
+    if (it == entries_.end()){
+        std::cerr << "[QNN] GraphRegistry: unknown graph " << name << "\n";
+        return nullptr;
+    }
+    Entry& e = *it->second;
+
+    std::lock_guard<std::mutex> lk(e.mu);
+    if (e.graph) return e.graph.get();
+    if (e.failed) return nullptr;
+
+    const auto t0 = std::chrono::steady_clock::now();
+    if (!contexts_->Activate(e.ctx_idx)){
+        e.failed = true;
+        return nullptr;
+    }
+    auto g = std::make_unique<QnnGraphRuntime>();
+    g->SetRestoreMode(true);
+    if (!g->Create(be_, contexts_->Context(e.ctx_idx).Handle(), profile_, name)){
+        std::cerr << "[QNN] GraphRegistry: graphRetrieve failed for " << name << "\n";
+        e.failed = true;
+        return nullptr;
+    }
+    e.retrieve_us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+    e.graph = std::move(g);
+    return e.graph.get();
+}
+
+int QnnGraphRegistry::ContextIndex(const std::string& name) const{
+    auto it = entries_.find(name);
+    return it == entries_.end() ? -1 : static_cast<int>(it->second->ctx_idx);
+}
+
+void QnnGraphRegistry::Prewarm(const std::vector<std::string>& names){
+    WaitPrewarm();
+    prewarm_ = std::async(std::launch::async, [this, names]{
+        bool ok = true;
+        for (const auto& n : names) ok = (Get(n) != nullptr) && ok;
+        return ok;
+    });
+}
+
+bool QnnGraphRegistry::WaitPrewarm(){
+    if (!prewarm_.valid()) return true;
+    return prewarm_.get();
+}
+
+size_t QnnGraphRegistry::NumRetrieved() const{
+    size_t n = 0;
+    for (const auto& kv : entries_){
+        std::lock_guard<std::mutex> lk(kv.second->mu);
+        if (kv.second->graph) ++n;
+    }
+    return n;
+}
+
+void QnnGraphRegistry::Dump() const{
+    std::cout << "[QNN] GraphRegistry: retrieved " << NumRetrieved() << "/" << entries_.size() << "\n";
+    for (const auto& kv : entries_){
+        std::lock_guard<std::mutex> lk(kv.second->mu);
+        const Entry& e = *kv.second;
+        std::cout << "  " << kv.first << " ctx=" << e.ctx_idx
+                  << (e.graph ? " retrieved" : (e.failed ? " failed" : " lazy"));
+        if (e.graph) std::cout << " retrieve_us=" << e.retrieve_us;
+        std::cout << "\n";
+    }
+}
+
+void QnnGraphRegistry::Destroy(){
+    // background retrieve touches contexts_, finish it before anything goes away
+    WaitPrewarm();
+    entries_.clear();
+    contexts_ = nullptr;
+    be_ = nullptr;
+    profile_ = nullptr;
+}
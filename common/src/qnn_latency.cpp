@@ -0,0 +1,147 @@
+#include "qnn_latency.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+static inline uint64_t SteadyNowUs(){
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint32_t QnnLatencyHistogram::BucketOf(uint64_t v){
+    // [0, 2*kSub) : exact
+    if (v < 2 * kSub) return static_cast<uint32_t>(v);
+    const uint32_t msb = 63u - static_cast<uint32_t>(__builtin_clzll(v));
+    const uint32_t shift = msb - kSubBits;
+    return shift * kSub + static_cast<uint32_t>(v >> shift);
+}
+
+uint64_t QnnLatencyHistogram::BucketUpper(uint32_t idx){
+    if (idx < 2 * kSub) return idx;
+    const uint32_t shift = idx / kSub - 1;
+    const uint64_t mant = idx - shift * kSub;
+    return (mant << shift) + ((uint64_t(1) << shift) - 1);
+}
+
+void QnnLatencyHistogram::Record(uint64_t us){
+    buckets_[BucketOf(us)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+    sum_.fetch_add(us, std::memory_order_relaxed);
+
+    uint64_t cur = min_.load(std::memory_order_relaxed);
+    while (us < cur && !min_.compare_exchange_weak(cur, us, std::memory_order_relaxed)) {}
+    cur = max_.load(std::memory_order_relaxed);
+    while (us > cur && !max_.compare_exchange_weak(cur, us, std::memory_order_relaxed)) {}
+}
+
+QnnLatencyHistogram::Snapshot QnnLatencyHistogram::Snap() const{
+    Snapshot s;
+    // count from the buckets themselves so percentiles stay consistent
+    uint64_t total = 0;
+    for (const auto& b : buckets_) total += b.load(std::memory_order_relaxed);
+    if (total == 0) return s;
+
+    s.count = total;
+    s.min = min_.load(std::memory_order_relaxed);
+    s.max = max_.load(std::memory_order_relaxed);
+    s.mean = double(sum_.load(std::memory_order_relaxed)) / double(count_.load(std::memory_order_relaxed) ? count_.load(std::memory_order_relaxed) : 1);
+
+    const uint64_t r50 = (total * 50 + 99) / 100;
+    const uint64_t r90 = (total * 90 + 99) / 100;
+    const uint64_t r99 = (total * 99 + 99) / 100;
+    uint64_t acc = 0;
+    for (uint32_t i = 0; i < kNumBuckets; ++i){
+        const uint64_t n = buckets_[i].load(std::memory_order_relaxed);
+        if (n == 0) continue;
+        const uint64_t prev = acc;
+        acc += n;
+        const uint64_t upper = std::min(BucketUpper(i), s.max);
+        if (prev < r50 && acc >= r50) s.p50 = upper;
+        if (prev < r90 && acc >= r90) s.p90 = upper;
+        if (prev < r99 && acc >= r99){ s.p99 = upper; break; }
+    }
+    return s;
+}
+
+void QnnLatencyHistogram::Reset(){
+    for (auto& b : buckets_) b.store(0, std::memory_order_relaxed);
+    count_.store(0, std::memory_order_relaxed);
+    sum_.store(0, std::memory_order_relaxed);
+    min_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+QnnLatencyRegistry& QnnLatencyRegistry::Instance(){
+    static QnnLatencyRegistry reg;
+    return reg;
+}
+
+QnnGraphLatency& QnnLatencyRegistry::Get(const std::string& graph_name){
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& slot = graphs_[graph_name];
+    if (!slot) slot = std::make_unique<QnnGraphLatency>();
+    return *slot;
+}
+
+static void PrintOne(std::ostream& os, const char* tag, const QnnLatencyHistogram::Snapshot& s){
+    os << " " << tag << " n=" << s.count;
+    if (s.count == 0) return;
+    os << " p50=" << s.p50 << " p90=" << s.p90 << " p99=" << s.p99
+       << " max=" << s.max << " mean=" << static_cast<uint64_t>(s.mean);
+}
+
+void QnnLatencyRegistry::Dump(std::ostream& os, bool reset){
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto& kv : graphs_){
+        os << "[QNN] latency(us) " << kv.first << " |";
+        PrintOne(os, "wall", kv.second->wall_us.Snap());
+        os << " |";
+        PrintOne(os, "accel", kv.second->accel_us.Snap());
+        os << "\n";
+        if (reset){
+            kv.second->wall_us.Reset();
+            kv.second->accel_us.Reset();
+        }
+    }
+}
+
+void QnnLatencyRegistry::ResetAll(){
+    std::lock_guard<std::mutex> lk(mu_);
+    for (auto& kv : graphs_){
+        kv.second->wall_us.Reset();
+        kv.second->accel_us.Reset();
+    }
+}
+
+void QnnLatencyRegistry::StartPeriodicDump(uint32_t interval_ms, bool reset_after_dump){
+    StopPeriodicDump();
+    {
+        std::lock_guard<std::mutex> lk(dump_mu_);
+        dump_stop_ = false;
+    }
+    dump_thread_ = std::thread([this, interval_ms, reset_after_dump]{
+        std::unique_lock<std::mutex> lk(dump_mu_);
+        while (!dump_cv_.wait_for(lk, std::chrono::milliseconds(interval_ms), [this]{ return dump_stop_; })){
+            lk.unlock();
+            Dump(std::cout, reset_after_dump);
+            lk.lock();
+        }
+    });
+}
+
+void QnnLatencyRegistry::StopPeriodicDump(){
+    {
+        std::lock_guard<std::mutex> lk(dump_mu_);
+        dump_stop_ = true;
+    }
+    dump_cv_.notify_all();
+    if (dump_thread_.joinable()) dump_thread_.join();
+}
+
+QnnLatencyTimer::QnnLatencyTimer(QnnLatencyHistogram& hist)
+    : hist_(hist), start_(SteadyNowUs()) {}
+
+QnnLatencyTimer::~QnnLatencyTimer(){
+    hist_.Record(SteadyNowUs() - start_);
+}
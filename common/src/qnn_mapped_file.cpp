@@ -0,0 +1,53 @@
+#include "qnn_mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+
+bool QnnMappedFile::Open(const std::string& path, bool will_need){
+    Close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0){
+        std::cerr << "[QNN] MappedFile: failed to open " << path << " : " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    struct stat st{};
+    if (::fstat(fd, &st) != 0 || st.st_size <= 0){
+        std::cerr << "[QNN] MappedFile: empty or unreadable " << path << "\n";
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    // MAP_PRIVATE + PROT_WRITE: backend가 buffer를 non-const로 받는 API가 있어도 file은 안전
+    void* addr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    // mapping keeps its own reference to the file
+    ::close(fd);
+    if (addr == MAP_FAILED){
+        std::cerr << "[QNN] MappedFile: mmap failed for " << path << " : " << std::strerror(errno) << "\n";
+        return false;
+    }
+
+    if (will_need) (void)::madvise(addr, size, MADV_WILLNEED);
+
+    path_ = path;
+    addr_ = addr;
+    size_ = size;
+    return true;
+}
+
+void QnnMappedFile::Close(){
+    if (addr_){
+        ::munmap(addr_, size_);
+    }
+    addr_ = nullptr;
+    size_ = 0;
+    path_.clear();
+}
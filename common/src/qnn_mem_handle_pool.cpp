@@ -0,0 +1,204 @@
+#include "qnn_mem_handle_pool.h"
+
+#include <iostream>
+
+#include "qnn_sharedbuffer.h"
+#include "qnn_tensor.h"
+
+static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what){
+    if (err != QNN_SUCCESS){
+        std::cerr << "[QNN] " << what << " failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
+        return false;
+    }
+    return true;
+}
+
+size_t QnnMemHandleKeyHash::operator()(const QnnMemHandleKey& k) const{
+    // FNV-1a over the fields
+    uint64_t h = 1469598103934665603ull;
+    auto mix = [&h](uint64_t v){ h ^= v; h *= 1099511628211ull; };
+    mix(reinterpret_cast<uintptr_t>(k.ctx));
+    mix(static_cast<uint32_t>(k.fd));
+    mix(k.offset);
+    mix(static_cast<uint64_t>(k.dtype));
+    for (uint32_t d : k.dims) mix(d);
+    return static_cast<size_t>(h);
+}
+
+static void DropFdHook(int32_t fd){
+    QnnMemHandlePool::Instance().DropFd(fd);
+}
+
+QnnMemHandlePool::QnnMemHandlePool(){
+    // a pooled handle must not outlive the buffer it maps
+    SharedBuffer::Instance().SetFdReleaseHook(&DropFdHook);
+}
+
+QnnMemHandlePool& QnnMemHandlePool::Instance(){
+    // never destroyed: SharedBuffer (a function static itself) calls DropFd from its destructor
+    static QnnMemHandlePool* pool = new QnnMemHandlePool();
+    return *pool;
+}
+
+QnnMemHandleKey QnnMemHandlePool::MakeKey(Qnn_ContextHandle_t ctx, int32_t fd, uint64_t offset, const Qnn_Tensor_t& t){
+    QnnMemHandleKey k;
+    k.ctx = ctx;
+    k.fd = fd;
+    k.offset = offset;
+    auto* tv = QNN_TENSOR_VER_PTR(t);
+    k.dtype = tv->dataType;
+    k.dims.assign(tv->dimensions, tv->dimensions + tv->rank);
+    return k;
+}
+
+Qnn_MemHandle_t QnnMemHandlePool::Acquire(const QnnMemHandleKey& key){
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return nullptr;
+    if (it->second.refs++ == 0) --idle_;
+    ++hits_;
+    return it->second.handle;
+}
+
+Qnn_MemHandle_t QnnMemHandlePool::Insert(const QnnMemHandleKey& key, Qnn_MemHandle_t h, const QnnInterface_t* be){
+    std::lock_guard<std::mutex> lk(mu_);
+    auto res = entries_.emplace(key, Entry{h, be, 1, 0});
+    if (!res.second){
+        Entry& e = res.first->second;
+        if (e.refs++ == 0) --idle_;
+        return e.handle;
+    }
+    by_handle_[h] = &res.first->first;
+    ++inserts_;
+    return h;
+}
+
+bool QnnMemHandlePool::Release(Qnn_MemHandle_t h){
+    std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>> evicted;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        auto bh = by_handle_.find(h);
+        if (bh == by_handle_.end()) return false;
+        Entry& e = entries_.at(*bh->second);
+        if (e.refs == 0){
+            std::cerr << "[QNN] MemHandlePool Release: handle is already idle\n";
+            return true;
+        }
+        if (--e.refs == 0){
+            e.idle_tick = ++tick_;
+            ++idle_;
+            if (idle_ > max_idle_) EvictLocked(evicted);
+        }
+    }
+    DeRegister(evicted);
+    return true;
+}
+
+template <typename Pred>
+void QnnMemHandlePool::EraseLocked(Pred pred, bool idle_only,
+                                   std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& out){
+    for (auto it = entries_.begin(); it != entries_.end();){
+        const Entry& e = it->second;
+        if (!pred(it->first) || (idle_only && e.refs != 0)){
+            ++it;
+            continue;
+        }
+        if (e.refs == 0) --idle_;
+        out.emplace_back(e.be, e.handle);
+        by_handle_.erase(e.handle);
+        it = entries_.erase(it);
+    }
+}
+
+void QnnMemHandlePool::EvictLocked(std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& out){
+    // oldest idle first, rare enough for a linear scan
+    while (idle_ > max_idle_){
+        auto victim = entries_.end();
+        for (auto it = entries_.begin(); it != entries_.end(); ++it){
+            if (it->second.refs == 0 && (victim == entries_.end() || it->second.idle_tick < victim->second.idle_tick))
+                victim = it;
+        }
+        if (victim == entries_.end()) break;
+        out.emplace_back(victim->second.be, victim->second.handle);
+        by_handle_.erase(victim->second.handle);
+        entries_.erase(victim);
+        --idle_;
+    }
+}
+
+void QnnMemHandlePool::DeRegister(const std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>>& handles){
+    if (handles.empty()) return;
+    // one memDeRegister per backend interface (normally just one)
+    std::vector<Qnn_MemHandle_t> batch;
+    std::vector<bool> done(handles.size(), false);
+    for (size_t i = 0; i < handles.size(); ++i){
+        if (done[i]) continue;
+        const QnnInterface_t* be = handles[i].first;
+        batch.clear();
+        for (size_t j = i; j < handles.size(); ++j){
+            if (!done[j] && handles[j].first == be){
+                batch.push_back(handles[j].second);
+                done[j] = true;
+            }
+        }
+        if (!be) continue;
+        (void)CheckQnnOk(be->QNN_INTERFACE_VER_NAME.memDeRegister(batch.data(), static_cast<uint32_t>(batch.size())),
+                         "memDeRegister(pool)");
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    deregistered_ += handles.size();
+}
+
+size_t QnnMemHandlePool::Trim(){
+    std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>> out;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        EraseLocked([](const QnnMemHandleKey&){ return true; }, /*idle_only=*/true, out);
+    }
+    DeRegister(out);
+    return out.size();
+}
+
+void QnnMemHandlePool::DropFd(int32_t fd){
+    std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>> out;
+    size_t in_use = 0;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (const auto& kv : entries_) if (kv.first.fd == fd && kv.second.refs) ++in_use;
+        EraseLocked([fd](const QnnMemHandleKey& k){ return k.fd == fd; }, /*idle_only=*/false, out);
+    }
+    if (in_use){
+        std::cerr << "[QNN] MemHandlePool: fd " << fd << " freed with " << in_use << " handle(s) still in use\n";
+    }
+    DeRegister(out);
+}
+
+void QnnMemHandlePool::DropContext(Qnn_ContextHandle_t ctx){
+    std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>> out;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        EraseLocked([ctx](const QnnMemHandleKey& k){ return k.ctx == ctx; }, /*idle_only=*/false, out);
+    }
+    DeRegister(out);
+}
+
+void QnnMemHandlePool::SetMaxIdle(size_t n){
+    std::vector<std::pair<const QnnInterface_t*, Qnn_MemHandle_t>> evicted;
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        max_idle_ = n;
+        EvictLocked(evicted);
+    }
+    DeRegister(evicted);
+}
+
+QnnMemHandlePool::Stats QnnMemHandlePool::GetStats() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats st;
+    st.entries = entries_.size();
+    st.idle = idle_;
+    st.hits = hits_;
+    st.inserts = inserts_;
+    st.deregistered = deregistered_;
+    return st;
+}
@@ -1,8 +1,10 @@
 #include "qnn_mem_manager.h"
+#include "qnn_runtime_gate.h"
 #include "QnnCommon.h"
 #include "QnnInterface.h"
 #include "QnnTypes.h"
 #include "qnn_context.h"
+#include "qnn_mem_telemetry.h"
 #include "qnn_tensor.h"
 #include <cstddef>
 
@@ -24,6 +26,20 @@ bool QnnMemManagerRuntime::Init(const QnnInterface_t* be_iface, QnnContextRuntim
     return true;
 }
 
+void QnnMemManagerRuntime::Track(Qnn_MemHandle_t h, void* mem_ptr, size_t bytes){
+    if (!registered_.insert({h, mem_ptr}).second) return;
+    registered_bytes_ += bytes;
+    QnnMemTelemetry::Instance().AddRegistered(1, static_cast<int64_t>(bytes));
+}
+
+QnnMemManagerRuntime::Stats QnnMemManagerRuntime::GetStats() const{
+    Stats st;
+    st.handles = registered_.size();
+    st.pooled = pooled_.size();
+    st.bytes = registered_bytes_;
+    return st;
+}
+
 bool QnnMemManagerRuntime::IsReigstered(Qnn_MemHandle_t handle, void* mem_ptr) const{
     auto it = registered_.find(handle);
     if (it != registered_.end()){
@@ -34,7 +50,7 @@ bool QnnMemManagerRuntime::IsReigstered(Qnn_MemHandle_t handle, void* mem_ptr) c
 
 bool QnnMemManagerRuntime::RegisterIon(Qnn_Tensor_t& tensor_meta, int32_t mem_fd,
                                     void* mem_ptr, Qnn_MemHandle_t* out_handle){
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
     (void) tensor_meta; (void) mem_fd; (void) mem_ptr;
     if(out_handle) *out_handle = nullptr;
     std::cerr << "[QNN] RegisterIon: noop on non-aarch64\n";
@@ -67,32 +83,18 @@ bool QnnMemManagerRuntime::RegisterIon(Qnn_Tensor_t& tensor_meta, int32_t mem_fd
     if(!CheckQnnOk(err, "memRegister(ION)")) return false;
 
     SetTensorMemHandle(tensor_meta, handle);
-    registered_.insert({handle, mem_ptr});
+    Track(handle, mem_ptr, QnnTensor::MetaBytes(tensor_meta));
     *out_handle = handle;
     return true;
 #endif
 }
 
-bool QnnMemManagerRuntime::RegisterHtpSharedBufferCustom(
-    Qnn_Tensor_t& tensor_meta,
-    int32_t mem_fd,
-    void* mem_ptr,
-    size_t total_custom_mem_size,
-    size_t tensor_offset,
-    Qnn_MemHandle_t* out_handle
-){
-#if !defined (__aarch64__)
-    (void) tensor_meta; (void) mem_fd; (void) mem_ptr; (void) total_custom_mem_size; (void) tensor_offset;
-    if(out_handle) *out_handle = nullptr;
-    std::cerr << "[QNN] RegisterCustom: noop on non-aarch64\n";
-    return false;
-#else
-    if (!be_ || !ctx_ || !ctx_->IsValid() || !out_handle) {
-        return false;
-    }
-    auto &api = be_->QNN_INTERFACE_VER_NAME;
-
-    Qnn_MemDescriptor_t desc{};
+#if QNN_RUNTIME_ENABLED
+// CUSTOM (HTP shared buffer) descriptor for one tensor at fd+offset. desc->customInfo points at htp_desc
+static bool FillSharedBufferDesc(const Qnn_Tensor_t& tensor_meta, int32_t mem_fd, size_t total_custom_mem_size,
+                                 size_t tensor_offset, Qnn_MemDescriptor_t* out_desc, QnnMemHtp_Descriptor_t* htp_desc){
+    Qnn_MemDescriptor_t& desc = *out_desc;
+    desc = Qnn_MemDescriptor_t{};
     if (tensor_meta.version == QNN_TENSOR_VERSION_2){
         desc.memShape.numDim = QNN_TENSOR_VER_PTR(tensor_meta)->rank;
         desc.memShape.dimSize = QNN_TENSOR_VER_PTR(tensor_meta)->dimensions;
@@ -112,9 +114,7 @@ bool QnnMemManagerRuntime::RegisterHtpSharedBufferCustom(
 
     desc.ionInfo.fd = mem_fd;
 
-    auto htp_desc = std::make_unique<QnnMemHtp_Descriptor_t>();
-    std::memset(htp_desc.get(), 0, sizeof(QnnMemHtp_Descriptor_t));
-
+    std::memset(htp_desc, 0, sizeof(QnnMemHtp_Descriptor_t));
     htp_desc->type = QNN_HTP_MEM_SHARED_BUFFER;
     htp_desc->size = total_custom_mem_size;
 
@@ -123,7 +123,33 @@ bool QnnMemManagerRuntime::RegisterHtpSharedBufferCustom(
     sb_cfg.offset = tensor_offset;
     htp_desc->sharedBufferConfig = sb_cfg;
 
-    desc.customInfo = reinterpret_cast<Qnn_MemInfoCustom_t>(htp_desc.get()); // static cast < Qnn_MemInfoCustom_t> 안해도 되나?
+    desc.customInfo = reinterpret_cast<Qnn_MemInfoCustom_t>(htp_desc); // static cast < Qnn_MemInfoCustom_t> 안해도 되나?
+    return true;
+}
+#endif
+
+bool QnnMemManagerRuntime::RegisterHtpSharedBufferCustom(
+    Qnn_Tensor_t& tensor_meta,
+    int32_t mem_fd,
+    void* mem_ptr,
+    size_t total_custom_mem_size,
+    size_t tensor_offset,
+    Qnn_MemHandle_t* out_handle
+){
+#if !QNN_RUNTIME_ENABLED
+    (void) tensor_meta; (void) mem_fd; (void) mem_ptr; (void) total_custom_mem_size; (void) tensor_offset;
+    if(out_handle) *out_handle = nullptr;
+    std::cerr << "[QNN] RegisterCustom: noop on non-aarch64\n";
+    return false;
+#else
+    if (!be_ || !ctx_ || !ctx_->IsValid() || !out_handle) {
+        return false;
+    }
+    auto &api = be_->QNN_INTERFACE_VER_NAME;
+
+    Qnn_MemDescriptor_t desc{};
+    auto htp_desc = std::make_unique<QnnMemHtp_Descriptor_t>();
+    if (!FillSharedBufferDesc(tensor_meta, mem_fd, total_custom_mem_size, tensor_offset, &desc, htp_desc.get())) return false;
     htp_desc_storage_.push_back(std::move(htp_desc));
 
     Qnn_MemHandle_t handle = nullptr;
@@ -134,7 +160,7 @@ bool QnnMemManagerRuntime::RegisterHtpSharedBufferCustom(
         std::cerr << "Failed to set mem Handle\n";
         return false;
     };
-    registered_.insert({handle, mem_ptr});
+    Track(handle, mem_ptr, QnnTensor::MetaBytes(tensor_meta));
     *out_handle = handle;
     return true;
 #endif
@@ -162,32 +188,48 @@ bool QnnMemManagerRuntime::SetTensorMemHandle(Qnn_Tensor_t& t, Qnn_MemHandle_t h
 }
 
 void QnnMemManagerRuntime::DeRegisterAll(){
-#if !defined(__aarch64__)
+    if (!registered_.empty()){
+        QnnMemTelemetry::Instance().AddRegistered(-static_cast<int64_t>(registered_.size()),
+                                                  -static_cast<int64_t>(registered_bytes_));
+        registered_bytes_ = 0;
+    }
+#if !QNN_RUNTIME_ENABLED
     registered_.clear();
+    pooled_.clear();
+    sb_handle_by_key_.clear();
     return;
 #else
     if(!be_ || registered_.empty()) return;
     auto& api = be_->QNN_INTERFACE_VER_NAME;
 
+    auto& pool = QnnMemHandlePool::Instance();
+    std::vector<Qnn_MemHandle_t> own;
+    own.reserve(registered_.size());
     for(auto& kv: registered_){
-        Qnn_MemHandle_t h= kv.first;
-        auto err = api.memDeRegister(&h, 1);
+        Qnn_MemHandle_t h = kv.first;
+        // pooled: keep it registered for the next session (already gone if the context was freed first)
+        if (pooled_.count(h)){
+            (void)pool.Release(h);
+            continue;
+        }
+        own.push_back(h);
+    }
+    if (!own.empty()){
+        auto err = api.memDeRegister(own.data(), static_cast<uint32_t>(own.size()));
         (void)CheckQnnOk(err, "memDeRegister");
     }
     registered_.clear();
+    pooled_.clear();
+    sb_handle_by_key_.clear();
     htp_desc_storage_.clear();
 #endif
 }
 
-static inline uint64_t MakeKey(int fd, size_t off) {
-  return (uint64_t(uint32_t(fd)) << 32) | uint64_t(uint32_t(off));
-}
-
 bool QnnMemManagerRuntime::RegisterTensorInSharedArena(
         SharedBuffer& sb, SharedBuffer::Arena& arena,
         Qnn_Tensor_t& tensor_meta, size_t tensor_bytes,
         size_t alignment, void** out_ptr, Qnn_MemHandle_t* out_handle, size_t* out_offset){
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)sb; (void)arena; (void)out_handle; (void)out_offset;
   return false;
 #else
@@ -202,30 +244,230 @@ bool QnnMemManagerRuntime::RegisterTensorInSharedArena(
     return false;
   }
 
-  const uint64_t key = MakeKey(arena.fd, off);
-  auto it = sb_handle_by_key_.find(key);
-  if(it != sb_handle_by_key_.end()){
-    Qnn_MemHandle_t h = it->second;
-    SetTensorMemHandle(tensor_meta, h);
-    *out_ptr = ptr;
-    *out_handle = h;
-    if(out_offset) *out_offset = off;
-    return true;
+  if (!RegisterTensorAtArenaOffset(arena, tensor_meta, off, out_ptr, out_handle)) return false;
+  if(out_offset) *out_offset = off;
+  return true;
+#endif
+}
+
+bool QnnMemManagerRuntime::RegisterTensorAtArenaOffset(
+        SharedBuffer::Arena& arena, Qnn_Tensor_t& tensor_meta,
+        size_t offset, void** out_ptr, Qnn_MemHandle_t* out_handle){
+  if (!out_ptr || !out_handle) return false;
+  // fast path: already registered by this manager
+  if (ctx_ && ctx_->IsValid() && arena.base && offset < arena.total){
+    auto it = sb_handle_by_key_.find(QnnMemHandlePool::MakeKey(ctx_->Handle(), arena.fd, offset, tensor_meta));
+    if (it != sb_handle_by_key_.end()){
+      SetTensorMemHandle(tensor_meta, it->second);
+      *out_ptr = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena.base) + offset);
+      *out_handle = it->second;
+      return true;
+    }
   }
+  std::vector<void*> ptrs;
+  std::vector<Qnn_MemHandle_t> handles;
+  if (!RegisterTensorsAtArenaOffsets(arena, {&tensor_meta}, {offset}, &ptrs, &handles)){
+    *out_ptr = nullptr;
+    *out_handle = nullptr;
+    return false;
+  }
+  *out_ptr = ptrs[0];
+  *out_handle = handles[0];
+  return true;
+}
 
-  Qnn_MemHandle_t h = nullptr;
-  if (!RegisterHtpSharedBufferCustom(
-    tensor_meta, arena.fd, ptr, arena.total, off, &h
-  )){
-    std::cerr << "[QNN] RegisterHtpSharedBufferCustom failed\n";
+bool QnnMemManagerRuntime::RegisterTensorsInSharedArena(
+        SharedBuffer& sb, SharedBuffer::Arena& arena,
+        const std::vector<Qnn_Tensor_t*>& tensors, const std::vector<size_t>& tensor_bytes,
+        size_t alignment, std::vector<void*>* out_ptrs, std::vector<Qnn_MemHandle_t>* out_handles,
+        std::vector<size_t>* out_offsets){
+#if !QNN_RUNTIME_ENABLED
+  (void)sb; (void)arena; (void)tensors; (void)tensor_bytes; (void)alignment;
+  (void)out_ptrs; (void)out_handles; (void)out_offsets;
+  return false;
+#else
+  if (tensors.size() != tensor_bytes.size()){
+    std::cerr << "[QNN] RegisterTensorsInSharedArena: tensors/bytes size mismatch\n";
     return false;
   }
+  std::vector<size_t> offsets(tensors.size(), 0);
+  for (size_t i = 0; i < tensors.size(); ++i){
+    void* ptr = nullptr;
+    if (!sb.ArenaAlloc(arena, tensor_bytes[i], alignment, &ptr, &offsets[i])){
+      std::cerr << "[QNN] Arena Alloc failed. bytes = " << tensor_bytes[i] << "\n";
+      return false;
+    }
+  }
+  if (!RegisterTensorsAtArenaOffsets(arena, tensors, offsets, out_ptrs, out_handles)) return false;
+  if (out_offsets) *out_offsets = std::move(offsets);
+  return true;
+#endif
+}
 
-  sb_handle_by_key_[key] = h;
+bool QnnMemManagerRuntime::RegisterTensorsAtArenaOffsets(
+        SharedBuffer::Arena& arena, const std::vector<Qnn_Tensor_t*>& tensors,
+        const std::vector<size_t>& offsets,
+        std::vector<void*>* out_ptrs, std::vector<Qnn_MemHandle_t>* out_handles){
+#if !QNN_RUNTIME_ENABLED
+  (void)arena; (void)tensors; (void)offsets; (void)out_ptrs; (void)out_handles;
+  return false;
+#else
+  if (!out_ptrs || !out_handles || !arena.base || arena.fd < 0) return false;
+  if (!be_ || !ctx_ || !ctx_->IsValid()) return false;
+  if (tensors.size() != offsets.size()){
+    std::cerr << "[QNN] RegisterTensorsAtArenaOffsets: tensors/offsets size mismatch\n";
+    return false;
+  }
+  const size_t n = tensors.size();
+  out_ptrs->assign(n, nullptr);
+  out_handles->assign(n, nullptr);
 
-  *out_ptr = ptr;
-  *out_handle = h;
-  if(out_offset) *out_offset = off;
+  auto& pool = QnnMemHandlePool::Instance();
+
+  // 1) hits: this manager first, then the process-wide pool
+  std::vector<QnnMemHandleKey> keys(n);
+  std::vector<size_t> miss;  // tensor index of the first occurrence of each missing key
+  std::unordered_map<QnnMemHandleKey, size_t, QnnMemHandleKeyHash> miss_slot;  // key -> index in miss
+  for (size_t i = 0; i < n; ++i){
+    if (!tensors[i]) return false;
+    if (offsets[i] >= arena.total){
+      std::cerr << "[QNN] RegisterTensorsAtArenaOffsets: offset " << offsets[i] << " out of arena (" << arena.total << ")\n";
+      return false;
+    }
+    keys[i] = QnnMemHandlePool::MakeKey(ctx_->Handle(), arena.fd, offsets[i], *tensors[i]);
+
+    Qnn_MemHandle_t h = nullptr;
+    auto it = sb_handle_by_key_.find(keys[i]);
+    if (it != sb_handle_by_key_.end()){
+      h = it->second;
+    } else if ((h = pool.Acquire(keys[i])) != nullptr){
+      sb_handle_by_key_[keys[i]] = h;
+      Track(h, reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena.base) + offsets[i]), QnnTensor::MetaBytes(*tensors[i]));
+      pooled_.insert(h);
+    } else {
+      // same key twice in one batch => one descriptor
+      if (miss_slot.emplace(keys[i], miss.size()).second) miss.push_back(i);
+      continue;
+    }
+    (*out_handles)[i] = h;
+  }
+
+  // 2) misses: one memRegister for all of them
+  if (!miss.empty()){
+    std::vector<Qnn_MemDescriptor_t> descs(miss.size());
+    for (size_t m = 0; m < miss.size(); ++m){
+      const size_t i = miss[m];
+      auto htp_desc = std::make_unique<QnnMemHtp_Descriptor_t>();
+      if (!FillSharedBufferDesc(*tensors[i], arena.fd, arena.total, offsets[i], &descs[m], htp_desc.get())) return false;
+      htp_desc_storage_.push_back(std::move(htp_desc));
+    }
+
+    std::vector<Qnn_MemHandle_t> fresh(miss.size(), nullptr);
+    auto& api = be_->QNN_INTERFACE_VER_NAME;
+    auto err = api.memRegister(ctx_->Handle(), descs.data(), static_cast<uint32_t>(descs.size()), fresh.data());
+    if (!CheckQnnOk(err, "memRegister(CUSTOM/HTP_SHARED_BUFFER, batch)")) return false;
+
+    // another session may have registered the same key meanwhile => use its handle, drop ours
+    std::vector<Qnn_MemHandle_t> losers;
+    for (size_t m = 0; m < miss.size(); ++m){
+      const size_t i = miss[m];
+      Qnn_MemHandle_t h = pool.Insert(keys[i], fresh[m], be_);
+      if (h != fresh[m]) losers.push_back(fresh[m]);
+      sb_handle_by_key_[keys[i]] = h;
+      Track(h, reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena.base) + offsets[i]), QnnTensor::MetaBytes(*tensors[i]));
+      pooled_.insert(h);
+    }
+    if (!losers.empty()){
+      (void)CheckQnnOk(api.memDeRegister(losers.data(), static_cast<uint32_t>(losers.size())), "memDeRegister(dup)");
+    }
+  }
+
+  // 3) fill outputs (duplicates inside the batch resolve through sb_handle_by_key_)
+  for (size_t i = 0; i < n; ++i){
+    Qnn_MemHandle_t h = sb_handle_by_key_.at(keys[i]);
+    SetTensorMemHandle(*tensors[i], h);
+    (*out_ptrs)[i] = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena.base) + offsets[i]);
+    (*out_handles)[i] = h;
+  }
   return true;
 #endif
-}
\ No newline at end of file
+}
+
+bool QnnArenaAliasMap::GetOrAlloc(SharedBuffer& sb, SharedBuffer::Arena& arena, const std::string& name,
+                                  size_t bytes, size_t alignment, size_t* out_offset){
+  if (!out_offset) return false;
+  auto it = slices_.find(name);
+  if (it != slices_.end()){
+    if (bytes > it->second.bytes){
+      std::cerr << "[QNN] Alias " << name << ": " << bytes << " bytes do not fit in slice of " << it->second.bytes << "\n";
+      return false;
+    }
+    *out_offset = it->second.offset;
+    return true;
+  }
+  void* ptr = nullptr;
+  size_t off = 0;
+  if (!sb.ArenaAlloc(arena, bytes, alignment, &ptr, &off)){
+    std::cerr << "[QNN] Alias " << name << ": Arena Alloc failed. bytes = " << bytes << "\n";
+    return false;
+  }
+  slices_[name] = Slice{off, bytes};
+  *out_offset = off;
+  return true;
+}
+
+bool QnnArenaAliasMap::Find(const std::string& name, size_t* out_offset, size_t* out_bytes) const{
+  auto it = slices_.find(name);
+  if (it == slices_.end()) return false;
+  if (out_offset) *out_offset = it->second.offset;
+  if (out_bytes) *out_bytes = it->second.bytes;
+  return true;
+}
+
+bool QnnMemManagerRuntime::BindAlias(SharedBuffer& sb, SharedBuffer::Arena& arena, QnnArenaAliasMap& aliases,
+                                     const std::string& alias, Qnn_Tensor_t& tensor_meta, size_t tensor_bytes,
+                                     void** out_ptr, Qnn_MemHandle_t* out_handle){
+  size_t off = 0;
+  if (!aliases.GetOrAlloc(sb, arena, alias, tensor_bytes, arena.alignment, &off)) return false;
+  return RegisterTensorAtArenaOffset(arena, tensor_meta, off, out_ptr, out_handle);
+}
+
+bool QnnMemManagerRuntime::BindOutputsInSharedArena(SharedBuffer& sb, SharedBuffer::Arena& arena,
+                                                    std::vector<Qnn_Tensor_t>& outputs, QnnArenaAliasMap* aliases,
+                                                    const std::vector<const std::string*>& alias_of,
+                                                    std::vector<void*>* out_ptrs, std::vector<size_t>* out_bytes){
+  if (!out_ptrs || !out_bytes || (!alias_of.empty() && (!aliases || alias_of.size() != outputs.size()))){
+    std::cerr << "[QNN] BindOutputsInSharedArena: invalid args\n";
+    return false;
+  }
+  out_ptrs->assign(outputs.size(), nullptr);
+  out_bytes->assign(outputs.size(), 0);
+
+  std::vector<Qnn_Tensor_t*> tensors;
+  std::vector<size_t> bytes, idx;
+  for (size_t i = 0; i < outputs.size(); ++i){
+    (*out_bytes)[i] = QnnTensor::MetaBytes(outputs[i]);
+    // aliased output: the consumer graph reads it straight from the slice
+    if (!alias_of.empty() && alias_of[i]){
+      Qnn_MemHandle_t h = nullptr;
+      if (!BindAlias(sb, arena, *aliases, *alias_of[i], outputs[i], (*out_bytes)[i], &(*out_ptrs)[i], &h)){
+        std::cerr << "[QNN] BindAlias failed for output " << QNN_TENSOR_VER_PTR(outputs[i])->name << "\n";
+        return false;
+      }
+      continue;
+    }
+    tensors.push_back(&outputs[i]);
+    bytes.push_back((*out_bytes)[i]);
+    idx.push_back(i);
+  }
+  if (tensors.empty()) return true;
+
+  std::vector<void*> ptrs;
+  std::vector<Qnn_MemHandle_t> handles;
+  if (!RegisterTensorsInSharedArena(sb, arena, tensors, bytes, 64, &ptrs, &handles)){
+    std::cerr << "[QNN] RegisterTensorsInSharedArena failed for outputs\n";
+    return false;
+  }
+  for (size_t k = 0; k < ptrs.size(); ++k) (*out_ptrs)[idx[k]] = ptrs[k];
+  return true;
+}
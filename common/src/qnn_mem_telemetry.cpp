@@ -0,0 +1,166 @@
+#include "qnn_mem_telemetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include "qnn_mem_handle_pool.h"
+#include "qnn_sharedbuffer.h"
+
+static inline uint64_t SteadyNowUs(){
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+// "<key>:   1234 kB" from /proc/self/status, 0 if not there (non-Linux)
+static uint64_t ReadStatusKb(const char* key){
+    std::ifstream in("/proc/self/status");
+    const std::string k(key);
+    std::string line;
+    while (std::getline(in, line)){
+        if (line.rfind(k, 0) == 0){
+            std::istringstream ss(line.substr(k.size()));
+            uint64_t kb = 0;
+            ss >> kb;
+            return kb;
+        }
+    }
+    return 0;
+}
+
+uint64_t QnnMemTelemetry::RssKb(){ return ReadStatusKb("VmRSS:"); }
+uint64_t QnnMemTelemetry::PeakRssKb(){ return ReadStatusKb("VmHWM:"); }
+
+QnnMemTelemetry& QnnMemTelemetry::Instance(){
+    static QnnMemTelemetry t;
+    return t;
+}
+
+void QnnMemTelemetry::OnArenaCreate(const void* base, size_t capacity){
+    std::lock_guard<std::mutex> lk(mu_);
+    ArenaStats& a = arenas_[reinterpret_cast<uintptr_t>(base)];
+    a = ArenaStats{};
+    a.base = reinterpret_cast<uintptr_t>(base);
+    a.capacity = capacity;
+}
+
+void QnnMemTelemetry::OnArenaAlloc(const void* base, size_t cursor, size_t padding){
+    std::lock_guard<std::mutex> lk(mu_);
+    auto it = arenas_.find(reinterpret_cast<uintptr_t>(base));
+    if (it == arenas_.end()) return;  // arena not from ArenaCreate (e.g. host stand-in)
+    ArenaStats& a = it->second;
+    a.used = cursor;
+    a.high_water = std::max(a.high_water, cursor);
+    a.padding += padding;
+    ++a.allocs;
+}
+
+void QnnMemTelemetry::OnArenaDestroy(const void* base){
+    std::lock_guard<std::mutex> lk(mu_);
+    arenas_.erase(reinterpret_cast<uintptr_t>(base));
+}
+
+void QnnMemTelemetry::RecordDspHeap(const std::string& point, uint64_t value){
+    std::lock_guard<std::mutex> lk(mu_);
+    dsp_heap_.push_back(DspHeapSample{SteadyNowUs(), point, value});
+    if (dsp_heap_.size() > kMaxDspSamples) dsp_heap_.pop_front();
+}
+
+QnnMemTelemetry::Snapshot QnnMemTelemetry::Snap() const{
+    Snapshot s;
+    s.ts_us = SteadyNowUs();
+    {
+        std::lock_guard<std::mutex> lk(mu_);
+        for (const auto& kv : arenas_) s.arenas.push_back(kv.second);
+        s.dsp_heap.assign(dsp_heap_.begin(), dsp_heap_.end());
+    }
+    std::sort(s.arenas.begin(), s.arenas.end(),
+              [](const ArenaStats& a, const ArenaStats& b){ return a.base < b.base; });
+    s.registered_handles = registered_handles_.load(std::memory_order_relaxed);
+    s.registered_bytes = registered_bytes_.load(std::memory_order_relaxed);
+    s.rss_kb = RssKb();
+    s.peak_rss_kb = PeakRssKb();
+    return s;
+}
+
+void QnnMemTelemetry::DumpJson(std::ostream& os) const{
+    const Snapshot s = Snap();
+    const SharedBuffer::Stats sb = SharedBuffer::Instance().GetStats();
+    const QnnMemHandlePool::Stats pool = QnnMemHandlePool::Instance().GetStats();
+
+    os << "{\n";
+    os << "  \"ts_us\": " << s.ts_us << ",\n";
+    os << "  \"host\": {\"rss_kb\": " << s.rss_kb << ", \"peak_rss_kb\": " << s.peak_rss_kb << "},\n";
+    os << "  \"arenas\": [";
+    for (size_t i = 0; i < s.arenas.size(); ++i){
+        const ArenaStats& a = s.arenas[i];
+        char base[32];
+        std::snprintf(base, sizeof(base), "0x%llx", static_cast<unsigned long long>(a.base));
+        os << (i ? ",\n" : "\n") << "    {\"base\": \"" << base << "\", \"capacity\": " << a.capacity
+           << ", \"used\": " << a.used << ", \"high_water\": " << a.high_water
+           << ", \"allocs\": " << a.allocs << ", \"padding\": " << a.padding
+           << ", \"fragmentation\": " << a.Fragmentation() << "}";
+    }
+    os << (s.arenas.empty() ? "],\n" : "\n  ],\n");
+    os << "  \"rpcmem\": {\"allocs\": " << sb.allocs << ", \"frees\": " << sb.frees
+       << ", \"rpcmem_allocs\": " << sb.rpcmem_allocs << ", \"rpcmem_frees\": " << sb.rpcmem_frees
+       << ", \"live\": " << sb.live << ", \"pooled_bytes\": " << sb.pooled_bytes << "},\n";
+    os << "  \"mem_handles\": {\"registered\": " << s.registered_handles
+       << ", \"registered_bytes\": " << s.registered_bytes
+       << ", \"pool_entries\": " << pool.entries << ", \"pool_idle\": " << pool.idle << "},\n";
+    os << "  \"dsp_heap\": [";
+    for (size_t i = 0; i < s.dsp_heap.size(); ++i){
+        const DspHeapSample& d = s.dsp_heap[i];
+        os << (i ? ",\n" : "\n") << "    {\"ts_us\": " << d.ts_us << ", \"point\": \"" << d.point
+           << "\", \"value\": " << d.value << "}";
+    }
+    os << (s.dsp_heap.empty() ? "]\n" : "\n  ]\n");
+    os << "}";
+}
+
+bool QnnMemTelemetry::WriteJson(const std::string& path) const{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::trunc);
+        if (!out.good()){
+            std::cerr << "[QNN] MemTelemetry: failed to open " << tmp << "\n";
+            return false;
+        }
+        DumpJson(out);
+        out << "\n";
+        if (!out.good()) return false;
+    }
+    if (std::rename(tmp.c_str(), path.c_str()) != 0){
+        std::cerr << "[QNN] MemTelemetry: rename to " << path << " failed\n";
+        return false;
+    }
+    return true;
+}
+
+void QnnMemTelemetry::StartPeriodicDump(uint32_t interval_ms, const std::string& path){
+    StopPeriodicDump();
+    {
+        std::lock_guard<std::mutex> lk(dump_mu_);
+        dump_stop_ = false;
+    }
+    dump_thread_ = std::thread([this, interval_ms, path]{
+        std::unique_lock<std::mutex> lk(dump_mu_);
+        while (!dump_cv_.wait_for(lk, std::chrono::milliseconds(interval_ms), [this]{ return dump_stop_; })){
+            lk.unlock();
+            (void)WriteJson(path);
+            lk.lock();
+        }
+    });
+}
+
+void QnnMemTelemetry::StopPeriodicDump(){
+    {
+        std::lock_guard<std::mutex> lk(dump_mu_);
+        dump_stop_ = true;
+    }
+    dump_cv_.notify_all();
+    if (dump_thread_.joinable()) dump_thread_.join();
+}
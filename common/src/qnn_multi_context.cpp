@@ -0,0 +1,161 @@
+#include "qnn_multi_context.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+bool QnnMultiContextRuntime::ReadFile(const std::string& path, std::vector<uint8_t>& out){
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in.is_open()){
+        std::cerr << "[QNN] MultiContext: failed to open " << path << "\n";
+        return false;
+    }
+    const std::streamsize size = in.tellg();
+    if (size <= 0){
+        std::cerr << "[QNN] MultiContext: empty binary " << path << "\n";
+        return false;
+    }
+    in.seekg(0);
+    out.resize(static_cast<size_t>(size));
+    if (!in.read(reinterpret_cast<char*>(out.data()), size)){
+        std::cerr << "[QNN] MultiContext: read failed " << path << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool QnnMultiContextRuntime::LoadBinaries(const QnnSystemInterface_t* sys_iface,
+                                          const std::vector<std::string>& paths){
+    if (!sys_iface || paths.empty()){
+        std::cerr << "[QNN] MultiContext LoadBinaries: invalid sys_iface/paths\n";
+        return false;
+    }
+    return ReadBinaries(paths) && ParseBinaries(sys_iface);
+}
+
+bool QnnMultiContextRuntime::ReadBinaries(const std::vector<std::string>& paths){
+    if (paths.empty()){
+        std::cerr << "[QNN] MultiContext ReadBinaries: no paths\n";
+        return false;
+    }
+    Destroy();
+
+    // entries_ must not reallocate after blobs are handed to the caches
+    entries_.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i){
+        entries_[i].path = paths[i];
+        if (!ReadFile(entries_[i].path, entries_[i].blob)) return false;
+    }
+    return true;
+}
+
+bool QnnMultiContextRuntime::ParseBinaries(const QnnSystemInterface_t* sys_iface){
+    if (!sys_iface || entries_.empty()){
+        std::cerr << "[QNN] MultiContext ParseBinaries: invalid sys_iface or nothing read\n";
+        return false;
+    }
+    max_sf_buf_size_ = 0;
+
+    for (auto& e : entries_){
+        QnnContextBinary blob;
+        blob.buffer = e.blob.data();
+        blob.nbytes = static_cast<uint32_t>(e.blob.size());
+
+        e.cache = std::make_unique<HtpBackendCacheRuntime>();
+        if (!e.cache->Create(sys_iface, blob)){
+            std::cerr << "[QNN] MultiContext: backend cache parse failed for " << e.path << "\n";
+            return false;
+        }
+        max_sf_buf_size_ = std::max(max_sf_buf_size_, e.cache->GetSpillFillBufferSize());
+
+        std::cout << "[QNN] MultiContext: " << e.path << " bytes=" << e.blob.size()
+                  << " graphs=" << e.cache->GraphNames().size()
+                  << " spill_fill=" << e.cache->GetSpillFillBufferSize() << "\n";
+    }
+    std::cout << "[QNN] MultiContext: max spill_fill=" << max_sf_buf_size_ << "\n";
+    return true;
+}
+
+bool QnnMultiContextRuntime::Create(const QnnInterface_t* be,
+                                    Qnn_BackendHandle_t backend_handle,
+                                    Qnn_DeviceHandle_t device_handle,
+                                    Qnn_ProfileHandle_t profile_handle){
+    if (!Prepare(be, backend_handle, device_handle, profile_handle)) return false;
+    for (size_t i = 0; i < entries_.size(); ++i){
+        if (!Activate(i)) return false;
+    }
+    return true;
+}
+
+bool QnnMultiContextRuntime::Prepare(const QnnInterface_t* be,
+                                     Qnn_BackendHandle_t backend_handle,
+                                     Qnn_DeviceHandle_t device_handle,
+                                     Qnn_ProfileHandle_t profile_handle){
+    if (entries_.empty()){
+        std::cerr << "[QNN] MultiContext Create: no binaries loaded\n";
+        return false;
+    }
+    std::lock_guard<std::mutex> lk(activate_mu_);
+    be_ = be;
+    backend_ = backend_handle;
+    device_ = device_handle;
+    profile_ = profile_handle;
+
+    // a single binary has nobody to share spill-fill with
+    const bool share = entries_.size() > 1 && max_sf_buf_size_ != 0;
+
+    for (auto& e : entries_){
+        if (e.ctx) continue;
+        e.ctx = std::make_unique<QnnContextRuntime>();
+        e.ctx->SetMultiContext(share, max_sf_buf_size_);
+    }
+    return true;
+}
+
+bool QnnMultiContextRuntime::Activate(size_t i){
+    // serialized: the first context created becomes the spill-fill group owner
+    std::lock_guard<std::mutex> lk(activate_mu_);
+    if (i >= entries_.size() || !entries_[i].ctx){
+        std::cerr << "[QNN] MultiContext Activate: bad index or not prepared (" << i << ")\n";
+        return false;
+    }
+    Entry& e = entries_[i];
+    if (e.ctx->IsValid()) return true;
+
+    if (!e.ctx->CreateFromBinary(be_, backend_, device_, profile_,
+                                 e.blob.data(), static_cast<uint32_t>(e.blob.size()))){
+        std::cerr << "[QNN] MultiContext: contextCreateFromBinary failed for " << e.path << "\n";
+        return false;
+    }
+    active_order_.push_back(i);
+    return true;
+}
+
+bool QnnMultiContextRuntime::IsActive(size_t i) const{
+    std::lock_guard<std::mutex> lk(activate_mu_);
+    return i < entries_.size() && entries_[i].ctx && entries_[i].ctx->IsValid();
+}
+
+void QnnMultiContextRuntime::Destroy(){
+    // free in reverse activation order so the spill-fill group owner (first context) goes last
+    for (auto it = active_order_.rbegin(); it != active_order_.rend(); ++it){
+        entries_[*it].ctx->Destroy();
+    }
+    active_order_.clear();
+    for (auto& e : entries_){
+        if (e.cache) e.cache->Destroy();
+    }
+    entries_.clear();
+    max_sf_buf_size_ = 0;
+}
+
+int QnnMultiContextRuntime::FindGraph(const std::string& graph_name) const{
+    for (size_t i = 0; i < entries_.size(); ++i){
+        if (!entries_[i].cache) continue;
+        const auto& names = entries_[i].cache->GraphNames();
+        if (std::find(names.begin(), names.end(), graph_name) != names.end()){
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
@@ -0,0 +1,205 @@
+#include "qnn_perf.h"
+
+#include <iostream>
+
+static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what){
+    if (err != QNN_SUCCESS){
+        std::cerr << "[QNN] " << what << " failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
+        return false;
+    }
+    return true;
+}
+
+namespace {
+
+struct DcvsSetting{
+    bool dcvs_enable;
+    QnnHtpPerfInfrastructure_PowerMode_t mode;
+    uint32_t sleep_latency_us;
+    bool sleep_disable;
+    QnnHtpPerfInfrastructure_VoltageCorner_t min, target, max;  // bus and core
+};
+
+// burst/sustained: DCVS off, fixed corner. balanced/power saver: DCVS on, bounded corners
+const DcvsSetting& DcvsFor(QnnHtpPowerProfile p){
+    static const DcvsSetting kTable[kNumHtpPowerProfiles] = {
+        /*kPowerSaver*/ {true, QNN_HTP_PERF_INFRASTRUCTURE_POWERMODE_POWER_SAVER_MODE, 2000, false,
+                         DCVS_VOLTAGE_VCORNER_SVS2, DCVS_VOLTAGE_VCORNER_SVS, DCVS_VOLTAGE_VCORNER_SVS_PLUS},
+        /*kBalanced*/   {true, QNN_HTP_PERF_INFRASTRUCTURE_POWERMODE_ADJUST_UP_DOWN, 1000, false,
+                         DCVS_VOLTAGE_VCORNER_SVS_PLUS, DCVS_VOLTAGE_VCORNER_NOM, DCVS_VOLTAGE_VCORNER_TURBO},
+        /*kSustained*/  {false, QNN_HTP_PERF_INFRASTRUCTURE_POWERMODE_PERFORMANCE_MODE, 100, false,
+                         DCVS_VOLTAGE_VCORNER_TURBO, DCVS_VOLTAGE_VCORNER_TURBO, DCVS_VOLTAGE_VCORNER_TURBO},
+        /*kBurst*/      {false, QNN_HTP_PERF_INFRASTRUCTURE_POWERMODE_PERFORMANCE_MODE, 40, true,
+                         DCVS_VOLTAGE_VCORNER_MAX_VOLTAGE_CORNER, DCVS_VOLTAGE_VCORNER_MAX_VOLTAGE_CORNER,
+                         DCVS_VOLTAGE_VCORNER_MAX_VOLTAGE_CORNER},
+    };
+    return kTable[static_cast<size_t>(p)];
+}
+
+}  // namespace
+
+QnnHtpPerfRuntime::QnnHtpPerfRuntime(){
+    // busy-polling only while latency matters; it burns a CPU core
+    rpc_[static_cast<size_t>(QnnHtpPowerProfile::kBurst)] = {9999, 100};
+    rpc_[static_cast<size_t>(QnnHtpPowerProfile::kSustained)] = {9999, 100};
+}
+
+bool QnnHtpPerfRuntime::Create(const QnnInterface_t* be_iface, QnnHtpPowerProfile idle,
+                               uint32_t device_id, uint32_t core_id){
+    if (!be_iface){
+        std::cerr << "[QNN] Perf Create: be_iface is null\n";
+        return false;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    if (power_config_id_valid_) return true;
+
+    auto& api = be_iface->QNN_INTERFACE_VER_NAME;
+    if (!api.deviceGetInfrastructure){
+        std::cerr << "[QNN] Perf Create: deviceGetInfrastructure not provided\n";
+        return false;
+    }
+    QnnDevice_Infrastructure_t infra = nullptr;
+    if (!CheckQnnOk(api.deviceGetInfrastructure(&infra), "deviceGetInfrastructure")) return false;
+
+    auto* htp_infra = reinterpret_cast<QnnHtpDevice_Infrastructure_t*>(infra);
+    if (!htp_infra || htp_infra->infraType != QNN_HTP_DEVICE_INFRASTRUCTURE_TYPE_PERF){
+        std::cerr << "[QNN] Perf Create: no HTP perf infrastructure\n";
+        return false;
+    }
+    perf_infra_ = htp_infra->perfInfra;
+    if (!perf_infra_.createPowerConfigId || !perf_infra_.setPowerConfig || !perf_infra_.destroyPowerConfigId){
+        std::cerr << "[QNN] Perf Create: incomplete perf infrastructure\n";
+        return false;
+    }
+    if (!CheckQnnOk(perf_infra_.createPowerConfigId(device_id, core_id, &power_config_id_), "createPowerConfigId"))
+        return false;
+    power_config_id_valid_ = true;
+
+    idle_ = idle;
+    applied_ = false;
+    active_.fill(0);
+    return ApplyLocked(idle_);
+}
+
+void QnnHtpPerfRuntime::Destroy(){
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!power_config_id_valid_) return;
+    // dropping the id drops the vote
+    (void)CheckQnnOk(perf_infra_.destroyPowerConfigId(power_config_id_), "destroyPowerConfigId");
+    power_config_id_valid_ = false;
+    applied_ = false;
+    active_.fill(0);
+}
+
+QnnHtpPowerProfile QnnHtpPerfRuntime::EffectiveLocked() const{
+    for (size_t i = kNumHtpPowerProfiles; i-- > 0;){
+        if (active_[i]) return static_cast<QnnHtpPowerProfile>(i);
+    }
+    return idle_;
+}
+
+bool QnnHtpPerfRuntime::ApplyLocked(QnnHtpPowerProfile p){
+    if (!power_config_id_valid_) return false;
+    if (applied_ && current_ == p) return true;
+
+    const DcvsSetting& d = DcvsFor(p);
+    const RpcSetting& rpc = rpc_[static_cast<size_t>(p)];
+
+    QnnHtpPerfInfrastructure_PowerConfig_t dcvs{};
+    dcvs.option = QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_DCVS_V3;
+    auto& v3 = dcvs.dcvsV3Config;
+    v3.contextId = power_config_id_;
+    v3.setDcvsEnable = 1;
+    v3.dcvsEnable = d.dcvs_enable ? 1 : 0;
+    v3.powerMode = d.mode;
+    v3.setSleepLatency = 1;
+    v3.sleepLatency = d.sleep_latency_us;
+    v3.setSleepDisable = 1;
+    v3.sleepDisable = d.sleep_disable ? 1 : 0;
+    v3.setBusParams = 1;
+    v3.busVoltageCornerMin = d.min;
+    v3.busVoltageCornerTarget = d.target;
+    v3.busVoltageCornerMax = d.max;
+    v3.setCoreParams = 1;
+    v3.coreVoltageCornerMin = d.min;
+    v3.coreVoltageCornerTarget = d.target;
+    v3.coreVoltageCornerMax = d.max;
+
+    // polling / control latency are always sent so that leaving burst resets them
+    QnnHtpPerfInfrastructure_PowerConfig_t polling{};
+    polling.option = QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_RPC_POLLING_TIME;
+    polling.rpcPollingTimeConfig = rpc.polling_us;
+
+    QnnHtpPerfInfrastructure_PowerConfig_t latency{};
+    latency.option = QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_RPC_CONTROL_LATENCY;
+    latency.rpcControlLatencyConfig = rpc.control_latency_us;
+
+    const QnnHtpPerfInfrastructure_PowerConfig_t* cfg[] = {&dcvs, &polling, &latency, nullptr};
+
+    if (!CheckQnnOk(perf_infra_.setPowerConfig(power_config_id_, cfg), "setPowerConfig")) return false;
+    ++votes_;
+    current_ = p;
+    applied_ = true;
+    return true;
+}
+
+bool QnnHtpPerfRuntime::Acquire(QnnHtpPowerProfile p){
+    std::lock_guard<std::mutex> lk(mu_);
+    ++active_[static_cast<size_t>(p)];
+    return ApplyLocked(EffectiveLocked());
+}
+
+bool QnnHtpPerfRuntime::Release(QnnHtpPowerProfile p){
+    std::lock_guard<std::mutex> lk(mu_);
+    auto& n = active_[static_cast<size_t>(p)];
+    if (n == 0){
+        std::cerr << "[QNN] Perf Release: " << ProfileToStr(p) << " was not acquired\n";
+        return false;
+    }
+    --n;
+    return ApplyLocked(EffectiveLocked());
+}
+
+bool QnnHtpPerfRuntime::SetIdleProfile(QnnHtpPowerProfile p){
+    std::lock_guard<std::mutex> lk(mu_);
+    idle_ = p;
+    return ApplyLocked(EffectiveLocked());
+}
+
+void QnnHtpPerfRuntime::SetRpc(QnnHtpPowerProfile p, const RpcSetting& rpc){
+    std::lock_guard<std::mutex> lk(mu_);
+    rpc_[static_cast<size_t>(p)] = rpc;
+    if (applied_ && current_ == p) applied_ = false;  // re-vote on the next transition
+}
+
+QnnHtpPowerProfile QnnHtpPerfRuntime::Current() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    return current_;
+}
+
+uint64_t QnnHtpPerfRuntime::NumVotes() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    return votes_;
+}
+
+const char* QnnHtpPerfRuntime::ProfileToStr(QnnHtpPowerProfile p){
+    switch (p){
+        case QnnHtpPowerProfile::kPowerSaver: return "power_saver";
+        case QnnHtpPowerProfile::kBalanced: return "balanced";
+        case QnnHtpPowerProfile::kSustained: return "sustained";
+        case QnnHtpPowerProfile::kBurst: return "burst";
+    }
+    return "unknown";
+}
+
+bool QnnHtpPerfRuntime::ProfileFromStr(const std::string& s, QnnHtpPowerProfile* out){
+    if (!out) return false;
+    for (size_t i = 0; i < kNumHtpPowerProfiles; ++i){
+        const auto p = static_cast<QnnHtpPowerProfile>(i);
+        if (s == ProfileToStr(p)){
+            *out = p;
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,210 @@
+#include "qnn_prefix_cache.h"
+
+#include <cstring>
+#include <iostream>
+
+#include "qnn_sharedbuffer.h"
+
+static inline uint64_t Rotl(uint64_t x, int r){ return (x << r) | (x >> (64 - r)); }
+
+// splitmix64 finalizer
+static inline uint64_t Mix64(uint64_t x){
+    x ^= x >> 30; x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27; x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+QnnPrefixKey QnnPrefixCache::Root(uint64_t seed){
+    QnnPrefixKey k;
+    k.hash = Mix64(seed ^ 0x9e3779b97f4a7c15ull);
+    k.check = Mix64(seed + 0x632be59bd9b4e019ull);
+    return k;
+}
+
+QnnPrefixKey QnnPrefixCache::Extend(const QnnPrefixKey& parent, const void* data, size_t bytes){
+    // 4 independent lanes of 8 bytes (embedding rows are KBs per token, one serial chain is too slow),
+    // hash and check use unrelated mixes so a collision in one is not a collision in the other
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    uint64_t h[4], c[4];
+    for (int l = 0; l < 4; ++l){
+        h[l] = parent.hash + (l + 1) * 0x9e3779b97f4a7c15ull;
+        c[l] = parent.check ^ ((l + 1) * 0xc2b2ae3d27d4eb4full);
+    }
+    auto step = [&](int l, uint64_t w){
+        h[l] = Rotl(h[l] ^ (w * 0x87c37b91114253d5ull), 31) * 0x4cf5ad432745937full;
+        c[l] = (c[l] + w) * 0x52dce729da3ed5b5ull;
+    };
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32){
+        uint64_t w[4];
+        std::memcpy(w, p + i, 32);
+        for (int l = 0; l < 4; ++l) step(l, w[l]);
+    }
+    for (int l = 0; i < bytes; i += 8, ++l){
+        uint64_t w = 0;
+        std::memcpy(&w, p + i, bytes - i < 8 ? bytes - i : 8);
+        step(l, w);
+    }
+    uint64_t hh = bytes, cc = ~static_cast<uint64_t>(bytes);
+    for (int l = 0; l < 4; ++l){
+        hh = Mix64(hh ^ h[l]);
+        cc = Mix64(cc + c[l]);
+    }
+    return QnnPrefixKey{hh, cc ^ parent.hash};
+}
+
+bool QnnPrefixCache::Init(size_t chunk_tokens, size_t page_bytes, size_t budget_bytes){
+    if (!chunk_tokens || !page_bytes){
+        std::cerr << "[QNN] PrefixCache: chunk_tokens and page_bytes must be > 0\n";
+        return false;
+    }
+    if (budget_bytes < page_bytes){
+        std::cerr << "[QNN] PrefixCache: budget " << budget_bytes << " is smaller than one page (" << page_bytes << ")\n";
+        return false;
+    }
+    Clear();
+    std::lock_guard<std::mutex> lk(mu_);
+    chunk_tokens_ = chunk_tokens;
+    page_bytes_ = page_bytes;
+    budget_bytes_ = budget_bytes;
+    return true;
+}
+
+QnnPrefixCache::Entry* QnnPrefixCache::FindLocked(const QnnPrefixKey& key){
+    auto it = entries_.find(key.hash);
+    if (it == entries_.end() || it->second.check != key.check) return nullptr;
+    return &it->second;
+}
+
+size_t QnnPrefixCache::Lookup(const std::vector<QnnPrefixKey>& chain, std::vector<const void*>* pages){
+    if (pages) pages->clear();
+    std::lock_guard<std::mutex> lk(mu_);
+    ++lookups_;
+    std::vector<Entry*> hit;
+    hit.reserve(chain.size());
+    for (const QnnPrefixKey& k : chain){
+        Entry* e = FindLocked(k);
+        if (!e) break;
+        hit.push_back(e);
+    }
+    // deepest first, so a parent always ends up more recent than its children
+    for (auto it = hit.rbegin(); it != hit.rend(); ++it){
+        Entry* e = *it;
+        ++e->refs;
+        lru_.splice(lru_.begin(), lru_, e->lru);
+    }
+    if (pages){
+        pages->reserve(hit.size());
+        for (Entry* e : hit) pages->push_back(e->page);
+    }
+    hit_chunks_ += hit.size();
+    miss_chunks_ += chain.size() - hit.size();
+    return hit.size();
+}
+
+void QnnPrefixCache::EraseLocked(std::unordered_map<uint64_t, Entry>::iterator it){
+    Entry& e = it->second;
+    if (e.has_parent){
+        auto p = entries_.find(e.parent);
+        if (p != entries_.end() && p->second.children) --p->second.children;
+    }
+    SharedBuffer::Instance().FreeMem(e.page);
+    bytes_ -= page_bytes_;
+    lru_.erase(e.lru);
+    entries_.erase(it);
+}
+
+bool QnnPrefixCache::EvictOneLocked(){
+    for (auto rit = lru_.rbegin(); rit != lru_.rend(); ++rit){
+        auto it = entries_.find(*rit);
+        if (it->second.refs || it->second.children) continue;
+        EraseLocked(it);
+        ++evictions_;
+        return true;
+    }
+    return false;
+}
+
+void* QnnPrefixCache::Insert(const QnnPrefixKey& parent, const QnnPrefixKey& key){
+    std::lock_guard<std::mutex> lk(mu_);
+    if (!page_bytes_ || entries_.count(key.hash)){
+        // already cached (another request filled it first) or a hash collision: keep the old page
+        ++insert_failures_;
+        return nullptr;
+    }
+    while (bytes_ + page_bytes_ > budget_bytes_){
+        if (!EvictOneLocked()){
+            ++insert_failures_;
+            return nullptr;
+        }
+    }
+    void* page = SharedBuffer::Instance().AllocMem(page_bytes_, 64);
+    if (!page){
+        std::cerr << "[QNN] PrefixCache: AllocMem(" << page_bytes_ << ") failed\n";
+        ++insert_failures_;
+        return nullptr;
+    }
+
+    Entry e;
+    e.check = key.check;
+    e.page = page;
+    e.refs = 1;
+    if (Entry* p = FindLocked(parent)){
+        e.parent = parent.hash;
+        e.has_parent = true;
+        ++p->children;
+    }
+    lru_.push_front(key.hash);
+    e.lru = lru_.begin();
+    entries_.emplace(key.hash, e);
+    bytes_ += page_bytes_;
+    ++inserts_;
+    return page;
+}
+
+void QnnPrefixCache::Unpin(const QnnPrefixKey& key){
+    std::lock_guard<std::mutex> lk(mu_);
+    Entry* e = FindLocked(key);
+    if (!e || e->refs == 0){
+        std::cerr << "[QNN] PrefixCache Unpin: key is not pinned\n";
+        return;
+    }
+    --e->refs;
+}
+
+size_t QnnPrefixCache::Trim(){
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t n = 0;
+    // leaves first; freeing a leaf can turn its parent into one, so repeat until nothing moves
+    while (EvictOneLocked()) ++n;
+    return n;
+}
+
+void QnnPrefixCache::Clear(){
+    std::lock_guard<std::mutex> lk(mu_);
+    size_t pinned = 0;
+    for (auto& kv : entries_){
+        if (kv.second.refs) ++pinned;
+        SharedBuffer::Instance().FreeMem(kv.second.page);
+    }
+    if (pinned) std::cerr << "[QNN] PrefixCache: cleared with " << pinned << " page(s) still pinned\n";
+    entries_.clear();
+    lru_.clear();
+    bytes_ = 0;
+}
+
+QnnPrefixCache::Stats QnnPrefixCache::GetStats() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats st;
+    st.entries = entries_.size();
+    st.bytes = bytes_;
+    for (const auto& kv : entries_) if (kv.second.refs) ++st.pinned;
+    st.lookups = lookups_;
+    st.hit_chunks = hit_chunks_;
+    st.miss_chunks = miss_chunks_;
+    st.inserts = inserts_;
+    st.evictions = evictions_;
+    st.insert_failures = insert_failures_;
+    return st;
+}
@@ -1,4 +1,5 @@
 #include "qnn_profiler.h"
+#include "qnn_trace.h"
 #include "QnnCommon.h"
 #include "QnnInterface.h"
 #include "QnnProfile.h"
@@ -100,6 +101,10 @@ bool QnnProfilerRuntime::Create(const QnnInterface_t* be_iface,
 }
 
 void QnnProfilerRuntime::Destory(){
+    // pending snapshots still need the serialization target
+    StopWriter();
+    FreeSerializationTarget();
+
     if(!be_ || !handle_){
         handle_ = nullptr;
         return;
@@ -110,8 +115,6 @@ void QnnProfilerRuntime::Destory(){
     sys_ = nullptr;
     backend_ = nullptr;
     be_ = nullptr;
-
-    FreeSerializationTarget();
 }
 
 bool QnnProfilerRuntime::CreateSerializationTarget(){
@@ -187,25 +190,149 @@ bool QnnProfilerRuntime::SerializeAfterExecute(const char* graphName) {
   if (!enable_serialization_ || !ser_target_) return true; // serialization 안 쓰면 no-op
   if (!handle_) return false;
 
-  QnnSystemProfile_ProfileData_t pd = QNN_SYSTEM_PROFILE_DATA_INIT;
-  pd.version = QNN_SYSTEM_PROFILE_DATA_VERSION_1;
-  pd.v1.header.methodType = QNN_SYSTEM_PROFILE_METHOD_TYPE_BACKEND_EXECUTE;
-  pd.v1.header.startTime  = NowUs(); // 정확히 execute 전/후 타임스탬프를 잡고싶으면 main에서 넘겨도 됨
-  pd.v1.header.stopTime   = NowUs();
-  pd.v1.header.graphName  = graphName; // nullptr 가능
+  if (!writer_.joinable()) {
+    QnnSystemProfile_ProfileData_t pd = QNN_SYSTEM_PROFILE_DATA_INIT;
+    pd.version = QNN_SYSTEM_PROFILE_DATA_VERSION_1;
+    pd.v1.header.methodType = QNN_SYSTEM_PROFILE_METHOD_TYPE_BACKEND_EXECUTE;
+    pd.v1.header.startTime  = NowUs(); // 정확히 execute 전/후 타임스탬프를 잡고싶으면 main에서 넘겨도 됨
+    pd.v1.header.stopTime   = NowUs();
+    pd.v1.header.graphName  = graphName; // nullptr 가능
+
+    if (!ExtractBackendProfilingInfo(&pd)) {
+      std::cerr << "[QNN] ExtractBackendProfilingInfo failed\n";
+      return false;
+    }
+    return true;
+  }
+
+  // async: snapshot here, serialize + file I/O on the writer thread
+  std::unique_ptr<QnnProfileEventTree> tree = AcquireTree();
+  tree->deep_copy = true;
+  if (!ExtractEventTree(*tree)) {
+    std::cerr << "[QNN] ExtractEventTree failed\n";
+    std::lock_guard<std::mutex> lk(q_mu_);
+    pool_.push_back(std::move(tree));
+    return false;
+  }
+  tree->graph_name = graphName ? graphName : "";
+  tree->start_us = NowUs();
+  tree->stop_us = tree->start_us;
+
+  std::lock_guard<std::mutex> lk(q_mu_);
+  if (queue_.size() >= queue_capacity_) {
+    ++dropped_;
+    pool_.push_back(std::move(tree));
+    return true;
+  }
+  queue_.push_back(std::move(tree));
+  q_cv_.notify_one();
+  return true;
+}
 
-  if (!ExtractBackendProfilingInfo(&pd)) {
-    std::cerr << "[QNN] ExtractBackendProfilingInfo failed\n";
+bool QnnProfilerRuntime::EnableAsyncSerialization(size_t queue_capacity){
+  if (!enable_serialization_ || !ser_target_) {
+    std::cerr << "[QNN] EnableAsyncSerialization: serialization is not enabled\n";
     return false;
   }
+  if (writer_.joinable()) return true;
+  queue_capacity_ = queue_capacity ? queue_capacity : 1;
+  writer_stop_ = false;
+  dropped_ = 0;
+  writer_ = std::thread(&QnnProfilerRuntime::WriterLoop, this);
   return true;
 }
 
-bool QnnProfilerRuntime::ExtractBackendProfilingInfo(QnnSystemProfile_ProfileData_t* profileData){
-    if (!be_ || !sys_ || !ser_target_ || !handle_ || !profileData) return false;
+std::unique_ptr<QnnProfileEventTree> QnnProfilerRuntime::AcquireTree(){
+  {
+    std::lock_guard<std::mutex> lk(q_mu_);
+    if (!pool_.empty()) {
+      std::unique_ptr<QnnProfileEventTree> t = std::move(pool_.back());
+      pool_.pop_back();
+      t->Clear();
+      return t;
+    }
+  }
+  return std::make_unique<QnnProfileEventTree>();
+}
+
+void QnnProfilerRuntime::WriterLoop(){
+  std::unique_lock<std::mutex> lk(q_mu_);
+  while (true) {
+    q_cv_.wait(lk, [this]{ return writer_stop_ || !queue_.empty(); });
+    if (queue_.empty()) break; // stop requested and drained
+
+    std::unique_ptr<QnnProfileEventTree> tree = std::move(queue_.front());
+    queue_.pop_front();
+    writer_busy_ = true;
+    lk.unlock();
+
+    if (!SerializeTree(*tree)) {
+      std::cerr << "[QNN] async serialization failed for " << tree->graph_name << "\n";
+    }
+
+    lk.lock();
+    writer_busy_ = false;
+    pool_.push_back(std::move(tree));
+    if (queue_.empty()) q_idle_cv_.notify_all();
+  }
+}
+
+void QnnProfilerRuntime::FlushSerialization(){
+  if (!writer_.joinable()) return;
+  std::unique_lock<std::mutex> lk(q_mu_);
+  q_idle_cv_.wait(lk, [this]{ return queue_.empty() && !writer_busy_; });
+}
+
+void QnnProfilerRuntime::StopWriter(){
+  if (!writer_.joinable()) return;
+  {
+    std::lock_guard<std::mutex> lk(q_mu_);
+    writer_stop_ = true;
+  }
+  q_cv_.notify_all();
+  writer_.join();
+  if (dropped_) {
+    std::cerr << "[QNN] async serialization dropped " << dropped_ << " snapshots (queue full)\n";
+  }
+  pool_.clear();
+}
+
+std::vector<QnnSystemProfile_ProfileEventV1_t>& QnnProfileEventTree::NextSubVector(){
+  if (arena_used == arena.size()) arena.emplace_back();
+  std::vector<Event>& v = arena[arena_used++];
+  v.clear();
+  return v;
+}
+
+const char* QnnProfileEventTree::CopyString(const char* s){
+  if (!s) return nullptr;
+  if (strings_used == strings.size()) strings.emplace_back();
+  std::string& dst = strings[strings_used++];
+  dst.assign(s);
+  return dst.c_str();
+}
+
+void* QnnProfileEventTree::CopyBytes(const void* p, uint64_t len){
+  if (!p || len == 0) return nullptr;
+  if (blobs_used == blobs.size()) blobs.emplace_back();
+  std::vector<uint8_t>& dst = blobs[blobs_used++];
+  dst.assign(static_cast<const uint8_t*>(p), static_cast<const uint8_t*>(p) + len);
+  return dst.data();
+}
+
+void QnnProfileEventTree::Clear(){
+  top.clear();
+  arena_used = 0;
+  strings_used = 0;
+  blobs_used = 0;
+  graph_name.clear();
+  start_us = stop_us = 0;
+}
+
+bool QnnProfilerRuntime::ExtractEventTree(QnnProfileEventTree& out){
+    if (!be_ || !handle_) return false;
 
     auto& api = be_->QNN_INTERFACE_VER_NAME;
-    auto& sysapi = sys_->QNN_SYSTEM_INTERFACE_VER_NAME;
 
     const QnnProfile_EventId_t* events = nullptr;
     uint32_t numEvents = 0;
@@ -213,21 +340,50 @@ bool QnnProfilerRuntime::ExtractBackendProfilingInfo(QnnSystemProfile_ProfileDat
         return false;
     }
 
-    std::vector<QnnSystemProfile_ProfileEventV1_t> top;
-    std::list<std::vector<QnnSystemProfile_ProfileEventV1_t>> arena; // keep subvector lifetime
-
-    top.reserve(numEvents);
+    out.top.clear();
+    out.arena_used = 0;
+    out.strings_used = 0;
+    out.blobs_used = 0;
+    out.top.reserve(numEvents);
 
     for(uint32_t i=0; i< numEvents; ++i){
         QnnSystemProfile_ProfileEventV1_t e{};
-        if(!ExtractProfileingEvent(events[i], e)) return false;
+        if(!ExtractProfileingEvent(events[i], e, out)) return false;
 
-        if(!ExtractProfilingSubEvents(events[i], e, arena)) return false;
-        top.push_back(e);
+        if(!ExtractProfilingSubEvents(events[i], e, out)) return false;
+        out.top.push_back(e);
     }
+    return true;
+}
 
-    profileData->v1.profilingEvents = top.data();
-    profileData->v1.numProfilingEvents = static_cast<uint32_t>(top.size());
+bool QnnProfilerRuntime::SerializeTree(QnnProfileEventTree& tree){
+    if (!sys_ || !ser_target_) return false;
+    auto& sysapi = sys_->QNN_SYSTEM_INTERFACE_VER_NAME;
+
+    QnnSystemProfile_ProfileData_t pd = QNN_SYSTEM_PROFILE_DATA_INIT;
+    pd.version = QNN_SYSTEM_PROFILE_DATA_VERSION_1;
+    pd.v1.header.methodType = QNN_SYSTEM_PROFILE_METHOD_TYPE_BACKEND_EXECUTE;
+    pd.v1.header.startTime  = tree.start_us;
+    pd.v1.header.stopTime   = tree.stop_us;
+    pd.v1.header.graphName  = tree.graph_name.empty() ? nullptr : tree.graph_name.c_str();
+    pd.v1.profilingEvents = tree.top.data();
+    pd.v1.numProfilingEvents = static_cast<uint32_t>(tree.top.size());
+
+    const QnnSystemProfile_ProfileData_t* arr[1] = {&pd};
+    Qnn_ErrorHandle_t err = sysapi.systemProfileSerializeEventData(ser_target_, arr, 1);
+    return CheckQnnOk(err, "systemProfileSerializeEventData");
+}
+
+bool QnnProfilerRuntime::ExtractBackendProfilingInfo(QnnSystemProfile_ProfileData_t* profileData){
+    if (!be_ || !sys_ || !ser_target_ || !handle_ || !profileData) return false;
+
+    auto& sysapi = sys_->QNN_SYSTEM_INTERFACE_VER_NAME;
+
+    QnnProfileEventTree tree;
+    if (!ExtractEventTree(tree)) return false;
+
+    profileData->v1.profilingEvents = tree.top.data();
+    profileData->v1.numProfilingEvents = static_cast<uint32_t>(tree.top.size());
 
     const QnnSystemProfile_ProfileData_t* arr[1] = {profileData};
     Qnn_ErrorHandle_t err = sysapi.systemProfileSerializeEventData(ser_target_, arr, 1);
@@ -236,8 +392,39 @@ bool QnnProfilerRuntime::ExtractBackendProfilingInfo(QnnSystemProfile_ProfileDat
     return true;
 }
 
+bool QnnProfilerRuntime::AppendToTrace(QnnTraceWriter& trace, const std::string& graph_name, uint64_t exec_start_us){
+    QnnProfileEventTree tree;
+    if (!ExtractEventTree(tree)) return false;
+    trace.AddProfileEvents(graph_name, tree.top.data(), static_cast<uint32_t>(tree.top.size()), exec_start_us);
+    return true;
+}
+
+static bool FindInTree(const QnnSystemProfile_ProfileEventV1_t* events, uint32_t n,
+                       uint32_t event_type, uint64_t* out_value){
+    bool found = false;
+    for (uint32_t i = 0; i < n; ++i){
+        if (events[i].type == QNN_SYSTEM_PROFILE_EVENT_DATA && events[i].eventData.type == event_type){
+            *out_value = events[i].eventData.value;
+            found = true;
+        }
+        if (events[i].profileSubEventData &&
+            FindInTree(events[i].profileSubEventData, events[i].numSubEvents, event_type, out_value)){
+            found = true;
+        }
+    }
+    return found;
+}
+
+bool QnnProfilerRuntime::FindEventValue(uint32_t event_type, uint64_t* out_value){
+    if (!out_value) return false;
+    QnnProfileEventTree tree;
+    if (!ExtractEventTree(tree)) return false;
+    return FindInTree(tree.top.data(), static_cast<uint32_t>(tree.top.size()), event_type, out_value);
+}
+
 bool QnnProfilerRuntime::ExtractProfileingEvent(QnnProfile_EventId_t profileEventId, 
-                                        QnnSystemProfile_ProfileEventV1_t& out ){
+                                        QnnSystemProfile_ProfileEventV1_t& out,
+                                        QnnProfileEventTree& tree){
     if (!be_) return false;
     auto& api = be_->QNN_INTERFACE_VER_NAME;
 
@@ -245,6 +432,7 @@ bool QnnProfilerRuntime::ExtractProfileingEvent(QnnProfile_EventId_t profileEven
     if(!CheckQnnOk(api.profileGetEventData(profileEventId, &ed), "profileGetEventData")) return false;
 
     if(ed.unit != QNN_PROFILE_EVENTUNIT_OBJECT){
+        if (tree.deep_copy) ed.identifier = tree.CopyString(ed.identifier);
         out.type = QNN_SYSTEM_PROFILE_EVENT_DATA;
         out.eventData = ed;
         out.profileSubEventData = nullptr;
@@ -254,6 +442,15 @@ bool QnnProfilerRuntime::ExtractProfileingEvent(QnnProfile_EventId_t profileEven
         QnnProfile_ExtendedEventData_t xd = QNN_PROFILE_EXTENDED_EVENT_DATA_INIT;
         if(!CheckQnnOk(api.profileGetExtendedEventData(profileEventId, &xd), "profileGetExtendedEventData")) return false;
 
+        if (tree.deep_copy){
+            auto& v = xd.v1;
+            v.identifier = tree.CopyString(v.identifier);
+            if (v.unit == QNN_PROFILE_EVENTUNIT_OBJECT){
+                v.backendOpaqueObject.fileName = tree.CopyString(v.backendOpaqueObject.fileName);
+                v.backendOpaqueObject.opaqueObject.data =
+                    tree.CopyBytes(v.backendOpaqueObject.opaqueObject.data, v.backendOpaqueObject.opaqueObject.len);
+            }
+        }
         out.type = QNN_SYSTEM_PROFILE_EXTENDED_EVENT_DATA;
         out.extendedEventData = xd;
         out.profileSubEventData = nullptr;
@@ -264,7 +461,7 @@ bool QnnProfilerRuntime::ExtractProfileingEvent(QnnProfile_EventId_t profileEven
 
 bool QnnProfilerRuntime::ExtractProfilingSubEvents(QnnProfile_EventId_t profileEventId,
     QnnSystemProfile_ProfileEventV1_t& parent,
-    std::list<std::vector<QnnSystemProfile_ProfileEventV1_t>>& arena){
+    QnnProfileEventTree& tree){
     if (!be_) return false;
     auto& api = be_->QNN_INTERFACE_VER_NAME;
 
@@ -272,27 +469,27 @@ bool QnnProfilerRuntime::ExtractProfilingSubEvents(QnnProfile_EventId_t profileE
     uint32_t numSub = 0;
 
     Qnn_ErrorHandle_t err = api.profileGetSubEvents(profileEventId, &sub, &numSub);
-    if (err != QNN_SUCCESS){
+    if (err != QNN_SUCCESS || numSub == 0){
         parent.profileSubEventData = nullptr;
         parent.numSubEvents = 0;
         return true;
     }
 
-    std::vector<QnnSystemProfile_ProfileEventV1_t> vec;
+    // pooled slot; children take their own slots while recursing
+    std::vector<QnnSystemProfile_ProfileEventV1_t>& vec = tree.NextSubVector();
     vec.reserve(numSub);
 
     for(uint32_t i = 0; i< numSub; ++i){
         QnnSystemProfile_ProfileEventV1_t child{};
-        if(!ExtractProfileingEvent(sub[i], child)) return false;
+        if(!ExtractProfileingEvent(sub[i], child, tree)) return false;
 
         // recursive
-        if(!ExtractProfilingSubEvents(sub[i], child, arena)) return false;
+        if(!ExtractProfilingSubEvents(sub[i], child, tree)) return false;
         vec.push_back(child);
     }
 
-    arena.push_back(std::move(vec));
-    parent.profileSubEventData = arena.back().data();
-    parent.numSubEvents = static_cast<uint32_t>(arena.back().size());
+    parent.profileSubEventData = vec.data();
+    parent.numSubEvents = static_cast<uint32_t>(vec.size());
     return true;
 }
 
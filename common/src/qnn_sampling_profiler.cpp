@@ -0,0 +1,120 @@
+#include "qnn_sampling_profiler.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include "QnnProfile.h"
+#include "HTP/QnnHtpProfile.h"
+
+bool QnnSamplingProfilerRuntime::Create(const QnnInterface_t* be_iface,
+                                        const QnnSystemInterface_t* sys_iface,
+                                        Qnn_BackendHandle_t backend_handle,
+                                        QnnProfileLevel light_level, uint32_t every_n){
+    if (light_level != QnnProfileLevel::Off && light_level != QnnProfileLevel::Basic){
+        std::cerr << "[QNN] SamplingProfiler: light level must be Off or Basic\n";
+        return false;
+    }
+    if (!light_.Create(be_iface, sys_iface, backend_handle, light_level, /*enable_serialization=*/false, "")){
+        std::cerr << "[QNN] SamplingProfiler: light profiler create failed\n";
+        return false;
+    }
+    be_ = be_iface;
+    sys_ = sys_iface;
+    backend_ = backend_handle;
+    every_n_ = every_n;
+    calls_ = 0;
+    sampled_ = 0;
+    last_detailed_ = nullptr;
+    graphs_.clear();
+    return true;
+}
+
+void QnnSamplingProfilerRuntime::Destroy(){
+    graphs_.clear();
+    last_detailed_ = nullptr;
+    light_.Destory();
+}
+
+Qnn_ProfileHandle_t QnnSamplingProfilerRuntime::NextHandle(const std::string& graph_name){
+    ++calls_;
+    GraphState& g = graphs_[graph_name];
+    ++g.calls;
+    const bool forced = force_detailed_.exchange(false, std::memory_order_relaxed);
+    last_detailed_ = nullptr;
+    if (!forced && (every_n_ == 0 || g.calls % every_n_ != 0)) return light_.GetProfiler();
+
+    if (!g.detailed && !g.detailed_failed){
+        g.detailed = std::make_unique<QnnProfilerRuntime>();
+        if (!g.detailed->Create(be_, sys_, backend_, QnnProfileLevel::Detailed, /*enable_serialization=*/false, "")){
+            std::cerr << "[QNN] SamplingProfiler: detailed profiler create failed for " << graph_name << "\n";
+            g.detailed.reset();
+            g.detailed_failed = true;
+        }
+    }
+    if (!g.detailed) return light_.GetProfiler();
+    last_detailed_ = &g;
+    return g.detailed->GetProfiler();
+}
+
+bool QnnSamplingProfilerRuntime::AfterExecute(const std::string& graph_name){
+    if (!last_detailed_) return true;
+    GraphState& g = *last_detailed_;
+    last_detailed_ = nullptr;
+
+    QnnProfileEventTree tree;
+    if (!g.detailed->ExtractEventTree(tree)) return false;
+
+    // handle reset per execute => size does not grow, take everything
+    const size_t begin = tree.top.size() > g.seen_top ? g.seen_top : 0;
+    g.seen_top = tree.top.size();
+
+    std::lock_guard<std::mutex> lk(mu_);
+    Accumulate(graph_name, tree.top.data() + begin, static_cast<uint32_t>(tree.top.size() - begin));
+    ++sampled_;
+    return true;
+}
+
+void QnnSamplingProfilerRuntime::Accumulate(const std::string& graph_name,
+                                            const QnnSystemProfile_ProfileEventV1_t* events, uint32_t n){
+    for (uint32_t i = 0; i < n; ++i){
+        const auto& ev = events[i];
+        if (ev.type == QNN_SYSTEM_PROFILE_EVENT_DATA){
+            const auto& ed = ev.eventData;
+            // per-op nodes + execute-level totals; object/opaque payloads are skipped
+            const bool is_node = ed.type == QNN_PROFILE_EVENTTYPE_NODE;
+            const bool is_total = ed.type == QNN_PROFILE_EVENTTYPE_EXECUTE ||
+                                  (ed.type >= QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_HOST_RPC_TIME_MICROSEC &&
+                                   ed.type <= QNN_HTP_PROFILE_EVENTTYPE_GRAPH_NUMBER_OF_HVX_THREADS);
+            if ((is_node || is_total) && ed.unit != QNN_PROFILE_EVENTUNIT_OBJECT){
+                const std::string op = (is_node && ed.identifier && ed.identifier[0])
+                                           ? std::string(ed.identifier)
+                                           : std::string(QnnProfilerRuntime::TypeToStr(ed.type));
+                OpStat& st = stats_[graph_name + "/" + op];
+                st.count++;
+                st.sum += ed.value;
+                st.min = std::min<uint64_t>(st.min, ed.value);
+                st.max = std::max<uint64_t>(st.max, ed.value);
+                st.unit = ed.unit;
+            }
+        }
+        if (ev.profileSubEventData) Accumulate(graph_name, ev.profileSubEventData, ev.numSubEvents);
+    }
+}
+
+void QnnSamplingProfilerRuntime::Dump(std::ostream& os) const{
+    std::lock_guard<std::mutex> lk(mu_);
+    os << "[QNN] sampled per-op stats: " << sampled_ << "/" << calls_ << " executes\n";
+    for (const auto& kv : stats_){
+        const OpStat& st = kv.second;
+        os << "  " << kv.first << " n=" << st.count
+           << " mean=" << (st.count ? st.sum / st.count : 0)
+           << " min=" << st.min << " max=" << st.max
+           << " (" << QnnProfilerRuntime::UnitToStr(st.unit) << ")\n";
+    }
+}
+
+void QnnSamplingProfilerRuntime::ResetStats(){
+    std::lock_guard<std::mutex> lk(mu_);
+    stats_.clear();
+    sampled_ = 0;
+}
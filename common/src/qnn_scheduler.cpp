@@ -0,0 +1,205 @@
+#include "qnn_scheduler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+
+static uint64_t NowUs(){
+    using namespace std::chrono;
+    return static_cast<uint64_t>(duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count());
+}
+
+bool QnnBatchScheduler::Init(const std::vector<QnnStepGraph>& graphs, const Options& opt){
+    bool has_decode = false, has_prefill = false;
+    for (const QnnStepGraph& g : graphs){
+        if (!g.batch || !g.tokens){
+            std::cerr << "[QNN] Scheduler: graph " << g.name << " has an empty batch/tokens dim\n";
+            return false;
+        }
+        (g.tokens == 1 ? has_decode : has_prefill) = true;
+    }
+    if (!has_decode || !has_prefill){
+        std::cerr << "[QNN] Scheduler: needs a decode graph (tokens == 1) and a prefill graph (tokens > 1)\n";
+        return false;
+    }
+    if (!opt.max_running || !opt.max_step_tokens){
+        std::cerr << "[QNN] Scheduler: max_running and max_step_tokens must be > 0\n";
+        return false;
+    }
+    std::lock_guard<std::mutex> lk(mu_);
+    graphs_ = graphs;
+    opt_ = opt;
+    return true;
+}
+
+uint64_t QnnBatchScheduler::Submit(uint32_t prompt_tokens, uint32_t max_new_tokens){
+    if (!prompt_tokens) return 0;
+    std::lock_guard<std::mutex> lk(mu_);
+    Seq s;
+    s.id = next_id_++;
+    s.prompt = prompt_tokens;
+    s.max_new = std::max<uint32_t>(max_new_tokens, 1);  // the last prefill chunk always yields one token
+    s.submit_us = NowUs();
+    queue_.push_back(s);
+    ++submitted_;
+    return s.id;
+}
+
+QnnBatchScheduler::Seq* QnnBatchScheduler::FindRunning(uint64_t id){
+    for (Seq& s : running_) if (s.id == id) return &s;
+    return nullptr;
+}
+
+size_t QnnBatchScheduler::PickGraph(bool decode, uint32_t need) const{
+    size_t fit = SIZE_MAX, largest = SIZE_MAX;
+    auto size_of = [&](size_t i){ return decode ? graphs_[i].batch : graphs_[i].tokens; };
+    // prefill: equal tokens => the larger batch, later rows of an open launch are free
+    auto better = [&](size_t a, size_t b, bool smaller){
+        if (size_of(a) != size_of(b)) return smaller ? size_of(a) < size_of(b) : size_of(a) > size_of(b);
+        return !decode && graphs_[a].batch > graphs_[b].batch;
+    };
+    for (size_t i = 0; i < graphs_.size(); ++i){
+        if ((graphs_[i].tokens == 1) != decode) continue;
+        if (size_of(i) >= need && (fit == SIZE_MAX || better(i, fit, true))) fit = i;
+        if (largest == SIZE_MAX || better(i, largest, false)) largest = i;
+    }
+    return fit != SIZE_MAX ? fit : largest;
+}
+
+bool QnnBatchScheduler::Schedule(QnnStepPlan* plan){
+    *plan = QnnStepPlan{};
+    std::lock_guard<std::mutex> lk(mu_);
+    if (graphs_.empty() || (queue_.empty() && running_.empty())) return false;
+
+    uint64_t budget = opt_.max_step_tokens;
+    auto charge = [&](const QnnStepGraph& g){
+        const uint64_t cost = static_cast<uint64_t>(g.batch) * g.tokens;
+        budget = budget > cost ? budget - cost : 0;
+    };
+
+    // 1) one decode token for every sequence past its prompt, packed into decode buckets
+    std::vector<const Seq*> decoding;
+    for (const Seq& s : running_) if (s.prefilled == s.prompt) decoding.push_back(&s);
+    for (size_t i = 0; i < decoding.size();){
+        const size_t g = PickGraph(true, static_cast<uint32_t>(decoding.size() - i));
+        QnnStepLaunch l;
+        l.graph = g;
+        l.decode = true;
+        for (uint32_t r = 0; r < graphs_[g].batch && i < decoding.size(); ++r, ++i){
+            const Seq& s = *decoding[i];
+            l.rows.push_back(QnnStepRow{s.id, s.prompt + s.generated - 1, 1});
+        }
+        charge(graphs_[g]);
+        plan->launches.push_back(std::move(l));
+    }
+
+    // 2) prefill chunks with what is left: prompts in flight first, then admit from the queue
+    std::vector<size_t> open(graphs_.size(), SIZE_MAX);  // graph -> prefill launch with free rows
+    auto add_chunk = [&](const Seq& s) -> bool {
+        const uint32_t left = s.prompt - s.prefilled;
+        const size_t g = PickGraph(false, left);
+        size_t li = open[g];
+        if (li == SIZE_MAX){
+            // over budget: stop here (FIFO), unless the step would otherwise be empty
+            const uint64_t cost = static_cast<uint64_t>(graphs_[g].batch) * graphs_[g].tokens;
+            if (cost > budget && !plan->launches.empty()) return false;
+            charge(graphs_[g]);
+            li = plan->launches.size();
+            plan->launches.push_back(QnnStepLaunch{g, false, {}});
+            open[g] = li;
+        }
+        QnnStepLaunch& l = plan->launches[li];
+        l.rows.push_back(QnnStepRow{s.id, s.prefilled, std::min(left, graphs_[g].tokens)});
+        if (l.rows.size() == graphs_[g].batch) open[g] = SIZE_MAX;
+        return true;
+    };
+    bool full = false;
+    for (const Seq& s : running_){
+        if (s.prefilled == s.prompt) continue;
+        if (!add_chunk(s)){
+            full = true;
+            break;
+        }
+    }
+    while (!full && !queue_.empty() && running_.size() < opt_.max_running){
+        if (!add_chunk(queue_.front())) break;
+        running_.push_back(queue_.front());
+        queue_.pop_front();
+    }
+
+    for (const QnnStepLaunch& l : plan->launches){
+        const QnnStepGraph& g = graphs_[l.graph];
+        uint32_t used = 0;
+        for (const QnnStepRow& r : l.rows) used += r.n;
+        (l.decode ? plan->decode_tokens : plan->prefill_tokens) += used;
+        plan->padded_tokens += g.batch * g.tokens - used;
+    }
+    // admission is bounded by max_running, so a non-empty state always yields a launch
+    return !plan->launches.empty();
+}
+
+void QnnBatchScheduler::Complete(const QnnStepPlan& plan){
+    std::lock_guard<std::mutex> lk(mu_);
+    const uint64_t now = NowUs();
+    uint64_t rows = 0;
+    for (const QnnStepLaunch& l : plan.launches){
+        rows += l.rows.size();
+        for (const QnnStepRow& r : l.rows){
+            Seq* s = FindRunning(r.id);
+            if (!s){
+                std::cerr << "[QNN] Scheduler: completed row for unknown sequence " << r.id << "\n";
+                continue;
+            }
+            if (l.decode){
+                ++s->generated;
+                continue;
+            }
+            s->prefilled += r.n;
+            if (s->prefilled == s->prompt){
+                // logits of the last prompt token = first generated token
+                s->generated = 1;
+                ttft_.Record(now - s->submit_us);
+            }
+        }
+    }
+
+    // finished sequences leave right away; their slot is free for the next Schedule()
+    auto done = [&](const Seq& s){
+        if (s.generated < s.max_new) return false;
+        e2e_.Record(now - s.submit_us);
+        ++finished_;
+        return true;
+    };
+    running_.erase(std::remove_if(running_.begin(), running_.end(), done), running_.end());
+
+    ++steps_;
+    launches_ += plan.launches.size();
+    decode_tokens_ += plan.decode_tokens;
+    prefill_tokens_ += plan.prefill_tokens;
+    padded_tokens_ += plan.padded_tokens;
+    max_batch_ = std::max(max_batch_, rows);
+}
+
+bool QnnBatchScheduler::Idle() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    return queue_.empty() && running_.empty();
+}
+
+QnnBatchScheduler::Stats QnnBatchScheduler::GetStats() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    Stats st;
+    st.submitted = submitted_;
+    st.finished = finished_;
+    st.queued = queue_.size();
+    st.running = running_.size();
+    st.steps = steps_;
+    st.launches = launches_;
+    st.decode_tokens = decode_tokens_;
+    st.prefill_tokens = prefill_tokens_;
+    st.padded_tokens = padded_tokens_;
+    st.max_batch = max_batch_;
+    st.ttft_us = ttft_.Snap();
+    st.e2e_us = e2e_.Snap();
+    return st;
+}
@@ -0,0 +1,218 @@
+#include "qnn_shard.h"
+
+#include <chrono>
+#include <iostream>
+
+#include "qnn_latency.h"
+#include "qnn_tensor.h"
+
+static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what){
+    if (err != QNN_SUCCESS){
+        std::cerr << "[QNN] " << what << " failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
+        return false;
+    }
+    return true;
+}
+
+bool QnnShardedModelRuntime::Init(const QnnInterface_t* be,
+                                  const QnnSystemInterface_t* sys_iface,
+                                  Qnn_BackendHandle_t backend_handle,
+                                  Qnn_DeviceHandle_t device_handle,
+                                  Qnn_ProfileHandle_t profile_handle,
+                                  const std::vector<std::string>& paths,
+                                  SharedBuffer& sb, SharedBuffer::Arena& arena,
+                                  const Options& opt){
+    if (!be || !sys_iface || !backend_handle || paths.empty()){
+        std::cerr << "[QNN] Shard Init: invalid be/sys/backend/paths\n";
+        return false;
+    }
+    Destroy();
+
+    be_ = be;
+    sys_ = sys_iface;
+    backend_ = backend_handle;
+    device_ = device_handle;
+    profile_ = profile_handle;
+    opt_ = opt;
+    sb_ = &sb;
+    arena_ = &arena;
+
+    // shards_ must not reallocate once loads run on other threads
+    shards_.resize(paths.size());
+    for (size_t i = 0; i < paths.size(); ++i) shards_[i].path = paths[i];
+
+    // shard 0 decides the hidden size; slices are allocated inside Load(0)
+    if (!Load(0)) return false;
+
+    std::cout << "[QNN] Shard: " << shards_.size() << " shards, hidden bytes=" << hidden_bytes_
+              << " prefetch=" << opt_.prefetch << " keep_resident=" << opt_.keep_resident << "\n";
+    return true;
+}
+
+void* QnnShardedModelRuntime::SlicePtr(size_t slot) const{
+    if (!arena_ || !arena_->base || hidden_bytes_ == 0) return nullptr;
+    return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(arena_->base) + slice_off_[slot]);
+}
+
+bool QnnShardedModelRuntime::Load(size_t i){
+    Shard& s = shards_[i];
+    if (s.loaded) return true;
+
+    const auto t0 = std::chrono::steady_clock::now();
+
+    s.file = std::make_unique<QnnMappedFile>();
+    if (!s.file->Open(s.path, /*will_need=*/true)) return false;
+
+    QnnContextBinary blob;
+    blob.buffer = s.file->Data();
+    blob.nbytes = static_cast<uint32_t>(s.file->Size());
+
+    s.cache = std::make_unique<HtpBackendCacheRuntime>();
+    if (!s.cache->Create(sys_, blob)){
+        std::cerr << "[QNN] Shard: backend cache parse failed for " << s.path << "\n";
+        return false;
+    }
+    if (s.cache->GraphNames().size() != 1){
+        std::cerr << "[QNN] Shard: expected one graph in " << s.path
+                  << ", got " << s.cache->GraphNames().size() << "\n";
+        return false;
+    }
+    const std::string graph_name = s.cache->GraphNames()[0];
+
+    // no profiler here: prefetch runs concurrently with graphExecute on the shared profile handle
+    s.ctx = std::make_unique<QnnContextRuntime>();
+    if (!s.ctx->CreateFromBinary(be_, backend_, device_, /*profileHandle=*/nullptr,
+                                 s.file->Data(), static_cast<uint32_t>(s.file->Size()))){
+        std::cerr << "[QNN] Shard: contextCreateFromBinary failed for " << s.path << "\n";
+        return false;
+    }
+
+    s.graph = std::make_unique<QnnGraphRuntime>();
+    s.graph->SetRestoreMode(true);
+    if (!s.graph->Create(be_, s.ctx->Handle(), profile_, graph_name)){
+        std::cerr << "[QNN] Shard: graphRetrieve failed for " << graph_name << "\n";
+        return false;
+    }
+
+    s.io = s.cache->MakeBinding(graph_name);
+    // binding owns the IO meta, the parsed binary info is not needed anymore
+    s.cache.reset();
+    if (s.io.inputs.size() != 1 || s.io.outputs.size() != 1){
+        std::cerr << "[QNN] Shard: " << graph_name << " must have exactly one input and one output\n";
+        return false;
+    }
+    const size_t in_bytes = QnnTensor::MetaBytes(s.io.inputs[0]);
+    const size_t out_bytes = QnnTensor::MetaBytes(s.io.outputs[0]);
+    if (in_bytes == 0 || in_bytes != out_bytes){
+        std::cerr << "[QNN] Shard: " << graph_name << " in/out bytes mismatch ("
+                  << in_bytes << " vs " << out_bytes << ")\n";
+        return false;
+    }
+
+    if (hidden_bytes_ == 0){
+        // first load (synchronous, from Init): carve the ping-pong slices
+        void* p = nullptr;
+        for (size_t slot = 0; slot < 2; ++slot){
+            if (!sb_->ArenaAlloc(*arena_, in_bytes, 64, &p, &slice_off_[slot])){
+                std::cerr << "[QNN] Shard: arena too small for hidden slices\n";
+                return false;
+            }
+        }
+        hidden_bytes_ = in_bytes;
+    } else if (in_bytes != hidden_bytes_){
+        std::cerr << "[QNN] Shard: " << graph_name << " hidden bytes " << in_bytes
+                  << " != " << hidden_bytes_ << "\n";
+        return false;
+    }
+
+    s.mem = std::make_unique<QnnMemManagerRuntime>();
+    if (!s.mem->Init(be_, s.ctx.get())) return false;
+
+    void* ptr = nullptr;
+    Qnn_MemHandle_t h = nullptr;
+    if (!s.mem->RegisterTensorAtArenaOffset(*arena_, s.io.inputs[0], slice_off_[i % 2], &ptr, &h)) return false;
+    if (!s.mem->RegisterTensorAtArenaOffset(*arena_, s.io.outputs[0], slice_off_[(i + 1) % 2], &ptr, &h)) return false;
+
+    s.loaded = true;
+
+    const auto t1 = std::chrono::steady_clock::now();
+    std::cout << "[QNN] Shard[" << i << "] loaded " << graph_name << " (" << s.file->Size() << " bytes) in "
+              << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+    return true;
+}
+
+void QnnShardedModelRuntime::Unload(size_t i){
+    Shard& s = shards_[i];
+    // mem handles -> graph -> context -> binary info -> mapping
+    s.mem.reset();
+    s.graph.reset();
+    s.ctx.reset();
+    s.cache.reset();
+    s.file.reset();
+    s.io = QnnGraphBinding();
+    s.loaded = false;
+}
+
+bool QnnShardedModelRuntime::Execute(size_t i){
+    Shard& s = shards_[i];
+    auto& api = be_->QNN_INTERFACE_VER_NAME;
+    Qnn_ProfileHandle_t ph = sampler_ ? sampler_->NextHandle(s.graph->Name()) : profile_;
+    Qnn_ErrorHandle_t err = api.graphExecute(
+        s.graph->Handle(),
+        s.io.inputs.data(), static_cast<uint32_t>(s.io.inputs.size()),
+        s.io.outputs.data(), static_cast<uint32_t>(s.io.outputs.size()),
+        /*profile=*/ph, /*signal=*/nullptr);
+    if (!CheckQnnOk(err, "graphExecute(shard)")) return false;
+    if (sampler_ && !sampler_->AfterExecute(s.graph->Name())){
+        std::cerr << "[QNN] Shard: sampled profile extraction failed\n";
+    }
+    return true;
+}
+
+bool QnnShardedModelRuntime::Run(){
+    if (shards_.empty() || hidden_bytes_ == 0){
+        std::cerr << "[QNN] Shard Run: not initialized\n";
+        return false;
+    }
+
+    for (size_t i = 0; i < shards_.size(); ++i){
+        if (pending_.valid() && pending_idx_ == i){
+            if (!pending_.get()) return false;
+        }
+        if (!shards_[i].loaded && !Load(i)) return false;
+
+        const size_t next = i + 1;
+        if (opt_.prefetch && next < shards_.size() && !shards_[next].loaded){
+            pending_idx_ = next;
+            pending_ = std::async(std::launch::async, [this, next]{ return Load(next); });
+        }
+
+        const auto t0 = std::chrono::steady_clock::now();
+        const bool ok = Execute(i);
+        const auto t1 = std::chrono::steady_clock::now();
+        QnnLatencyRegistry::Instance().Get(shards_[i].graph->Name()).wall_us.Record(
+            static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0).count()));
+        std::cout << "[QNN] Shard[" << i << "] execute "
+                  << std::chrono::duration<double, std::milli>(t1 - t0).count() << " ms\n";
+        if (!ok){
+            if (pending_.valid()) pending_.wait();
+            return false;
+        }
+
+        if (!opt_.keep_resident) Unload(i);
+    }
+    return true;
+}
+
+void QnnShardedModelRuntime::Destroy(){
+    if (pending_.valid()) pending_.wait();
+    pending_ = std::future<bool>();
+    for (size_t i = shards_.size(); i > 0; --i) Unload(i - 1);
+    shards_.clear();
+
+    // slices live in the caller's arena; nothing to free here
+    sb_ = nullptr;
+    arena_ = nullptr;
+    hidden_bytes_ = 0;
+    slice_off_[0] = slice_off_[1] = 0;
+}
@@ -1,6 +1,9 @@
 #include "qnn_sharedbuffer.h"
+#include "qnn_mem_telemetry.h"
+#include "qnn_runtime_gate.h"
 
 #include <cstdint>
+#include <cstdlib>
 #include <dlfcn.h>
 #include <iostream>
 #include <mutex>
@@ -10,7 +13,7 @@ static inline size_t align_up(size_t x, size_t a){
 }
 
 bool SharedBuffer::ArenaCreate(Arena& a, size_t total_bytes, size_t alignment){
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
     (void) a; (void) total_bytes; (void) alignment;
     return false;
 #else
@@ -36,12 +39,13 @@ bool SharedBuffer::ArenaCreate(Arena& a, size_t total_bytes, size_t alignment){
     a.total = total;
     a.cursor = 0;
     a.alignment = alignment;
+    QnnMemTelemetry::Instance().OnArenaCreate(base, total);
     return true;
 #endif
 }
 
 bool SharedBuffer::ArenaAlloc(Arena& a, size_t bytes, size_t alignment, void** out_ptr, size_t* out_offset){
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)a; (void) bytes; (void) alignment; (void) out_ptr; (void) out_offset;
   return false;
 #else
@@ -57,16 +61,21 @@ bool SharedBuffer::ArenaAlloc(Arena& a, size_t bytes, size_t alignment, void** o
   *out_offset = off;
   *out_ptr = reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(a.base) + off);
 
+  const size_t padding = off > a.cursor ? off - a.cursor : 0;
   a.cursor = off + bytes;
+  QnnMemTelemetry::Instance().OnArenaAlloc(a.base, a.cursor, padding);
   return true;
 #endif
 }
 
 void SharedBuffer::ArenaDestroy(Arena& a){
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   a = Arena();
 #else
-  if (a.base) FreeMem(a.base);
+  if (a.base){
+    QnnMemTelemetry::Instance().OnArenaDestroy(a.base);
+    FreeMem(a.base);
+  }
   a = Arena();
 #endif
 }
@@ -83,25 +92,52 @@ namespace{
 
 std::mutex SharedBuffer::init_mutex_;
 
+// freed blocks of one thread, reused by exact size (no lock contention on the hot path:
+// only the owning thread touches it, except a drain from Trim() / Unload())
+struct SharedBuffer::ThreadCache{
+    std::atomic<SharedBuffer*> owner{nullptr};
+    std::mutex mu;
+    std::array<Block, kThreadCacheSlots> slots;
+    size_t n{0};
+
+    ~ThreadCache(){
+        // unregistered (drained) caches are always empty: FreeMem only parks blocks while owner is set
+        SharedBuffer* o = owner.load();
+        if (!o) return;
+        std::lock_guard<std::mutex> lk(o->caches_mu_);
+        if (!owner.load()) return;  // already drained by Unload()
+        auto& v = o->caches_;
+        for (size_t i = 0; i < v.size(); ++i){
+            if (v[i] == this){ v[i] = v.back(); v.pop_back(); break; }
+        }
+        std::lock_guard<std::mutex> lk2(mu);
+        for (size_t i = 0; i < n; ++i) o->ReleaseBlock(slots[i]);
+        n = 0;
+    }
+};
+
 SharedBuffer& SharedBuffer::Instance(){
-    std::lock_guard<std::mutex> lk(init_mutex_);
     static SharedBuffer sb;
-    if(!sb.initialized_.load()){
-#if defined(__aarch64__)
+    // fast path: no lock once rpcmem is loaded
+    if (sb.initialized_.load(std::memory_order_acquire)) return sb;
+
+    std::lock_guard<std::mutex> lk(init_mutex_);
+    if(!sb.initialized_.load(std::memory_order_relaxed)){
+#if QNN_RUNTIME_ENABLED
         if(! sb.Load()){
             std::cerr << "[QNN] SharedBuffer: Load Failed\n";
         } else{
-            sb.initialized_.store(true);
+            sb.initialized_.store(true, std::memory_order_release);
         }
-#else
-        sb.initialized_.store(false);
 #endif
     }
     return sb;
 }
 
 SharedBuffer::~SharedBuffer(){
-#if defined(__aarch64__)
+    // at exit the backend may already be gone; handles die with the process anyway
+    fd_release_hook_.store(nullptr);
+#if QNN_RUNTIME_ENABLED
     if(initialized_.load()){
         Unload();
         initialized_.store(false);
@@ -110,9 +146,12 @@ SharedBuffer::~SharedBuffer(){
 }
 
 bool SharedBuffer::Load(){
-    lib_cdsp_rpc_ = dlopen("libcdsprpc.so", RTLD_NOW | RTLD_LOCAL);
+    // QNN_RPCMEM_LIB: rpcmem_* provider override (null backend exports a memfd based one)
+    const char* env_lib = std::getenv("QNN_RPCMEM_LIB");
+    const char* lib = (env_lib && *env_lib) ? env_lib : "libcdsprpc.so";
+    lib_cdsp_rpc_ = dlopen(lib, RTLD_NOW | RTLD_LOCAL);
     if (!lib_cdsp_rpc_){
-        std::cerr << "[QNN] dlopen(libcdsprpc.so) failed : " << dlerror() << "\n";
+        std::cerr << "[QNN] dlopen(" << lib << ") failed : " << dlerror() << "\n";
         return false;
     }
 
@@ -130,6 +169,11 @@ bool SharedBuffer::Load(){
 }
 
 void SharedBuffer::Unload() {
+  Trim(0);
+  for (auto& sh : shards_){
+    std::lock_guard<std::mutex> lk(sh.mu);
+    sh.blocks.clear();
+  }
   if (lib_cdsp_rpc_) {
     dlclose(lib_cdsp_rpc_);
     lib_cdsp_rpc_ = nullptr;
@@ -137,100 +181,265 @@ void SharedBuffer::Unload() {
   rpc_mem_alloc_ = nullptr;
   rpc_mem_free_ = nullptr;
   rpc_mem_to_fd_ = nullptr;
-  restore_map_.clear();
-  allocated_size_map_.clear();
+}
+
+SharedBuffer::ThreadCache& SharedBuffer::LocalCache(){
+  thread_local ThreadCache tc;
+  if (!tc.owner.load(std::memory_order_relaxed)){
+    std::lock_guard<std::mutex> lk(caches_mu_);
+    caches_.push_back(&tc);
+    tc.owner.store(this);
+  }
+  return tc;
+}
+
+size_t SharedBuffer::DrainThreadCaches(){
+  // a drained thread re-registers its cache on its next alloc/free
+  size_t released = 0;
+  std::lock_guard<std::mutex> lk(caches_mu_);
+  for (ThreadCache* c : caches_){
+    std::lock_guard<std::mutex> lk2(c->mu);
+    for (size_t i = 0; i < c->n; ++i){
+      released += c->slots[i].bytes;
+      ReleaseBlock(c->slots[i]);
+    }
+    c->n = 0;
+    c->owner.store(nullptr);
+  }
+  caches_.clear();
+  return released;
+}
+
+int SharedBuffer::SizeClassOf(size_t bytes){
+  constexpr size_t kMin = size_t(1) << 12;
+  if (bytes <= kMin) return 0;
+  // 2^e < bytes <= 2^(e+1), steps of 2^e / 4
+  const int e = 63 - __builtin_clzll(static_cast<unsigned long long>(bytes - 1));
+  const size_t base = size_t(1) << e;
+  const size_t step = base >> 2;
+  const size_t i = (bytes - base + step - 1) / step;  // 1..4
+  const int cls = 1 + (e - 12) * 4 + static_cast<int>(i - 1);
+  return cls < kNumSizeClasses ? cls : -1;
+}
+
+size_t SharedBuffer::SizeClassBytes(int cls){
+  if (cls <= 0) return size_t(1) << 12;
+  const int k = cls - 1;
+  const size_t base = size_t(1) << (12 + k / 4);
+  return base + static_cast<size_t>(k % 4 + 1) * (base >> 2);
+}
+
+bool SharedBuffer::PoolPut(const Block& b){
+  if (b.cls < 0) return false;
+  const size_t limit = pool_limit_.load(std::memory_order_relaxed);
+  if (pooled_bytes_.fetch_add(b.bytes, std::memory_order_relaxed) + b.bytes > limit){
+    pooled_bytes_.fetch_sub(b.bytes, std::memory_order_relaxed);
+    return false;
+  }
+  PoolClass& pc = pool_[b.cls];
+  std::lock_guard<std::mutex> lk(pc.mu);
+  pc.blocks.push_back(b);
+  return true;
+}
+
+bool SharedBuffer::PoolGet(int cls, Block* out){
+  if (cls < 0) return false;
+  PoolClass& pc = pool_[cls];
+  std::lock_guard<std::mutex> lk(pc.mu);
+  if (pc.blocks.empty()) return false;
+  *out = pc.blocks.back();  // LIFO: most recently used is most likely still mapped / hot
+  pc.blocks.pop_back();
+  pooled_bytes_.fetch_sub(out->bytes, std::memory_order_relaxed);
+  return true;
+}
+
+void SharedBuffer::SetPoolLimit(size_t max_pooled_bytes){
+  pool_limit_.store(max_pooled_bytes, std::memory_order_relaxed);
+  if (pooled_bytes_.load(std::memory_order_relaxed) > max_pooled_bytes) Trim(max_pooled_bytes);
+}
+
+size_t SharedBuffer::Trim(size_t keep_bytes){
+  size_t released = DrainThreadCaches();
+  // largest classes first: fewest driver calls per released byte
+  for (int cls = kNumSizeClasses - 1; cls >= 0; --cls){
+    if (pooled_bytes_.load(std::memory_order_relaxed) <= keep_bytes) break;
+    PoolClass& pc = pool_[cls];
+    std::lock_guard<std::mutex> lk(pc.mu);
+    while (!pc.blocks.empty() && pooled_bytes_.load(std::memory_order_relaxed) > keep_bytes){
+      const Block b = pc.blocks.back();
+      pc.blocks.pop_back();
+      pooled_bytes_.fetch_sub(b.bytes, std::memory_order_relaxed);
+      released += b.bytes;
+      ReleaseBlock(b);
+    }
+  }
+  return released;
+}
+
+void SharedBuffer::ReleaseBlock(const Block& b){
+  if (!b.raw || !rpc_mem_free_) return;
+  if (b.fd >= 0){
+    if (auto hook = fd_release_hook_.load(std::memory_order_acquire)) hook(b.fd);
+  }
+  rpc_mem_free_(b.raw);
+  stat_rpcmem_frees_.fetch_add(1, std::memory_order_relaxed);
+}
+
+SharedBuffer::Shard& SharedBuffer::ShardOf(const void* aligned) const{
+  // aligned ptrs are >= 64B apart; mix in higher bits so big blocks spread too
+  const uintptr_t p = reinterpret_cast<uintptr_t>(aligned);
+  return shards_[((p >> 6) ^ (p >> 16)) % kNumShards];
 }
 
 void* SharedBuffer::AllocMem(size_t bytes, size_t alignment) {
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)bytes; (void)alignment;
   std::cerr << "[QNN] SharedBuffer::AllocMem noop on non-aarch64\n";
   return nullptr;
 #else
-  if (!initialized_.load() || !rpc_mem_alloc_) {
+  if (!initialized_.load(std::memory_order_acquire) || !rpc_mem_alloc_) {
     std::cerr << "[QNN] SharedBuffer not initialized\n";
     return nullptr;
   }
+  if (alignment == 0) alignment = 64;
 
   // rpcmem은 내부 alignment도 있지만, executorch처럼 우리가 추가로 aligned ptr을 돌려준다
-  int32_t alloc_bytes = static_cast<int32_t>(bytes + alignment);
-  void* raw = rpc_mem_alloc_(RPCMEM_HEAP_ID_SYSTEM, RPCMEM_DEFAULT_FLAGS, alloc_bytes);
-  if (!raw) {
-    std::cerr << "[QNN] rpcmem_alloc failed\n";
-    return nullptr;
+  // pooled sizes are rounded up to their class so a freed block fits the next request of that class
+  const int cls = SizeClassOf(bytes + alignment);
+  const size_t alloc_bytes = cls >= 0 ? SizeClassBytes(cls) : bytes + alignment;
+  Block b;
+  if (alloc_bytes <= kThreadCacheMaxBytes){
+    ThreadCache& tc = LocalCache();
+    std::lock_guard<std::mutex> lk(tc.mu);
+    for (size_t i = 0; i < tc.n; ++i){
+      if (tc.slots[i].bytes == alloc_bytes){
+        b = tc.slots[i];
+        tc.slots[i] = tc.slots[--tc.n];
+        stat_thread_cache_hits_.fetch_add(1, std::memory_order_relaxed);
+        break;
+      }
+    }
+  }
+  if (!b.raw && PoolGet(cls, &b)){
+    stat_pool_hits_.fetch_add(1, std::memory_order_relaxed);
+  }
+  if (!b.raw){
+    void* raw = rpc_mem_alloc_(RPCMEM_HEAP_ID_SYSTEM, RPCMEM_DEFAULT_FLAGS, static_cast<int32_t>(alloc_bytes));
+    if (!raw && Trim(0) != 0){
+      // cached blocks may be what is holding the ION/dma-buf heap; retry once after trimming
+      raw = rpc_mem_alloc_(RPCMEM_HEAP_ID_SYSTEM, RPCMEM_DEFAULT_FLAGS, static_cast<int32_t>(alloc_bytes));
+    }
+    if (!raw) {
+      std::cerr << "[QNN] rpcmem_alloc failed\n";
+      return nullptr;
+    }
+    stat_rpcmem_allocs_.fetch_add(1, std::memory_order_relaxed);
+    b = Block{raw, alloc_bytes, -1, cls};
   }
 
-  allocated_size_map_[raw] = static_cast<size_t>(alloc_bytes);
-
-  void* aligned = reinterpret_cast<void*>(alignTo(alignment, reinterpret_cast<intptr_t>(raw)));
-  if (!restore_map_.insert({aligned, raw}).second) {
-    std::cerr << "[QNN] restore_map insert failed\n";
-    rpc_mem_free_(raw);
-    allocated_size_map_.erase(raw);
-    return nullptr;
+  void* aligned = reinterpret_cast<void*>(alignTo(alignment, reinterpret_cast<intptr_t>(b.raw)));
+  Shard& sh = ShardOf(aligned);
+  {
+    std::lock_guard<std::mutex> lk(sh.mu);
+    if (!sh.blocks.emplace(aligned, b).second) {
+      std::cerr << "[QNN] SharedBuffer: aligned ptr already tracked\n";
+      ReleaseBlock(b);
+      return nullptr;
+    }
   }
+  stat_allocs_.fetch_add(1, std::memory_order_relaxed);
   return aligned;
 #endif
 }
 
 int32_t SharedBuffer::MemToFd(void* buf) {
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)buf;
   return -1;
 #else
-  if (!initialized_.load() || !rpc_mem_to_fd_) return -1;
+  if (!initialized_.load(std::memory_order_acquire) || !rpc_mem_to_fd_) return -1;
 //   // 주의: rpcmem_to_fd는 “raw든 aligned든” 들어오는 ptr이 rpcmem 영역이면 보통 동작하지만,
 //   // 안전하게 하려면 raw로 변환해서 넣는 게 좋다.
-//   void* raw = buf;
-//   auto it = restore_map_.find(buf);
-//   if (it != restore_map_.end()) raw = it->second;
-//   return rpc_mem_to_fd_(raw);
-  return rpc_mem_to_fd_(buf);
+  // fd is cached in the block, so a block reused from a cache does not ask the driver again
+  Shard& sh = ShardOf(buf);
+  std::lock_guard<std::mutex> lk(sh.mu);
+  auto it = sh.blocks.find(buf);
+  if (it == sh.blocks.end()) return rpc_mem_to_fd_(buf);  // not from AllocMem (e.g. arena slice)
+  if (it->second.fd < 0) it->second.fd = rpc_mem_to_fd_(it->second.raw);
+  return it->second.fd;
 #endif
 }
 
 void SharedBuffer::FreeMem(void* buf) {
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)buf;
 #else
-  if (!initialized_.load() || !rpc_mem_free_) return;
-
-  auto it = restore_map_.find(buf);
-  if (it == restore_map_.end()) {
-    std::cerr << "[QNN] FreeMem: not an allocated ptr\n";
-    return;
+  if (!initialized_.load(std::memory_order_acquire) || !rpc_mem_free_) return;
+
+  Block b;
+  {
+    Shard& sh = ShardOf(buf);
+    std::lock_guard<std::mutex> lk(sh.mu);
+    auto it = sh.blocks.find(buf);
+    if (it == sh.blocks.end()) {
+      std::cerr << "[QNN] FreeMem: not an allocated ptr\n";
+      return;
+    }
+    b = it->second;
+    sh.blocks.erase(it);
   }
-
-  void* raw = it->second;
-  rpc_mem_free_(raw);
-
-  restore_map_.erase(it);
-  allocated_size_map_.erase(raw);
+  stat_frees_.fetch_add(1, std::memory_order_relaxed);
+
+  if (b.bytes <= kThreadCacheMaxBytes){
+    ThreadCache& tc = LocalCache();
+    std::lock_guard<std::mutex> lk(tc.mu);
+    // a Trim() on another thread may have drained (and unregistered) the cache since LocalCache();
+    // a block parked there now would be lost if this thread exits before re-registering => pool it
+    if (tc.owner.load() && tc.n < kThreadCacheSlots){
+      tc.slots[tc.n++] = b;
+      return;
+    }
+  }
+  if (PoolPut(b)) return;
+  ReleaseBlock(b);
 #endif
 }
 
 bool SharedBuffer::IsAllocated(void* buf) const {
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)buf;
   return false;
 #else
-  return restore_map_.count(buf) != 0;
+  Shard& sh = ShardOf(buf);
+  std::lock_guard<std::mutex> lk(sh.mu);
+  return sh.blocks.count(buf) != 0;
 #endif
 }
 
 size_t SharedBuffer::GetAllocatedSize(void* buf) const {
-#if !defined(__aarch64__)
+#if !QNN_RUNTIME_ENABLED
   (void)buf;
   return 0;
 #else
-//   // buf가 aligned로 들어오면 raw로 바꿔서 size map에서 찾는다
-//   void* raw = buf;
-//   auto it = restore_map_.find(buf);
-//   if (it != restore_map_.end()) raw = it->second;
-  void* raw = buf;
-
-  auto it2 = allocated_size_map_.find(raw);
-  if (it2 == allocated_size_map_.end()) return 0;
-  return it2->second;
+  Shard& sh = ShardOf(buf);
+  std::lock_guard<std::mutex> lk(sh.mu);
+  auto it = sh.blocks.find(buf);
+  if (it == sh.blocks.end()) return 0;
+  // aligned ptr 기준으로 남은 크기
+  const size_t head = reinterpret_cast<uintptr_t>(buf) - reinterpret_cast<uintptr_t>(it->second.raw);
+  return it->second.bytes - head;
 #endif
-}
\ No newline at end of file
+}
+
+SharedBuffer::Stats SharedBuffer::GetStats() const{
+  Stats st;
+  st.allocs = stat_allocs_.load(std::memory_order_relaxed);
+  st.frees = stat_frees_.load(std::memory_order_relaxed);
+  st.rpcmem_allocs = stat_rpcmem_allocs_.load(std::memory_order_relaxed);
+  st.rpcmem_frees = stat_rpcmem_frees_.load(std::memory_order_relaxed);
+  st.thread_cache_hits = stat_thread_cache_hits_.load(std::memory_order_relaxed);
+  st.pool_hits = stat_pool_hits_.load(std::memory_order_relaxed);
+  st.pooled_bytes = pooled_bytes_.load(std::memory_order_relaxed);
+  st.live = st.allocs - st.frees;
+  return st;
+}
@@ -36,6 +36,15 @@ uint32_t QnnTensor::CalcBytes(Qnn_DataType_t dt, const std::vector<uint32_t>& di
   return static_cast<uint32_t>(n);
 }
 
+size_t QnnTensor::MetaBytes(const Qnn_Tensor_t& t){
+    auto* tv = QNN_TENSOR_VER_PTR(t);
+    size_t bytes = DataTypeSize(tv->dataType);
+    for (uint32_t i = 0; i < tv->rank; ++i) bytes *= tv->dimensions[i];
+    // unknown dtype: only a RAW buffer knows its size (memHandle shares the union with clientBuf)
+    if (bytes == 0 && tv->memType == QNN_TENSORMEMTYPE_RAW) bytes = tv->clientBuf.dataSize;
+    return bytes;
+}
+
 void QnnTensor::InitCommon_(Qnn_TensorType_t tensor_type, Qnn_DataType_t data_type){
     tensor_.version = QNN_TENSOR_VERSION_2;
 
@@ -0,0 +1,249 @@
+#include "qnn_trace.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include "QnnProfile.h"
+#include "HTP/QnnHtpProfile.h"
+#include "qnn_profiler.h"
+
+uint64_t QnnTraceWriter::NowUs(){
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+void QnnTraceWriter::AddSpan(const std::string& name, const std::string& cat,
+                             uint64_t ts_us, uint64_t dur_us, int tid,
+                             const std::string& args_json){
+    std::lock_guard<std::mutex> lk(mu_);
+    Event e;
+    e.name = name;
+    e.cat = cat;
+    e.ph = 'X';
+    e.ts = ts_us;
+    e.dur = dur_us;
+    e.tid = tid;
+    e.args = args_json;
+    events_.push_back(std::move(e));
+}
+
+void QnnTraceWriter::AddCounter(const std::string& name, uint64_t ts_us, double value){
+    std::lock_guard<std::mutex> lk(mu_);
+    Event e;
+    e.name = name;
+    e.cat = "counter";
+    e.ph = 'C';
+    e.ts = ts_us;
+    e.value = value;
+    events_.push_back(std::move(e));
+}
+
+void QnnTraceWriter::AddInstant(const std::string& name, const std::string& cat,
+                                uint64_t ts_us, int tid, const std::string& args_json){
+    std::lock_guard<std::mutex> lk(mu_);
+    Event e;
+    e.name = name;
+    e.cat = cat;
+    e.ph = 'i';
+    e.ts = ts_us;
+    e.tid = tid;
+    e.args = args_json;
+    events_.push_back(std::move(e));
+}
+
+void QnnTraceWriter::AddProfileEvents(const std::string& graph_name,
+                                      const QnnSystemProfile_ProfileEventV1_t* events,
+                                      uint32_t num_events,
+                                      uint64_t exec_start_us){
+    if (!events || num_events == 0) return;
+    std::lock_guard<std::mutex> lk(mu_);
+    WalkLocked(graph_name, events, num_events, exec_start_us, /*cycles_per_us=*/0.0);
+}
+
+// QNN event에는 (extended 제외) timestamp가 없다. 그래서
+//  - EXECUTE / HTP_*_RPC / ACCEL 같은 total 값은 parent 시작점에 겹쳐서(nested) 놓고
+//  - NODE 는 parent 시작점부터 순서대로 이어 붙인다.
+//  - NODE 가 cycle 단위면 같은 level의 ACCEL_CYCLES / ACCEL_US 비율로 us 환산
+//  - VTCM acquire / yield / HVX threads 는 counter
+void QnnTraceWriter::WalkLocked(const std::string& graph_name,
+                                const QnnSystemProfile_ProfileEventV1_t* events,
+                                uint32_t num_events,
+                                uint64_t start_us,
+                                double cycles_per_us){
+    uint64_t accel_cycles = 0, accel_us = 0;
+    for (uint32_t i = 0; i < num_events; ++i){
+        if (events[i].type != QNN_SYSTEM_PROFILE_EVENT_DATA) continue;
+        const auto& ed = events[i].eventData;
+        if (ed.type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_CYCLE) accel_cycles = ed.value;
+        if (ed.type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_MICROSEC) accel_us = ed.value;
+    }
+    if (accel_cycles && accel_us) cycles_per_us = double(accel_cycles) / double(accel_us);
+
+    uint64_t cursor = start_us;
+    for (uint32_t i = 0; i < num_events; ++i){
+        const auto& ev = events[i];
+
+        if (ev.type != QNN_SYSTEM_PROFILE_EVENT_DATA){
+            // extended (optrace object etc.): payload is not decoded here
+            const auto& v = ev.extendedEventData.v1;
+            const std::string ident = v.identifier ? v.identifier : QnnProfilerRuntime::TypeToStr(v.type);
+            if (v.unit != QNN_PROFILE_EVENTUNIT_OBJECT){
+                Event e;
+                e.name = ident;
+                e.cat = graph_name;
+                e.ph = 'i';
+                e.ts = start_us;
+                e.tid = kBackendTid;
+                e.args = "\"ts\":" + std::to_string((unsigned long long)v.timestamp);
+                events_.push_back(std::move(e));
+            }
+            if (ev.profileSubEventData) WalkLocked(graph_name, ev.profileSubEventData, ev.numSubEvents, start_us, cycles_per_us);
+            continue;
+        }
+
+        const auto& ed = ev.eventData;
+        const std::string type_str = QnnProfilerRuntime::TypeToStr(ed.type);
+        const std::string name = (ed.identifier && ed.identifier[0]) ? ed.identifier : type_str;
+
+        if (ed.type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_YIELD_COUNT ||
+            ed.type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_VTCM_ACQUIRE_TIME ||
+            ed.type == QNN_HTP_PROFILE_EVENTTYPE_GRAPH_NUMBER_OF_HVX_THREADS){
+            Event e;
+            e.name = graph_name + ":" + type_str;
+            e.cat = "counter";
+            e.ph = 'C';
+            e.ts = start_us;
+            e.value = double(ed.value);
+            events_.push_back(std::move(e));
+            continue;
+        }
+
+        uint64_t dur = 0;
+        if (ed.unit == QNN_PROFILE_EVENTUNIT_MICROSEC) dur = ed.value;
+        else if (ed.unit == QNN_PROFILE_EVENTUNIT_CYCLES && cycles_per_us > 0.0) dur = uint64_t(double(ed.value) / cycles_per_us);
+
+        const bool is_node = (ed.type == QNN_PROFILE_EVENTTYPE_NODE);
+        const bool timed = (ed.unit == QNN_PROFILE_EVENTUNIT_MICROSEC ||
+                            (ed.unit == QNN_PROFILE_EVENTUNIT_CYCLES && cycles_per_us > 0.0));
+        const uint64_t ts = is_node ? cursor : start_us;
+
+        Event e;
+        e.name = name;
+        e.cat = graph_name;
+        e.tid = is_node ? kOpTid : kBackendTid;
+        e.ts = ts;
+        e.args = "\"type\":\"" + Escape(type_str) + "\",\"unit\":\"" + QnnProfilerRuntime::UnitToStr(ed.unit)
+               + "\",\"value\":" + std::to_string((unsigned long long)ed.value);
+        if (timed){
+            e.ph = 'X';
+            e.dur = dur;
+        } else {
+            e.ph = 'i';
+        }
+        events_.push_back(std::move(e));
+
+        if (is_node) cursor += dur;
+        if (ev.profileSubEventData) WalkLocked(graph_name, ev.profileSubEventData, ev.numSubEvents, ts, cycles_per_us);
+    }
+}
+
+std::string QnnTraceWriter::Escape(const std::string& s){
+    std::string out;
+    out.reserve(s.size());
+    for (char c : s){
+        switch (c){
+            case '"': out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20){
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += c;
+                }
+        }
+    }
+    return out;
+}
+
+bool QnnTraceWriter::WriteJson(const std::string& path) const{
+    std::lock_guard<std::mutex> lk(mu_);
+    std::ofstream ofs(path, std::ios::trunc);
+    if (!ofs.good()){
+        std::cerr << "[QNN] Trace: failed to open " << path << "\n";
+        return false;
+    }
+
+    ofs << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    // thread names
+    ofs << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << kHostTid << ",\"name\":\"thread_name\",\"args\":{\"name\":\"host\"}},\n";
+    ofs << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << kBackendTid << ",\"name\":\"thread_name\",\"args\":{\"name\":\"htp graph\"}},\n";
+    ofs << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << kOpTid << ",\"name\":\"thread_name\",\"args\":{\"name\":\"htp ops\"}}";
+    for (const auto& kv : thread_names_){
+        ofs << ",\n{\"ph\":\"M\",\"pid\":1,\"tid\":" << kv.first
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":\"" << Escape(kv.second) << "\"}}";
+    }
+
+    for (const auto& e : events_){
+        ofs << ",\n{\"name\":\"" << Escape(e.name) << "\",\"cat\":\"" << Escape(e.cat)
+            << "\",\"ph\":\"" << e.ph << "\",\"ts\":" << e.ts << ",\"pid\":1,\"tid\":" << e.tid;
+        if (e.ph == 'X') ofs << ",\"dur\":" << e.dur;
+        if (e.ph == 'i') ofs << ",\"s\":\"t\"";
+        if (e.ph == 'C') ofs << ",\"args\":{\"value\":" << e.value << "}";
+        else if (!e.args.empty()) ofs << ",\"args\":{" << e.args << "}";
+        ofs << "}";
+    }
+    ofs << "\n]}\n";
+    ofs.close();
+
+    std::cout << "[QNN] Trace: wrote " << events_.size() << " events to " << path << "\n";
+    return ofs.good();
+}
+
+void QnnTraceWriter::SetThreadName(int tid, const std::string& name){
+    std::lock_guard<std::mutex> lk(mu_);
+    thread_names_[tid] = name;
+}
+
+void QnnTraceWriter::DumpSpans(std::ostream& os, const std::string& cat) const{
+    std::vector<const Event*> spans;
+    std::lock_guard<std::mutex> lk(mu_);
+    for (const auto& e : events_){
+        if (e.ph == 'X' && e.cat == cat) spans.push_back(&e);
+    }
+    if (spans.empty()) return;
+    std::sort(spans.begin(), spans.end(), [](const Event* a, const Event* b){ return a->ts < b->ts; });
+
+    const uint64_t t0 = spans.front()->ts;
+    uint64_t t1 = t0;
+    const auto flags = os.flags();
+    const auto prec = os.precision();
+    os << "[QNN] " << cat << " spans (start_ms / dur_ms / tid)\n";
+    for (const Event* e : spans){
+        t1 = std::max(t1, e->ts + e->dur);
+        os << "  " << std::fixed << std::setprecision(3)
+           << std::setw(9) << (e->ts - t0) / 1000.0 << "  "
+           << std::setw(9) << e->dur / 1000.0 << "  "
+           << e->tid << "  " << e->name << "\n";
+    }
+    os << "  wall=" << (t1 - t0) / 1000.0 << " ms\n";
+    os.flags(flags);
+    os.precision(prec);
+}
+
+void QnnTraceWriter::Clear(){
+    std::lock_guard<std::mutex> lk(mu_);
+    events_.clear();
+}
+
+size_t QnnTraceWriter::Size() const{
+    std::lock_guard<std::mutex> lk(mu_);
+    return events_.size();
+}
@@ -0,0 +1,97 @@
+#include "qnn_warmup.h"
+
+#include <chrono>
+#include <iostream>
+#include <unistd.h>
+
+#include "HTP/QnnHtpProfile.h"
+
+#include "qnn_tensor.h"
+
+static inline bool CheckQnnOk(Qnn_ErrorHandle_t err, const char* what){
+    if (err != QNN_SUCCESS){
+        std::cerr << "[QNN] " << what << " failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
+        return false;
+    }
+    return true;
+}
+
+size_t QnnWarmupRuntime::PrefaultArena(const SharedBuffer::Arena& a){
+    if (!a.base || a.total == 0) return 0;
+    long ps = sysconf(_SC_PAGESIZE);
+    const size_t page = ps > 0 ? static_cast<size_t>(ps) : 4096;
+
+    // read + write back the same byte: faults the page in for write without touching data
+    volatile uint8_t* p = static_cast<volatile uint8_t*>(a.base);
+    size_t pages = 0;
+    for (size_t off = 0; off < a.total; off += page, ++pages){
+        p[off] = p[off];
+    }
+    return pages;
+}
+
+bool QnnWarmupRuntime::WarmGraph(const QnnInterface_t* be,
+                                 Qnn_GraphHandle_t graph,
+                                 const std::string& graph_name,
+                                 const std::vector<Qnn_Tensor_t>& inputs,
+                                 const std::vector<Qnn_Tensor_t>& outputs){
+    if (!be || !graph || inputs.empty() || outputs.empty()){
+        std::cerr << "[QNN] Warmup: invalid graph/IO for " << graph_name << "\n";
+        return false;
+    }
+
+    // RAW scratch for every tensor; the real request binds its own (registered) buffers
+    std::vector<Qnn_Tensor_t> in(inputs), out(outputs);
+    std::vector<std::vector<uint8_t>> bufs;
+    bufs.reserve(in.size() + out.size());
+    for (auto* ts : {&in, &out}){
+        for (auto& t : *ts){
+            auto* tv = QNN_TENSOR_VER_PTR(t);
+            const size_t bytes = QnnTensor::MetaBytes(t);
+            bufs.emplace_back(bytes, 0);
+            tv->memType = QNN_TENSORMEMTYPE_RAW;
+            tv->clientBuf.data = bufs.back().data();
+            tv->clientBuf.dataSize = static_cast<uint32_t>(bytes);
+        }
+    }
+
+    auto& api = be->QNN_INTERFACE_VER_NAME;
+    const auto t0 = std::chrono::steady_clock::now();
+    Qnn_ErrorHandle_t err = api.graphExecute(
+        graph,
+        in.data(), static_cast<uint32_t>(in.size()),
+        out.data(), static_cast<uint32_t>(out.size()),
+        /*profile=*/nullptr, /*signal=*/nullptr);
+    const uint64_t us = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+    if (!CheckQnnOk(err, "graphExecute(warmup)")) return false;
+
+    cold_us_[graph_name] = us;
+    std::cout << "[QNN] Warmup: " << graph_name << " cold execute " << us << " us\n";
+    return true;
+}
+
+uint64_t QnnWarmupRuntime::ColdUs(const std::string& graph_name) const{
+    auto it = cold_us_.find(graph_name);
+    return it == cold_us_.end() ? 0 : it->second;
+}
+
+void QnnWarmupRuntime::Report(const std::string& graph_name, uint64_t first_request_us,
+                              QnnProfilerRuntime* profiler) const{
+    const uint64_t cold = ColdUs(graph_name);
+    std::cout << "[QNN] Warmup report: " << graph_name << " first_request=" << first_request_us << " us";
+    if (cold){
+        const int64_t moved = static_cast<int64_t>(cold) - static_cast<int64_t>(first_request_us);
+        std::cout << " cold=" << cold << " us saved=" << moved << " us";
+    } else {
+        std::cout << " (no warm-up, first request was cold)";
+    }
+    if (profiler && profiler->IsValid()){
+        uint64_t v = 0;
+        if (profiler->FindEventValue(QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_RESOURCE_POWER_UP_TIME, &v))
+            std::cout << " " << QnnProfilerRuntime::TypeToStr(QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_RESOURCE_POWER_UP_TIME) << "=" << v;
+        if (profiler->FindEventValue(QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_VTCM_ACQUIRE_TIME, &v))
+            std::cout << " " << QnnProfilerRuntime::TypeToStr(QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_VTCM_ACQUIRE_TIME) << "=" << v;
+    }
+    std::cout << "\n";
+}
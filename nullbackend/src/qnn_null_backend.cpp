@@ -0,0 +1,932 @@
+// Null QNN backend: QnnInterface_getProviders + QnnSystemInterface_getProviders in one .so.
+//
+// graph/context/mem/profile 호출은 모두 cheap stub. device 없이 host overhead만 재기 위한 용도.
+//   QNN_BACKEND_LIB=libQnnNull.so QNN_SYSTEM_LIB=libQnnNull.so ./qnn_bench ...
+//
+// env
+//   QNN_NULL_EXEC_US   : graphExecute 한 번당 simulated latency (default 0)
+//   QNN_NULL_EXEC_SPIN : 1이면 sleep 대신 busy-wait (짧은 latency를 정확하게)
+//   QNN_NULL_LOAD_US   : contextCreateFromBinary simulated latency (default 0)
+//   QNN_NULL_PERF_LOG  : 1이면 HTP perf vote(setPowerConfig)를 하나씩 출력
+//
+// context binary format (host endian, AOT에서 contextGetBinary로 만든 것만 읽음)
+//   u32 magic 'QNUL' | u32 version | u32 num_graphs
+//   graph  : str name | u32 num_nodes | u32 n_in | u32 n_out | tensor * (n_in + n_out)
+//   tensor : u32 id | str name | u32 type | u32 dtype | i32 q_enc | f32 scale | i32 offset | u32 rank | u32 dims[rank]
+//   str    : u32 len | bytes
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "QnnInterface.h"
+#include "QnnTypes.h"
+#include "System/QnnSystemInterface.h"
+#include "HTP/QnnHtpDevice.h"
+#include "HTP/QnnHtpPerfInfrastructure.h"
+
+#include "qnn_tensor.h"  // QNN_TENSOR_VER_PTR
+
+#define NULL_EXPORT extern "C" __attribute__((visibility("default")))
+
+static constexpr uint32_t kBinaryMagic = 0x4C554E51;  // "QNUL"
+static constexpr uint32_t kBinaryVersion = 1;
+static constexpr uint32_t kNullBackendId = 0x4E554C4C;  // "NULL"
+static const char* kBuildId = "qnn-null-backend";
+
+// ---------------- env ----------------
+static uint64_t EnvU64(const char* name, uint64_t def){
+    const char* v = std::getenv(name);
+    if (!v || !*v) return def;
+    return std::strtoull(v, nullptr, 10);
+}
+
+static uint64_t ExecUs(){ static const uint64_t v = EnvU64("QNN_NULL_EXEC_US", 0); return v; }
+static bool ExecSpin(){ static const bool v = EnvU64("QNN_NULL_EXEC_SPIN", 0) != 0; return v; }
+static uint64_t LoadUs(){ static const uint64_t v = EnvU64("QNN_NULL_LOAD_US", 0); return v; }
+static bool PerfLog(){ static const bool v = EnvU64("QNN_NULL_PERF_LOG", 0) != 0; return v; }
+
+static uint64_t NowUs(){
+    using namespace std::chrono;
+    return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+static void SimulateLatency(uint64_t us, bool spin){
+    if (us == 0) return;
+    if (!spin){
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+        return;
+    }
+    const uint64_t until = NowUs() + us;
+    while (NowUs() < until){ }
+}
+
+// ---------------- objects behind handles ----------------
+struct NullTensor{
+    uint32_t id{0};
+    std::string name;
+    uint32_t type{0};
+    uint32_t dtype{0};
+    int32_t q_enc{0};
+    float scale{0.f};
+    int32_t offset{0};
+    std::vector<uint32_t> dims;
+};
+
+struct NullGraph{
+    std::string name;
+    uint32_t num_nodes{0};
+    bool finalized{false};
+    std::vector<NullTensor> inputs;
+    std::vector<NullTensor> outputs;
+    std::unordered_map<std::string, uint32_t> ids;  // name -> id (collision check)
+};
+
+struct NullContext{
+    std::vector<std::unique_ptr<NullGraph>> graphs;
+};
+
+struct NullEvent{
+    QnnProfile_EventData_t data;
+    uint64_t timestamp{0};
+    std::vector<QnnProfile_EventId_t> sub;
+};
+
+struct NullProfile{
+    QnnProfile_Level_t level{0};
+    std::vector<QnnProfile_EventId_t> top;
+    std::vector<QnnProfile_EventId_t> owned;  // top + sub (freed on next execute)
+};
+
+// binary info storage; lives until systemContextFree (같은 수명 규칙)
+struct NullSystemContext{
+    std::vector<std::unique_ptr<std::string>> strings;
+    std::vector<std::unique_ptr<std::vector<uint32_t>>> dims;
+    std::vector<std::unique_ptr<std::vector<Qnn_Tensor_t>>> tensors;
+    std::vector<QnnSystemContext_GraphInfo_t> graphs;
+    QnnSystemContext_BinaryInfo_t info;
+};
+
+static std::mutex g_mu;  // contexts/graphs/profiles/events
+static std::unordered_map<Qnn_ContextHandle_t, std::unique_ptr<NullContext>> g_contexts;
+static std::unordered_map<Qnn_GraphHandle_t, NullGraph*> g_graphs;
+static std::unordered_map<Qnn_ProfileHandle_t, std::unique_ptr<NullProfile>> g_profiles;
+static std::unordered_map<QnnProfile_EventId_t, NullEvent> g_events;
+
+static std::atomic<uintptr_t> g_next_handle{0x10};
+static std::atomic<QnnProfile_EventId_t> g_next_event{1};
+
+// counters for load tests (printed at backendFree)
+static std::atomic<uint64_t> g_executes{0};
+static std::atomic<uint64_t> g_mem_registered{0};
+static std::atomic<uint64_t> g_mem_live{0};
+static std::atomic<uint64_t> g_power_votes{0};
+
+template <typename H>
+static H NewHandle(){
+    return reinterpret_cast<H>(g_next_handle.fetch_add(1));
+}
+
+// ---------------- binary (de)serialization ----------------
+static void PutU32(std::vector<uint8_t>& out, uint32_t v){
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&v);
+    out.insert(out.end(), p, p + sizeof(v));
+}
+
+static void PutStr(std::vector<uint8_t>& out, const std::string& s){
+    PutU32(out, static_cast<uint32_t>(s.size()));
+    out.insert(out.end(), s.begin(), s.end());
+}
+
+static void PutTensor(std::vector<uint8_t>& out, const NullTensor& t){
+    PutU32(out, t.id);
+    PutStr(out, t.name);
+    PutU32(out, t.type);
+    PutU32(out, t.dtype);
+    PutU32(out, static_cast<uint32_t>(t.q_enc));
+    uint32_t scale_bits = 0;
+    std::memcpy(&scale_bits, &t.scale, sizeof(scale_bits));
+    PutU32(out, scale_bits);
+    PutU32(out, static_cast<uint32_t>(t.offset));
+    PutU32(out, static_cast<uint32_t>(t.dims.size()));
+    for (uint32_t d : t.dims) PutU32(out, d);
+}
+
+static std::vector<uint8_t> Serialize(const NullContext& ctx){
+    std::vector<uint8_t> out;
+    PutU32(out, kBinaryMagic);
+    PutU32(out, kBinaryVersion);
+    PutU32(out, static_cast<uint32_t>(ctx.graphs.size()));
+    for (const auto& g : ctx.graphs){
+        PutStr(out, g->name);
+        PutU32(out, g->num_nodes);
+        PutU32(out, static_cast<uint32_t>(g->inputs.size()));
+        PutU32(out, static_cast<uint32_t>(g->outputs.size()));
+        for (const auto& t : g->inputs) PutTensor(out, t);
+        for (const auto& t : g->outputs) PutTensor(out, t);
+    }
+    return out;
+}
+
+class Reader{
+    public:
+    Reader(const void* p, uint64_t n) : p_(static_cast<const uint8_t*>(p)), n_(n) {}
+
+    bool U32(uint32_t* v){
+        if (pos_ + sizeof(*v) > n_) return false;
+        std::memcpy(v, p_ + pos_, sizeof(*v));
+        pos_ += sizeof(*v);
+        return true;
+    }
+    bool Str(std::string* s){
+        uint32_t len = 0;
+        if (!U32(&len) || pos_ + len > n_) return false;
+        s->assign(reinterpret_cast<const char*>(p_ + pos_), len);
+        pos_ += len;
+        return true;
+    }
+
+    private:
+    const uint8_t* p_;
+    uint64_t n_;
+    uint64_t pos_{0};
+};
+
+static bool ReadTensor(Reader& r, NullTensor* t){
+    uint32_t q_enc = 0, scale_bits = 0, offset = 0, rank = 0;
+    if (!r.U32(&t->id) || !r.Str(&t->name) || !r.U32(&t->type) || !r.U32(&t->dtype) ||
+        !r.U32(&q_enc) || !r.U32(&scale_bits) || !r.U32(&offset) || !r.U32(&rank)) return false;
+    t->q_enc = static_cast<int32_t>(q_enc);
+    std::memcpy(&t->scale, &scale_bits, sizeof(scale_bits));
+    t->offset = static_cast<int32_t>(offset);
+    t->dims.resize(rank);
+    for (uint32_t i = 0; i < rank; ++i){
+        if (!r.U32(&t->dims[i])) return false;
+    }
+    return true;
+}
+
+static bool Deserialize(const void* buf, uint64_t nbytes, NullContext* ctx){
+    Reader r(buf, nbytes);
+    uint32_t magic = 0, version = 0, num_graphs = 0;
+    if (!r.U32(&magic) || magic != kBinaryMagic){
+        std::cerr << "[QNN-null] not a null-backend context binary\n";
+        return false;
+    }
+    if (!r.U32(&version) || version != kBinaryVersion){
+        std::cerr << "[QNN-null] unsupported binary version " << version << "\n";
+        return false;
+    }
+    if (!r.U32(&num_graphs)) return false;
+
+    for (uint32_t gi = 0; gi < num_graphs; ++gi){
+        auto g = std::make_unique<NullGraph>();
+        uint32_t n_in = 0, n_out = 0;
+        if (!r.Str(&g->name) || !r.U32(&g->num_nodes) || !r.U32(&n_in) || !r.U32(&n_out)) return false;
+        g->inputs.resize(n_in);
+        g->outputs.resize(n_out);
+        for (auto& t : g->inputs) if (!ReadTensor(r, &t)) return false;
+        for (auto& t : g->outputs) if (!ReadTensor(r, &t)) return false;
+        g->finalized = true;
+        ctx->graphs.push_back(std::move(g));
+    }
+    return true;
+}
+
+// ---------------- backend / device / log ----------------
+static Qnn_ErrorHandle_t NullLogCreate(QnnLog_Callback_t, QnnLog_Level_t, Qnn_LogHandle_t* logger){
+    if (!logger) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *logger = NewHandle<Qnn_LogHandle_t>();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullLogSetLogLevel(Qnn_LogHandle_t, QnnLog_Level_t){ return QNN_SUCCESS; }
+static Qnn_ErrorHandle_t NullLogFree(Qnn_LogHandle_t){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullBackendCreate(Qnn_LogHandle_t, const QnnBackend_Config_t**, Qnn_BackendHandle_t* backend){
+    if (!backend) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *backend = NewHandle<Qnn_BackendHandle_t>();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullBackendSetConfig(Qnn_BackendHandle_t, const QnnBackend_Config_t**){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullBackendGetApiVersion(Qnn_ApiVersion_t* v){
+    if (!v) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    v->coreApiVersion.major = QNN_API_VERSION_MAJOR;
+    v->coreApiVersion.minor = QNN_API_VERSION_MINOR;
+    v->coreApiVersion.patch = QNN_API_VERSION_PATCH;
+    v->backendApiVersion = v->coreApiVersion;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullBackendGetBuildId(const char** id){
+    if (!id) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *id = kBuildId;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullBackendRegisterOpPackage(Qnn_BackendHandle_t, const char*, const char*, const char*){
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullBackendValidateOpConfig(Qnn_BackendHandle_t, Qnn_OpConfig_t){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullBackendFree(Qnn_BackendHandle_t){
+    std::cout << "[QNN-null] executes=" << g_executes.load()
+              << " mem_registered=" << g_mem_registered.load()
+              << " mem_live=" << g_mem_live.load()
+              << " power_votes=" << g_power_votes.load() << "\n";
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullDeviceCreate(Qnn_LogHandle_t, const QnnDevice_Config_t**, Qnn_DeviceHandle_t* device){
+    if (!device) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *device = NewHandle<Qnn_DeviceHandle_t>();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullDeviceSetConfig(Qnn_DeviceHandle_t, const QnnDevice_Config_t**){ return QNN_SUCCESS; }
+static Qnn_ErrorHandle_t NullDeviceFree(Qnn_DeviceHandle_t){ return QNN_SUCCESS; }
+
+// ---------------- perf infrastructure ----------------
+// HTP-shaped perf infra that only records the votes (count printed at backendFree)
+static std::mutex g_perf_mu;
+static uint32_t g_next_power_id = 1;
+static std::unordered_map<uint32_t, uint32_t> g_power_ids;  // id -> votes
+
+static Qnn_ErrorHandle_t NullCreatePowerConfigId(uint32_t, uint32_t, uint32_t* power_config_id){
+    if (!power_config_id) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_perf_mu);
+    *power_config_id = g_next_power_id++;
+    g_power_ids[*power_config_id] = 0;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullDestroyPowerConfigId(uint32_t power_config_id){
+    std::lock_guard<std::mutex> lk(g_perf_mu);
+    return g_power_ids.erase(power_config_id) ? QNN_SUCCESS : QNN_COMMON_ERROR_INVALID_ARGUMENT;
+}
+
+static Qnn_ErrorHandle_t NullSetPowerConfig(uint32_t power_config_id, const QnnHtpPerfInfrastructure_PowerConfig_t** config){
+    if (!config) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    {
+        std::lock_guard<std::mutex> lk(g_perf_mu);
+        auto it = g_power_ids.find(power_config_id);
+        if (it == g_power_ids.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+        ++it->second;
+    }
+    g_power_votes.fetch_add(1, std::memory_order_relaxed);
+    if (!PerfLog()) return QNN_SUCCESS;
+
+    std::cout << "[QNN-null] power vote id=" << power_config_id;
+    for (const auto** c = config; *c; ++c){
+        switch ((*c)->option){
+            case QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_DCVS_V3:
+                std::cout << " dcvs=" << (*c)->dcvsV3Config.dcvsEnable
+                          << " mode=" << (*c)->dcvsV3Config.powerMode
+                          << " corner=" << (*c)->dcvsV3Config.coreVoltageCornerTarget
+                          << " sleep_latency=" << (*c)->dcvsV3Config.sleepLatency;
+                break;
+            case QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_RPC_POLLING_TIME:
+                std::cout << " rpc_polling=" << (*c)->rpcPollingTimeConfig;
+                break;
+            case QNN_HTP_PERF_INFRASTRUCTURE_POWER_CONFIGOPTION_RPC_CONTROL_LATENCY:
+                std::cout << " rpc_control_latency=" << (*c)->rpcControlLatencyConfig;
+                break;
+            default:
+                std::cout << " option=" << (*c)->option;
+                break;
+        }
+    }
+    std::cout << "\n";
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullSetMemoryConfig(uint32_t, uint32_t, const QnnHtpPerfInfrastructure_MemoryConfig_t**){
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullDeviceGetInfrastructure(const QnnDevice_Infrastructure_t* infra){
+    if (!infra) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    static QnnHtpDevice_Infrastructure_t htp_infra = []{
+        QnnHtpDevice_Infrastructure_t i{};
+        i.infraType = QNN_HTP_DEVICE_INFRASTRUCTURE_TYPE_PERF;
+        i.perfInfra.createPowerConfigId = NullCreatePowerConfigId;
+        i.perfInfra.destroyPowerConfigId = NullDestroyPowerConfigId;
+        i.perfInfra.setPowerConfig = NullSetPowerConfig;
+        i.perfInfra.setMemoryConfig = NullSetMemoryConfig;
+        return i;
+    }();
+    *const_cast<QnnDevice_Infrastructure_t*>(infra) = reinterpret_cast<QnnDevice_Infrastructure_t>(&htp_infra);
+    return QNN_SUCCESS;
+}
+
+// ---------------- context ----------------
+static Qnn_ErrorHandle_t NullContextCreate(Qnn_BackendHandle_t, Qnn_DeviceHandle_t,
+                                           const QnnContext_Config_t**, Qnn_ContextHandle_t* context){
+    if (!context) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto h = NewHandle<Qnn_ContextHandle_t>();
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_contexts[h] = std::make_unique<NullContext>();
+    *context = h;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullContextSetConfig(Qnn_ContextHandle_t, const QnnContext_Config_t**){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullContextGetBinarySize(Qnn_ContextHandle_t context, Qnn_ContextBinarySize_t* size){
+    if (!size) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_contexts.find(context);
+    if (it == g_contexts.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *size = Serialize(*it->second).size();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullContextGetBinary(Qnn_ContextHandle_t context, void* buf,
+                                              Qnn_ContextBinarySize_t buf_size, Qnn_ContextBinarySize_t* written){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_contexts.find(context);
+    if (it == g_contexts.end() || !buf) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    const auto bytes = Serialize(*it->second);
+    if (bytes.size() > buf_size) return QNN_COMMON_ERROR_MEM_ALLOC;
+    std::memcpy(buf, bytes.data(), bytes.size());
+    if (written) *written = bytes.size();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullContextCreateFromBinary(Qnn_BackendHandle_t, Qnn_DeviceHandle_t,
+                                                     const QnnContext_Config_t**, const void* buf,
+                                                     Qnn_ContextBinarySize_t size, Qnn_ContextHandle_t* context,
+                                                     Qnn_ProfileHandle_t){
+    if (!buf || !context) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto ctx = std::make_unique<NullContext>();
+    if (!Deserialize(buf, size, ctx.get())) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    SimulateLatency(LoadUs(), false);
+
+    auto h = NewHandle<Qnn_ContextHandle_t>();
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_contexts[h] = std::move(ctx);
+    *context = h;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullContextFree(Qnn_ContextHandle_t context, Qnn_ProfileHandle_t){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_contexts.find(context);
+    if (it == g_contexts.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    for (auto git = g_graphs.begin(); git != g_graphs.end();){
+        bool owned = false;
+        for (const auto& g : it->second->graphs) owned |= (g.get() == git->second);
+        git = owned ? g_graphs.erase(git) : std::next(git);
+    }
+    g_contexts.erase(it);
+    return QNN_SUCCESS;
+}
+
+// ---------------- graph / tensor ----------------
+static Qnn_ErrorHandle_t NullGraphCreate(Qnn_ContextHandle_t context, const char* name,
+                                         const QnnGraph_Config_t**, Qnn_GraphHandle_t* graph){
+    if (!name || !graph) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_contexts.find(context);
+    if (it == g_contexts.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto g = std::make_unique<NullGraph>();
+    g->name = name;
+    auto h = NewHandle<Qnn_GraphHandle_t>();
+    g_graphs[h] = g.get();
+    it->second->graphs.push_back(std::move(g));
+    *graph = h;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullGraphSetConfig(Qnn_GraphHandle_t, const QnnGraph_Config_t**){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullTensorCreateGraphTensor(Qnn_GraphHandle_t graph, Qnn_Tensor_t* tensor){
+    if (!tensor) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_graphs.find(graph);
+    if (it == g_graphs.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    NullGraph& g = *it->second;
+
+    auto* tv = QNN_TENSOR_VER_PTR(*tensor);
+    const std::string name = tv->name ? tv->name : "";
+    if (g.ids.count(name)) return QNN_TENSOR_ERROR_NAME_HASH_COLLISION;
+
+    const uint32_t id = static_cast<uint32_t>(g.ids.size() + 1);
+    g.ids[name] = id;
+    tv->id = id;
+
+    if (tv->type != QNN_TENSOR_TYPE_APP_WRITE && tv->type != QNN_TENSOR_TYPE_APP_READ) return QNN_SUCCESS;
+
+    NullTensor t;
+    t.id = id;
+    t.name = name;
+    t.type = static_cast<uint32_t>(tv->type);
+    t.dtype = static_cast<uint32_t>(tv->dataType);
+    t.q_enc = static_cast<int32_t>(tv->quantizeParams.quantizationEncoding);
+    if (tv->quantizeParams.quantizationEncoding == QNN_QUANTIZATION_ENCODING_SCALE_OFFSET){
+        t.scale = tv->quantizeParams.scaleOffsetEncoding.scale;
+        t.offset = tv->quantizeParams.scaleOffsetEncoding.offset;
+    } else {
+        // per-axis encodings are not kept in the null binary
+        t.q_enc = static_cast<int32_t>(QNN_QUANTIZATION_ENCODING_UNDEFINED);
+    }
+    t.dims.assign(tv->dimensions, tv->dimensions + tv->rank);
+    (tv->type == QNN_TENSOR_TYPE_APP_WRITE ? g.inputs : g.outputs).push_back(std::move(t));
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullTensorCreateContextTensor(Qnn_ContextHandle_t, Qnn_Tensor_t*){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullGraphAddNode(Qnn_GraphHandle_t graph, Qnn_OpConfig_t){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_graphs.find(graph);
+    if (it == g_graphs.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    ++it->second->num_nodes;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullGraphFinalize(Qnn_GraphHandle_t graph, Qnn_ProfileHandle_t, Qnn_SignalHandle_t){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_graphs.find(graph);
+    if (it == g_graphs.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    it->second->finalized = true;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullGraphRetrieve(Qnn_ContextHandle_t context, const char* name, Qnn_GraphHandle_t* graph){
+    if (!name || !graph) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_contexts.find(context);
+    if (it == g_contexts.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    for (auto& g : it->second->graphs){
+        if (g->name != name) continue;
+        for (const auto& kv : g_graphs){
+            if (kv.second == g.get()){ *graph = kv.first; return QNN_SUCCESS; }
+        }
+        auto h = NewHandle<Qnn_GraphHandle_t>();
+        g_graphs[h] = g.get();
+        *graph = h;
+        return QNN_SUCCESS;
+    }
+    return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+}
+
+static bool CheckIo(const Qnn_Tensor_t* ts, uint32_t n){
+    for (uint32_t i = 0; i < n; ++i){
+        const auto* tv = QNN_TENSOR_VER_PTR(ts[i]);
+        if (tv->memType == QNN_TENSORMEMTYPE_RAW && !tv->clientBuf.data) return false;
+        if (tv->memType == QNN_TENSORMEMTYPE_MEMHANDLE && !tv->memHandle) return false;
+    }
+    return true;
+}
+
+static QnnProfile_EventId_t AddEventLocked(NullProfile& p, QnnProfile_EventType_t type, QnnProfile_EventUnit_t unit,
+                                           uint64_t value, const char* ident, uint64_t ts){
+    const QnnProfile_EventId_t id = g_next_event.fetch_add(1);
+    NullEvent& e = g_events[id];
+    e.data = QNN_PROFILE_EVENT_DATA_INIT;
+    e.data.type = type;
+    e.data.unit = unit;
+    e.data.value = value;
+    e.data.identifier = ident;
+    e.timestamp = ts;
+    p.owned.push_back(id);
+    return id;
+}
+
+// HTP-shaped events so FindEventValue / latency / trace paths see something
+static void RecordExecuteEvents(Qnn_ProfileHandle_t profile, const NullGraph& g, uint64_t start_us, uint64_t wall_us){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_profiles.find(profile);
+    if (it == g_profiles.end()) return;
+    NullProfile& p = *it->second;
+    for (auto id : p.owned) g_events.erase(id);
+    p.owned.clear();
+    p.top.clear();
+
+    const uint64_t accel_us = ExecUs();
+    const auto exec = AddEventLocked(p, QNN_PROFILE_EVENTTYPE_EXECUTE, QNN_PROFILE_EVENTUNIT_MICROSEC,
+                                     wall_us, g.name.c_str(), start_us);
+    std::vector<QnnProfile_EventId_t> sub;
+    sub.push_back(AddEventLocked(p, QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_HOST_RPC_TIME_MICROSEC,
+                                 QNN_PROFILE_EVENTUNIT_MICROSEC, wall_us, "host_rpc", start_us));
+    sub.push_back(AddEventLocked(p, QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_HTP_RPC_TIME_MICROSEC,
+                                 QNN_PROFILE_EVENTUNIT_MICROSEC, accel_us, "htp_rpc", start_us));
+    sub.push_back(AddEventLocked(p, QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_MICROSEC,
+                                 QNN_PROFILE_EVENTUNIT_MICROSEC, accel_us, "accel", start_us));
+    if (p.level == QNN_PROFILE_LEVEL_DETAILED && g.num_nodes > 0){
+        // node 시간은 균등 분배
+        for (uint32_t i = 0; i < g.num_nodes; ++i){
+            sub.push_back(AddEventLocked(p, QNN_PROFILE_EVENTTYPE_NODE, QNN_PROFILE_EVENTUNIT_MICROSEC,
+                                         accel_us / g.num_nodes, "null_node", start_us + accel_us * i / g.num_nodes));
+        }
+    }
+    g_events[exec].sub = std::move(sub);
+    p.top.push_back(exec);
+}
+
+static Qnn_ErrorHandle_t NullGraphExecute(Qnn_GraphHandle_t graph, const Qnn_Tensor_t* inputs, uint32_t num_inputs,
+                                          Qnn_Tensor_t* outputs, uint32_t num_outputs,
+                                          Qnn_ProfileHandle_t profile, Qnn_SignalHandle_t){
+    const NullGraph* g = nullptr;
+    {
+        std::lock_guard<std::mutex> lk(g_mu);
+        auto it = g_graphs.find(graph);
+        if (it == g_graphs.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+        g = it->second;
+    }
+    if (!g->finalized) return QNN_COMMON_ERROR_GENERAL;
+    if (num_inputs != g->inputs.size() || num_outputs != g->outputs.size()){
+        std::cerr << "[QNN-null] " << g->name << ": io count mismatch (" << num_inputs << "/" << num_outputs
+                  << " vs " << g->inputs.size() << "/" << g->outputs.size() << ")\n";
+        return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    }
+    if (!CheckIo(inputs, num_inputs) || !CheckIo(outputs, num_outputs)) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+
+    const uint64_t start = NowUs();
+    SimulateLatency(ExecUs(), ExecSpin());
+    g_executes.fetch_add(1, std::memory_order_relaxed);
+
+    if (profile) RecordExecuteEvents(profile, *g, start, NowUs() - start);
+    return QNN_SUCCESS;
+}
+
+// ---------------- mem ----------------
+static Qnn_ErrorHandle_t NullMemRegister(Qnn_ContextHandle_t, const Qnn_MemDescriptor_t* descs,
+                                         uint32_t num, Qnn_MemHandle_t* handles){
+    if (!descs || !handles) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    for (uint32_t i = 0; i < num; ++i){
+        handles[i] = NewHandle<Qnn_MemHandle_t>();
+    }
+    g_mem_registered.fetch_add(num, std::memory_order_relaxed);
+    g_mem_live.fetch_add(num, std::memory_order_relaxed);
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullMemDeRegister(const Qnn_MemHandle_t* handles, uint32_t num){
+    if (!handles) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    g_mem_live.fetch_sub(num, std::memory_order_relaxed);
+    return QNN_SUCCESS;
+}
+
+// ---------------- profile ----------------
+static Qnn_ErrorHandle_t NullProfileCreate(Qnn_BackendHandle_t, QnnProfile_Level_t level, Qnn_ProfileHandle_t* profile){
+    if (!profile) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto p = std::make_unique<NullProfile>();
+    p->level = level;
+    auto h = NewHandle<Qnn_ProfileHandle_t>();
+    std::lock_guard<std::mutex> lk(g_mu);
+    g_profiles[h] = std::move(p);
+    *profile = h;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullProfileSetConfig(Qnn_ProfileHandle_t, const QnnProfile_Config_t**){ return QNN_SUCCESS; }
+
+static Qnn_ErrorHandle_t NullProfileGetEvents(Qnn_ProfileHandle_t profile, const QnnProfile_EventId_t** ids, uint32_t* num){
+    if (!ids || !num) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_profiles.find(profile);
+    if (it == g_profiles.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *ids = it->second->top.data();
+    *num = static_cast<uint32_t>(it->second->top.size());
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullProfileGetSubEvents(QnnProfile_EventId_t id, const QnnProfile_EventId_t** ids, uint32_t* num){
+    if (!ids || !num) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_events.find(id);
+    if (it == g_events.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *ids = it->second.sub.data();
+    *num = static_cast<uint32_t>(it->second.sub.size());
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullProfileGetEventData(QnnProfile_EventId_t id, QnnProfile_EventData_t* data){
+    if (!data) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_events.find(id);
+    if (it == g_events.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *data = it->second.data;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullProfileGetExtendedEventData(QnnProfile_EventId_t id, QnnProfile_ExtendedEventData_t* data){
+    if (!data) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_events.find(id);
+    if (it == g_events.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto& v = data->v1;
+    v.type = it->second.data.type;
+    v.unit = it->second.data.unit;
+    v.value = it->second.data.value;
+    v.identifier = it->second.data.identifier;
+    v.timestamp = it->second.timestamp;
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullProfileFree(Qnn_ProfileHandle_t profile){
+    std::lock_guard<std::mutex> lk(g_mu);
+    auto it = g_profiles.find(profile);
+    if (it == g_profiles.end()) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    for (auto id : it->second->owned) g_events.erase(id);
+    g_profiles.erase(it);
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullPropertyHasCapability(QnnProperty_Key_t){ return QNN_PROPERTY_NOT_SUPPORTED; }
+
+// ---------------- system ----------------
+static Qnn_ErrorHandle_t NullSystemContextCreate(QnnSystemContext_Handle_t* handle){
+    if (!handle) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *handle = reinterpret_cast<QnnSystemContext_Handle_t>(new NullSystemContext());
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullSystemContextFree(QnnSystemContext_Handle_t handle){
+    delete reinterpret_cast<NullSystemContext*>(handle);
+    return QNN_SUCCESS;
+}
+
+static Qnn_Tensor_t ToQnnTensor(NullSystemContext& s, const NullTensor& t){
+    s.strings.push_back(std::make_unique<std::string>(t.name));
+    s.dims.push_back(std::make_unique<std::vector<uint32_t>>(t.dims));
+
+    Qnn_Tensor_t out = QNN_TENSOR_INIT;
+    out.version = QNN_TENSOR_VERSION_2;
+    out.v2 = QNN_TENSOR_V2_INIT;
+    auto* tv = QNN_TENSOR_VER_PTR(out);
+    tv->id = t.id;
+    tv->name = s.strings.back()->c_str();
+    tv->type = static_cast<Qnn_TensorType_t>(t.type);
+    tv->dataType = static_cast<Qnn_DataType_t>(t.dtype);
+    tv->quantizeParams.quantizationEncoding = static_cast<Qnn_QuantizationEncoding_t>(t.q_enc);
+    if (tv->quantizeParams.quantizationEncoding == QNN_QUANTIZATION_ENCODING_SCALE_OFFSET){
+        tv->quantizeParams.encodingDefinition = QNN_DEFINITION_DEFINED;
+        tv->quantizeParams.scaleOffsetEncoding.scale = t.scale;
+        tv->quantizeParams.scaleOffsetEncoding.offset = t.offset;
+    }
+    tv->rank = static_cast<uint32_t>(t.dims.size());
+    tv->dimensions = s.dims.back()->data();
+    tv->memType = QNN_TENSORMEMTYPE_RAW;
+    return out;
+}
+
+static Qnn_ErrorHandle_t NullSystemContextGetBinaryInfo(QnnSystemContext_Handle_t handle, void* buf, uint64_t size,
+                                                        const QnnSystemContext_BinaryInfo_t** info,
+                                                        Qnn_ContextBinarySize_t* info_size){
+    if (!handle || !buf || !info) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    auto& s = *reinterpret_cast<NullSystemContext*>(handle);
+
+    NullContext parsed;
+    if (!Deserialize(buf, size, &parsed)) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+
+    s.graphs.clear();
+    s.graphs.resize(parsed.graphs.size());
+    for (size_t i = 0; i < parsed.graphs.size(); ++i){
+        const NullGraph& g = *parsed.graphs[i];
+        s.strings.push_back(std::make_unique<std::string>(g.name));
+        const char* gname = s.strings.back()->c_str();
+
+        auto in = std::make_unique<std::vector<Qnn_Tensor_t>>();
+        for (const auto& t : g.inputs) in->push_back(ToQnnTensor(s, t));
+        auto out = std::make_unique<std::vector<Qnn_Tensor_t>>();
+        for (const auto& t : g.outputs) out->push_back(ToQnnTensor(s, t));
+
+        auto& gi = s.graphs[i];
+        std::memset(&gi, 0, sizeof(gi));
+        gi.version = QNN_SYSTEM_CONTEXT_GRAPH_INFO_VERSION_1;
+        gi.graphInfoV1.graphName = gname;
+        gi.graphInfoV1.numGraphInputs = static_cast<uint32_t>(in->size());
+        gi.graphInfoV1.graphInputs = in->data();
+        gi.graphInfoV1.numGraphOutputs = static_cast<uint32_t>(out->size());
+        gi.graphInfoV1.graphOutputs = out->data();
+        s.tensors.push_back(std::move(in));
+        s.tensors.push_back(std::move(out));
+    }
+
+    std::memset(&s.info, 0, sizeof(s.info));
+    s.info.version = QNN_SYSTEM_CONTEXT_BINARY_INFO_VERSION_1;
+    auto& v1 = s.info.contextBinaryInfoV1;
+    Qnn_ApiVersion_t api_version{};
+    NullBackendGetApiVersion(&api_version);
+    v1.coreApiVersion = api_version.coreApiVersion;
+    v1.backendApiVersion = api_version.backendApiVersion;
+    v1.buildId = kBuildId;
+    v1.numGraphs = static_cast<uint32_t>(s.graphs.size());
+    v1.graphs = s.graphs.data();
+    v1.hwInfoBlobSize = 0;
+    v1.hwInfoBlob = nullptr;  // no spill-fill
+
+    *info = &s.info;
+    if (info_size) *info_size = sizeof(s.info);
+    return QNN_SUCCESS;
+}
+
+// profile serialization is a no-op (nothing to write for a null device)
+static Qnn_ErrorHandle_t NullSystemProfileCreateSerializationTarget(QnnSystemProfile_SerializationTarget_t,
+                                                                   QnnSystemProfile_SerializationTargetConfig_t*, uint32_t,
+                                                                   QnnSystemProfile_SerializationTargetHandle_t* handle){
+    if (!handle) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *handle = NewHandle<QnnSystemProfile_SerializationTargetHandle_t>();
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullSystemProfileSerializeEventData(QnnSystemProfile_SerializationTargetHandle_t,
+                                                            const QnnSystemProfile_ProfileData_t**, uint32_t){
+    return QNN_SUCCESS;
+}
+
+static Qnn_ErrorHandle_t NullSystemProfileFreeSerializationTarget(QnnSystemProfile_SerializationTargetHandle_t){
+    return QNN_SUCCESS;
+}
+
+// ---------------- providers ----------------
+static QnnInterface_t MakeInterface(){
+    QnnInterface_t i{};
+    i.backendId = kNullBackendId;
+    i.providerName = "NULL_QTI_AISW";
+    NullBackendGetApiVersion(&i.apiVersion);
+
+    auto& api = i.QNN_INTERFACE_VER_NAME;
+    api.propertyHasCapability = NullPropertyHasCapability;
+    api.backendCreate = NullBackendCreate;
+    api.backendSetConfig = NullBackendSetConfig;
+    api.backendGetApiVersion = NullBackendGetApiVersion;
+    api.backendGetBuildId = NullBackendGetBuildId;
+    api.backendRegisterOpPackage = NullBackendRegisterOpPackage;
+    api.backendValidateOpConfig = NullBackendValidateOpConfig;
+    api.backendFree = NullBackendFree;
+    api.contextCreate = NullContextCreate;
+    api.contextSetConfig = NullContextSetConfig;
+    api.contextGetBinarySize = NullContextGetBinarySize;
+    api.contextGetBinary = NullContextGetBinary;
+    api.contextCreateFromBinary = NullContextCreateFromBinary;
+    api.contextFree = NullContextFree;
+    api.graphCreate = NullGraphCreate;
+    api.graphSetConfig = NullGraphSetConfig;
+    api.graphAddNode = NullGraphAddNode;
+    api.graphFinalize = NullGraphFinalize;
+    api.graphRetrieve = NullGraphRetrieve;
+    api.graphExecute = NullGraphExecute;
+    api.tensorCreateContextTensor = NullTensorCreateContextTensor;
+    api.tensorCreateGraphTensor = NullTensorCreateGraphTensor;
+    api.logCreate = NullLogCreate;
+    api.logSetLogLevel = NullLogSetLogLevel;
+    api.logFree = NullLogFree;
+    api.profileCreate = NullProfileCreate;
+    api.profileSetConfig = NullProfileSetConfig;
+    api.profileGetEvents = NullProfileGetEvents;
+    api.profileGetSubEvents = NullProfileGetSubEvents;
+    api.profileGetEventData = NullProfileGetEventData;
+    api.profileGetExtendedEventData = NullProfileGetExtendedEventData;
+    api.profileFree = NullProfileFree;
+    api.memRegister = NullMemRegister;
+    api.memDeRegister = NullMemDeRegister;
+    api.deviceGetInfrastructure = NullDeviceGetInfrastructure;
+    api.deviceCreate = NullDeviceCreate;
+    api.deviceSetConfig = NullDeviceSetConfig;
+    api.deviceFree = NullDeviceFree;
+    return i;
+}
+
+static QnnSystemInterface_t MakeSystemInterface(){
+    QnnSystemInterface_t i{};
+    i.backendId = kNullBackendId;
+    i.providerName = "NULL_SYSTEM_QTI_AISW";
+    i.systemApiVersion.major = QNN_SYSTEM_API_VERSION_MAJOR;
+    i.systemApiVersion.minor = QNN_SYSTEM_API_VERSION_MINOR;
+    i.systemApiVersion.patch = QNN_SYSTEM_API_VERSION_PATCH;
+
+    auto& api = i.QNN_SYSTEM_INTERFACE_VER_NAME;
+    api.systemContextCreate = NullSystemContextCreate;
+    api.systemContextGetBinaryInfo = NullSystemContextGetBinaryInfo;
+    api.systemContextFree = NullSystemContextFree;
+    api.systemProfileCreateSerializationTarget = NullSystemProfileCreateSerializationTarget;
+    api.systemProfileSerializeEventData = NullSystemProfileSerializeEventData;
+    api.systemProfileFreeSerializationTarget = NullSystemProfileFreeSerializationTarget;
+    return i;
+}
+
+NULL_EXPORT Qnn_ErrorHandle_t QnnInterface_getProviders(const QnnInterface_t*** providers, uint32_t* num){
+    static const QnnInterface_t iface = MakeInterface();
+    static const QnnInterface_t* list[] = {&iface};
+    if (!providers || !num) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *providers = list;
+    *num = 1;
+    return QNN_SUCCESS;
+}
+
+NULL_EXPORT Qnn_ErrorHandle_t QnnSystemInterface_getProviders(const QnnSystemInterface_t*** providers, uint32_t* num){
+    static const QnnSystemInterface_t iface = MakeSystemInterface();
+    static const QnnSystemInterface_t* list[] = {&iface};
+    if (!providers || !num) return QNN_COMMON_ERROR_INVALID_ARGUMENT;
+    *providers = list;
+    *num = 1;
+    return QNN_SUCCESS;
+}
+
+// ---------------- rpcmem (QNN_RPCMEM_LIB=libQnnNull.so) ----------------
+// memfd backed, so (fd, offset) is a real shareable mapping like ION/dmabuf
+struct RpcMemBlock{
+    int fd;
+    size_t size;
+};
+static std::mutex g_rpc_mu;
+// never destroyed: SharedBuffer trims its pool (rpcmem_free) from its own static destructor at exit,
+// which may run after this library's statics are gone
+static std::map<uintptr_t, RpcMemBlock>& g_rpc_blocks = *new std::map<uintptr_t, RpcMemBlock>();
+
+NULL_EXPORT void* rpcmem_alloc(int /*heapid*/, uint32_t /*flags*/, int size){
+    if (size <= 0) return nullptr;
+    const int fd = memfd_create("qnn_null_rpcmem", 0);
+    if (fd < 0) return nullptr;
+    if (ftruncate(fd, size) != 0){
+        close(fd);
+        return nullptr;
+    }
+    void* p = mmap(nullptr, static_cast<size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED){
+        close(fd);
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lk(g_rpc_mu);
+    g_rpc_blocks[reinterpret_cast<uintptr_t>(p)] = RpcMemBlock{fd, static_cast<size_t>(size)};
+    return p;
+}
+
+NULL_EXPORT void rpcmem_free(void* p){
+    std::lock_guard<std::mutex> lk(g_rpc_mu);
+    auto it = g_rpc_blocks.find(reinterpret_cast<uintptr_t>(p));
+    if (it == g_rpc_blocks.end()) return;
+    munmap(p, it->second.size);
+    close(it->second.fd);
+    g_rpc_blocks.erase(it);
+}
+
+NULL_EXPORT int rpcmem_to_fd(void* p){
+    const uintptr_t a = reinterpret_cast<uintptr_t>(p);
+    std::lock_guard<std::mutex> lk(g_rpc_mu);
+    auto it = g_rpc_blocks.upper_bound(a);
+    if (it == g_rpc_blocks.begin()) return -1;
+    --it;
+    if (a >= it->first + it->second.size) return -1;
+    return it->second.fd;
+}
@@ -0,0 +1,535 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "QnnCommon.h"
+#include "QnnInterface.h"
+#include "QnnLog.h"
+#include "QnnTypes.h"
+#include "qnn_backend.h"
+#include "qnn_backendcache.h"
+#include "qnn_context.h"
+#include "qnn_device.h"
+#include "qnn_dynload.h"
+#include "qnn_graph.h"
+#include "qnn_log.h"
+#include "qnn_mem_manager.h"
+#include "qnn_mem_telemetry.h"
+#include "qnn_multi_context.h"
+#include "qnn_prefix_cache.h"
+#include "qnn_sharedbuffer.h"
+#include "qnn_tensor.h"
+
+// ./qnn_bench [--warmup N] [--iters N] [--graph name]... [--prefill-tokens N] [--power profile] [--outputs shared|raw]
+//             [--prefix-cache-mb N [--prefix-chunk T] [--prefix-share F]] [--out result.json] ctx0.bin [ctx1.bin ...]
+//   --power : none(default) | burst | sustained | balanced | power_saver, HTP perf vote held for the whole run
+//   --outputs : shared(default, registered arena slices, written in place) | raw (host vectors, backend copies out)
+//   --prefix-cache-mb : prefill graphs go through a QnnPrefixCache with this budget (0 = off).
+//       every iteration is one request; --prefix-share F keeps the first F of the prompt tokens
+//       identical across requests (default 1.0) and re-randomizes the rest, --prefix-chunk T tokens per page (16)
+//
+// main_run.cpp 은 한 번 실행 + dump + cpu reference 용이라 반복 측정이 안 된다.
+// 여기서는 IO를 한 번만 bind 하고 warmup + measured iteration 을 돌려서 JSON 으로 남긴다.
+// (script/bench_compare.py 로 두 결과 비교)
+
+struct BenchArgs{
+    int warmup{10};
+    int iters{100};
+    int prefill_tokens{0};   // 0 => input dims[1] of prefill graphs
+    std::vector<std::string> graphs;  // empty => every graph in every binary
+    std::vector<std::string> bins;
+    std::string out{"bench_result.json"};
+    std::string power{"none"};
+    bool raw_outputs{false};
+    size_t prefix_cache_mb{0};
+    int prefix_chunk{16};
+    double prefix_share{1.0};
+};
+
+// prefill through the prefix cache: prompt = token-major inputs ([1, L, ...]),
+// page of chunk c = rows [c*T, (c+1)*T) of every output (all outputs must be token-major too)
+struct PrefixBench{
+    std::unique_ptr<QnnPrefixCache> cache;
+    size_t tokens{0};                 // L
+    std::vector<size_t> tok_inputs;   // input indices that carry the prompt
+    std::vector<size_t> in_row_bytes;
+    std::vector<size_t> out_row_bytes;
+    QnnPrefixKey root;                // covers the non-token inputs
+    uint64_t skipped_execs{0};
+    uint64_t matched_tokens{0};
+    uint64_t prompt_tokens{0};
+};
+
+struct GraphBench{
+    std::string name;
+    size_t bin_idx{0};
+    std::unique_ptr<QnnGraphRuntime> graph;
+    QnnGraphBinding io;
+    std::vector<std::vector<uint8_t>> output_bufs;  // --outputs raw only
+    double retrieve_ms{0};
+    int tokens_per_exec{1};
+    bool is_prefill{false};
+    std::vector<void*> in_ptrs;
+    std::vector<void*> out_ptrs;
+    std::unique_ptr<PrefixBench> prefix;  // --prefix-cache-mb, prefill only
+    std::vector<double> samples_us;
+};
+
+static double MsSince(std::chrono::steady_clock::time_point t0){
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static double Percentile(const std::vector<double>& sorted, double p){
+    if (sorted.empty()) return 0;
+    const double rank = p * (sorted.size() - 1);
+    const size_t lo = static_cast<size_t>(rank);
+    const size_t hi = std::min(lo + 1, sorted.size() - 1);
+    const double frac = rank - lo;
+    return sorted[lo] * (1.0 - frac) + sorted[hi] * frac;
+}
+
+static std::string JsonEscape(const std::string& s){
+    std::string out;
+    for (char c : s){
+        if (c == '"' || c == '\\') out.push_back('\\');
+        out.push_back(c);
+    }
+    return out;
+}
+
+static bool ParseArgs(int argc, char** argv, BenchArgs& a){
+    for (int i = 1; i < argc; ++i){
+        const std::string s = argv[i];
+        auto next = [&](const char* what) -> const char*{
+            if (i + 1 >= argc){
+                std::cerr << what << " needs a value\n";
+                return nullptr;
+            }
+            return argv[++i];
+        };
+        const char* v = nullptr;
+        if (s == "--warmup"){ if (!(v = next("--warmup"))) return false; a.warmup = std::stoi(v); }
+        else if (s == "--iters"){ if (!(v = next("--iters"))) return false; a.iters = std::stoi(v); }
+        else if (s == "--graph"){ if (!(v = next("--graph"))) return false; a.graphs.emplace_back(v); }
+        else if (s == "--prefill-tokens"){ if (!(v = next("--prefill-tokens"))) return false; a.prefill_tokens = std::stoi(v); }
+        else if (s == "--out"){ if (!(v = next("--out"))) return false; a.out = v; }
+        else if (s == "--power"){ if (!(v = next("--power"))) return false; a.power = v; }
+        else if (s == "--prefix-cache-mb"){ if (!(v = next("--prefix-cache-mb"))) return false; a.prefix_cache_mb = std::stoul(v); }
+        else if (s == "--prefix-chunk"){ if (!(v = next("--prefix-chunk"))) return false; a.prefix_chunk = std::stoi(v); }
+        else if (s == "--prefix-share"){ if (!(v = next("--prefix-share"))) return false; a.prefix_share = std::stod(v); }
+        else if (s == "--outputs"){
+            if (!(v = next("--outputs"))) return false;
+            if (std::string(v) != "shared" && std::string(v) != "raw"){
+                std::cerr << "unknown --outputs " << v << "\n";
+                return false;
+            }
+            a.raw_outputs = std::string(v) == "raw";
+        }
+        else if (s.rfind("--", 0) == 0){ std::cerr << "unknown option " << s << "\n"; return false; }
+        else a.bins.push_back(s);
+    }
+    if (a.bins.empty()) a.bins.emplace_back("multi_graph.bin");
+    if (a.iters <= 0){
+        std::cerr << "--iters must be > 0\n";
+        return false;
+    }
+    if (a.prefix_chunk <= 0 || a.prefix_share < 0.0 || a.prefix_share > 1.0){
+        std::cerr << "--prefix-chunk must be > 0 and --prefix-share in [0, 1]\n";
+        return false;
+    }
+    QnnHtpPowerProfile p;
+    if (a.power != "none" && !QnnHtpPerfRuntime::ProfileFromStr(a.power, &p)){
+        std::cerr << "unknown --power " << a.power << "\n";
+        return false;
+    }
+    return true;
+}
+
+// [1, L, ...] => bytes of one token row, 0 if t is not token-major
+static size_t TokenRowBytes(const Qnn_Tensor_t& t, size_t tokens){
+    auto* tv = QNN_TENSOR_VER_PTR(t);
+    if (tv->rank < 2 || tv->dimensions[0] != 1 || tv->dimensions[1] != tokens) return 0;
+    return QnnTensor::MetaBytes(t) / tokens;
+}
+
+static bool SetupPrefixCache(GraphBench& gb, const BenchArgs& args){
+    auto* tv0 = QNN_TENSOR_VER_PTR(gb.io.inputs[0]);
+    const size_t tokens = tv0->rank >= 2 ? tv0->dimensions[1] : 0;
+    const size_t chunk = static_cast<size_t>(args.prefix_chunk);
+    if (!tokens || tokens % chunk){
+        std::cerr << "[bench] " << gb.name << ": prefix cache off (" << tokens << " tokens, chunk " << chunk << ")\n";
+        return true;
+    }
+    auto pb = std::make_unique<PrefixBench>();
+    pb->tokens = tokens;
+    QnnPrefixKey seed = QnnPrefixCache::Root();
+    for (size_t i = 0; i < gb.io.inputs.size(); ++i){
+        const size_t row = TokenRowBytes(gb.io.inputs[i], tokens);
+        if (row){
+            pb->tok_inputs.push_back(i);
+            pb->in_row_bytes.push_back(row);
+        } else {
+            seed = QnnPrefixCache::Extend(seed, gb.in_ptrs[i], QnnTensor::MetaBytes(gb.io.inputs[i]));
+        }
+    }
+    size_t page_bytes = 0;
+    for (const auto& t : gb.io.outputs){
+        const size_t row = TokenRowBytes(t, tokens);
+        if (!row){
+            // a skipped execute would leave this output stale
+            std::cerr << "[bench] " << gb.name << ": prefix cache off (output " << QNN_TENSOR_VER_PTR(t)->name
+                      << " is not [1, L, ...])\n";
+            return true;
+        }
+        pb->out_row_bytes.push_back(row);
+        page_bytes += row * chunk;
+    }
+    if (pb->tok_inputs.empty()){
+        std::cerr << "[bench] " << gb.name << ": prefix cache off (no [1, L, ...] input)\n";
+        return true;
+    }
+    pb->root = QnnPrefixCache::Root(seed.hash);
+    pb->cache = std::make_unique<QnnPrefixCache>();
+    if (!pb->cache->Init(chunk, page_bytes, args.prefix_cache_mb << 20)) return false;
+    gb.prefix = std::move(pb);
+    std::cout << "[bench] " << gb.name << ": prefix cache " << args.prefix_cache_mb << " MiB, "
+              << tokens / chunk << " chunks of " << chunk << " tokens, page " << page_bytes << " bytes\n";
+    return true;
+}
+
+// one request: longest cached prefix, then execute + cache the rest.
+// prefill graph는 past length 입력이 없는 고정 [1, L] graph라 suffix만 돌릴 수는 없다:
+// 전체가 hit일 때만 execute를 건너뛰고, 부분 hit이면 그냥 다 돌린 뒤 새 chunk만 채운다.
+static bool RunPrefillWithPrefixCache(GraphBench& gb, const QnnInterface_t* be){
+    PrefixBench& pb = *gb.prefix;
+    QnnPrefixCache& cache = *pb.cache;
+    const size_t T = cache.ChunkTokens();
+    const size_t n = pb.tokens / T;
+
+    std::vector<QnnPrefixKey> chain(n);
+    QnnPrefixKey k = pb.root;
+    for (size_t c = 0; c < n; ++c){
+        for (size_t j = 0; j < pb.tok_inputs.size(); ++j){
+            const uint8_t* in = static_cast<const uint8_t*>(gb.in_ptrs[pb.tok_inputs[j]]);
+            k = QnnPrefixCache::Extend(k, in + c * T * pb.in_row_bytes[j], T * pb.in_row_bytes[j]);
+        }
+        chain[c] = k;
+    }
+    std::vector<const void*> pages;
+    const size_t m = cache.Lookup(chain, &pages);
+    pb.matched_tokens += m * T;
+    pb.prompt_tokens += pb.tokens;
+
+    bool ok = true;
+    if (m == n){
+        for (size_t c = 0; c < n; ++c){
+            const uint8_t* src = static_cast<const uint8_t*>(pages[c]);
+            for (size_t o = 0; o < gb.out_ptrs.size(); ++o){
+                const size_t chunk_bytes = T * pb.out_row_bytes[o];
+                std::memcpy(static_cast<uint8_t*>(gb.out_ptrs[o]) + c * chunk_bytes, src, chunk_bytes);
+                src += chunk_bytes;
+            }
+        }
+        ++pb.skipped_execs;
+    } else {
+        Qnn_ErrorHandle_t err = be->QNN_INTERFACE_VER_NAME.graphExecute(
+            gb.graph->Handle(),
+            gb.io.inputs.data(), static_cast<uint32_t>(gb.io.inputs.size()),
+            gb.io.outputs.data(), static_cast<uint32_t>(gb.io.outputs.size()),
+            /*profile=*/nullptr, /*signal=*/nullptr);
+        if (err != QNN_SUCCESS){
+            std::cerr << "[QNN] graphExecute failed for " << gb.name << ", err=" << QNN_GET_ERROR_CODE(err) << "\n";
+            ok = false;
+        }
+        for (size_t c = m; ok && c < n; ++c){
+            uint8_t* dst = static_cast<uint8_t*>(cache.Insert(c ? chain[c - 1] : pb.root, chain[c]));
+            if (!dst) break;  // budget full of pinned pages; the rest of the chain would be unreachable anyway
+            for (size_t o = 0; o < gb.out_ptrs.size(); ++o){
+                const size_t chunk_bytes = T * pb.out_row_bytes[o];
+                std::memcpy(dst, static_cast<const uint8_t*>(gb.out_ptrs[o]) + c * chunk_bytes, chunk_bytes);
+                dst += chunk_bytes;
+            }
+            cache.Unpin(chain[c]);
+        }
+    }
+    for (size_t c = 0; c < m; ++c) cache.Unpin(chain[c]);
+    return ok;
+}
+
+int main(int argc, char** argv){
+    BenchArgs args;
+    if (!ParseArgs(argc, argv, args)) return -1;
+
+    const auto t_total = std::chrono::steady_clock::now();
+
+    // ---- init: backend load ----
+    auto t0 = std::chrono::steady_clock::now();
+    auto& qnn = QnnDynLoad::Instance();
+    if (!qnn.LoadAll("libQnnHtp.so", "libQnnSystem.so")){
+        std::cerr << "Failed to load QNN backend or system\n";
+        return -1;
+    }
+    Qnn_LogHandle_t logHandle = nullptr;
+    if (!CreateQnnLogger(qnn.Backend(), &logHandle, QNN_LOG_LEVEL_WARN)){
+        std::cerr << "Failed to create QNN logger\n";
+        return -1;
+    }
+    QnnBackendRuntime backend;
+    if (!backend.Create(qnn.Backend(), logHandle)){
+        std::cerr << "backendCreate failed\n";
+        return -1;
+    }
+    QnnDeviceRuntime device;
+    QnnHtpPowerProfile power;
+    if (QnnHtpPerfRuntime::ProfileFromStr(args.power, &power)) device.EnablePerfVote(power);
+    if (!device.Create(qnn.Backend(), logHandle)){
+        std::cerr << "deviceCreate failed\n";
+        return -1;
+    }
+    const double load_ms = MsSince(t0);
+
+    // ---- init: read + parse binaries ----
+    t0 = std::chrono::steady_clock::now();
+    QnnMultiContextRuntime contexts;
+    if (!contexts.LoadBinaries(qnn.System(), args.bins)){
+        std::cerr << "LoadBinaries failed\n";
+        return -1;
+    }
+    const double parse_ms = MsSince(t0);
+
+    // ---- init: contextCreateFromBinary (no profiler, bench measures the plain path) ----
+    t0 = std::chrono::steady_clock::now();
+    if (!contexts.Create(qnn.Backend(), backend.Handle(), device.Handle(), /*profile_handle=*/nullptr)){
+        std::cerr << "contextCreateFromBinary failed\n";
+        return -1;
+    }
+    const double ctx_create_ms = MsSince(t0);
+
+    // ---- init: graphRetrieve ----
+    std::vector<GraphBench> benches;
+    for (size_t b = 0; b < contexts.Size(); ++b){
+        for (const auto& name : contexts.Cache(b).GraphNames()){
+            if (!args.graphs.empty() &&
+                std::find(args.graphs.begin(), args.graphs.end(), name) == args.graphs.end()) continue;
+            GraphBench gb;
+            gb.name = name;
+            gb.bin_idx = b;
+            gb.graph = std::make_unique<QnnGraphRuntime>();
+            gb.graph->SetRestoreMode(true);
+            t0 = std::chrono::steady_clock::now();
+            if (!gb.graph->Create(qnn.Backend(), contexts.Context(b).Handle(), nullptr, name)){
+                std::cerr << "graphRetrieve failed for " << name << "\n";
+                return -1;
+            }
+            gb.retrieve_ms = MsSince(t0);
+            gb.io = contexts.Cache(b).MakeBinding(name);
+            benches.push_back(std::move(gb));
+        }
+    }
+    if (benches.empty()){
+        std::cerr << "no graph to benchmark\n";
+        return -1;
+    }
+    double retrieve_ms = 0;
+    for (const auto& gb : benches) retrieve_ms += gb.retrieve_ms;
+
+    // ---- bind IO once ----
+    size_t arena_bytes = 0;
+    for (const auto& gb : benches){
+        for (const auto& t : gb.io.inputs) arena_bytes += QnnTensor::MetaBytes(t) + 64;
+        if (!args.raw_outputs)
+            for (const auto& t : gb.io.outputs) arena_bytes += QnnTensor::MetaBytes(t) + 64;
+    }
+
+    auto& sb = SharedBuffer::Instance();
+    SharedBuffer::Arena arena;
+    if (!sb.ArenaCreate(arena, arena_bytes, 64)){
+        std::cerr << "ArenaCreate failed\n";
+        return -1;
+    }
+
+    // mem handles are per context
+    std::vector<std::unique_ptr<QnnMemManagerRuntime>> mems(contexts.Size());
+    for (size_t b = 0; b < contexts.Size(); ++b){
+        mems[b] = std::make_unique<QnnMemManagerRuntime>();
+        mems[b]->Init(qnn.Backend(), &contexts.Context(b));
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    for (auto& gb : benches){
+        // inputs (+ outputs unless raw) of one graph in one memRegister
+        std::vector<Qnn_Tensor_t*> tensors;
+        std::vector<size_t> bytes;
+        for (auto& t : gb.io.inputs){
+            tensors.push_back(&t);
+            bytes.push_back(QnnTensor::MetaBytes(t));
+        }
+        if (!args.raw_outputs){
+            for (auto& t : gb.io.outputs){
+                tensors.push_back(&t);
+                bytes.push_back(QnnTensor::MetaBytes(t));
+            }
+        }
+        std::vector<void*> ptrs;
+        std::vector<Qnn_MemHandle_t> handles;
+        if (!mems[gb.bin_idx]->RegisterTensorsInSharedArena(sb, arena, tensors, bytes, 64, &ptrs, &handles)){
+            std::cerr << "RegisterTensorsInSharedArena failed for " << gb.name << "\n";
+            return -1;
+        }
+        gb.in_ptrs.assign(ptrs.begin(), ptrs.begin() + gb.io.inputs.size());
+        if (!args.raw_outputs) gb.out_ptrs.assign(ptrs.begin() + gb.io.inputs.size(), ptrs.end());
+        for (size_t i = 0; i < gb.io.inputs.size(); ++i){
+            if (QNN_TENSOR_VER_PTR(gb.io.inputs[i])->dataType == QNN_DATATYPE_FLOAT_32){
+                float* p = reinterpret_cast<float*>(ptrs[i]);
+                for (size_t k = 0; k < bytes[i] / sizeof(float); ++k) p[k] = dist(rng);
+            } else {
+                std::memset(ptrs[i], 0, bytes[i]);
+            }
+        }
+        if (args.raw_outputs){
+            gb.output_bufs.resize(gb.io.outputs.size());
+            for (size_t i = 0; i < gb.io.outputs.size(); ++i){
+                auto* tv = QNN_TENSOR_VER_PTR(gb.io.outputs[i]);
+                const size_t out_bytes = QnnTensor::MetaBytes(gb.io.outputs[i]);
+                gb.output_bufs[i].assign(out_bytes, 0);
+                tv->memType = QNN_TENSORMEMTYPE_RAW;
+                tv->clientBuf.data = gb.output_bufs[i].data();
+                tv->clientBuf.dataSize = static_cast<uint32_t>(out_bytes);
+                gb.out_ptrs.push_back(gb.output_bufs[i].data());
+            }
+        }
+
+        // tokens per execute: prefill consumes L tokens ([B, L, D] input), decode one
+        gb.is_prefill = gb.name.find("prefill") != std::string::npos;
+        if (gb.is_prefill){
+            auto* tv = QNN_TENSOR_VER_PTR(gb.io.inputs[0]);
+            gb.tokens_per_exec = args.prefill_tokens > 0 ? args.prefill_tokens
+                               : (tv->rank >= 2 ? static_cast<int>(tv->dimensions[1]) : 1);
+            if (args.prefix_cache_mb && !SetupPrefixCache(gb, args)) return -1;
+        }
+    }
+
+    // ---- run ----
+    auto& api = qnn.Backend()->QNN_INTERFACE_VER_NAME;
+    for (auto& gb : benches){
+        gb.samples_us.reserve(args.iters);
+        for (int it = 0; it < args.warmup + args.iters; ++it){
+            if (gb.prefix){
+                // new request: keep the shared prefix, re-randomize the rest of the prompt (untimed)
+                PrefixBench& pb = *gb.prefix;
+                const size_t keep = static_cast<size_t>(args.prefix_share * pb.tokens);
+                for (size_t j = 0; it > 0 && keep < pb.tokens && j < pb.tok_inputs.size(); ++j){
+                    const size_t i = pb.tok_inputs[j];
+                    if (QNN_TENSOR_VER_PTR(gb.io.inputs[i])->dataType != QNN_DATATYPE_FLOAT_32) continue;
+                    float* p = reinterpret_cast<float*>(static_cast<uint8_t*>(gb.in_ptrs[i]) + keep * pb.in_row_bytes[j]);
+                    const size_t n = (pb.tokens - keep) * pb.in_row_bytes[j] / sizeof(float);
+                    for (size_t k = 0; k < n; ++k) p[k] = dist(rng);
+                }
+                const auto s = std::chrono::steady_clock::now();
+                if (!RunPrefillWithPrefixCache(gb, qnn.Backend())) return -1;
+                const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s).count();
+                if (it >= args.warmup) gb.samples_us.push_back(us);
+                continue;
+            }
+            const auto s = std::chrono::steady_clock::now();
+            Qnn_ErrorHandle_t err = api.graphExecute(
+                gb.graph->Handle(),
+                gb.io.inputs.data(), static_cast<uint32_t>(gb.io.inputs.size()),
+                gb.io.outputs.data(), static_cast<uint32_t>(gb.io.outputs.size()),
+                /*profile=*/nullptr, /*signal=*/nullptr);
+            const double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s).count();
+            if (err != QNN_SUCCESS){
+                std::cerr << "[QNN] graphExecute failed for " << gb.name << ", err=" << QNN_GET_ERROR_CODE(err) << "\n";
+                return -1;
+            }
+            if (it >= args.warmup) gb.samples_us.push_back(us);
+        }
+        std::cout << "[bench] " << gb.name << " done (" << args.iters << " iters)\n";
+    }
+
+    // ---- report ----
+    const char* build_id = nullptr;
+    if (api.backendGetBuildId) (void)api.backendGetBuildId(&build_id);
+
+    std::ofstream js(args.out, std::ios::trunc);
+    if (!js.good()){
+        std::cerr << "failed to open " << args.out << "\n";
+        return -1;
+    }
+    js << "{\n";
+    js << "  \"schema\": 1,\n";
+    js << "  \"timestamp\": " << static_cast<long long>(std::time(nullptr)) << ",\n";
+    js << "  \"backend_build_id\": \"" << JsonEscape(build_id ? build_id : "") << "\",\n";
+    js << "  \"binaries\": [";
+    for (size_t b = 0; b < args.bins.size(); ++b) js << (b ? ", " : "") << "\"" << JsonEscape(args.bins[b]) << "\"";
+    js << "],\n";
+    js << "  \"warmup\": " << args.warmup << ",\n";
+    js << "  \"iters\": " << args.iters << ",\n";
+    js << "  \"power\": \"" << (device.Perf() ? args.power : std::string("none")) << "\",\n";
+    js << "  \"outputs\": \"" << (args.raw_outputs ? "raw" : "shared") << "\",\n";
+    js << "  \"init_ms\": {\"load\": " << load_ms << ", \"parse_binary\": " << parse_ms
+       << ", \"context_create_from_binary\": " << ctx_create_ms
+       << ", \"graph_retrieve\": " << retrieve_ms << "},\n";
+    js << "  \"graphs\": [\n";
+    for (size_t g = 0; g < benches.size(); ++g){
+        const auto& gb = benches[g];
+        std::vector<double> sorted = gb.samples_us;
+        std::sort(sorted.begin(), sorted.end());
+        double sum = 0;
+        for (double v : sorted) sum += v;
+        const double mean = sum / sorted.size();
+        const double p50 = Percentile(sorted, 0.50);
+
+        js << "    {\"name\": \"" << JsonEscape(gb.name) << "\", \"binary\": \"" << JsonEscape(contexts.Path(gb.bin_idx)) << "\""
+           << ", \"kind\": \"" << (gb.is_prefill ? "prefill" : "decode") << "\""
+           << ", \"tokens_per_exec\": " << gb.tokens_per_exec
+           << ", \"graph_retrieve_ms\": " << gb.retrieve_ms << ",\n";
+        js << "     \"latency_us\": {\"min\": " << sorted.front() << ", \"mean\": " << mean
+           << ", \"p50\": " << p50 << ", \"p90\": " << Percentile(sorted, 0.90)
+           << ", \"p99\": " << Percentile(sorted, 0.99) << ", \"max\": " << sorted.back() << "},\n";
+        js << "     \"tokens_per_sec\": " << (gb.tokens_per_exec * 1e6 / mean) << ",\n";
+        if (gb.prefix){
+            const PrefixBench& pb = *gb.prefix;
+            const QnnPrefixCache::Stats st = pb.cache->GetStats();
+            js << "     \"prefix_cache\": {\"budget_mb\": " << args.prefix_cache_mb << ", \"chunk_tokens\": " << args.prefix_chunk
+               << ", \"share\": " << args.prefix_share << ", \"skipped_execs\": " << pb.skipped_execs
+               << ", \"matched_tokens\": " << pb.matched_tokens << ", \"prompt_tokens\": " << pb.prompt_tokens
+               << ", \"entries\": " << st.entries << ", \"bytes\": " << st.bytes
+               << ", \"inserts\": " << st.inserts << ", \"evictions\": " << st.evictions << "},\n";
+            std::cout << "[bench] " << gb.name << " prefix cache: matched " << pb.matched_tokens << "/" << pb.prompt_tokens
+                      << " tokens, skipped " << pb.skipped_execs << " executes, " << st.entries << " pages ("
+                      << st.bytes << " bytes), " << st.evictions << " evictions\n";
+        }
+        js << "     \"samples_us\": [";
+        for (size_t k = 0; k < gb.samples_us.size(); ++k) js << (k ? "," : "") << gb.samples_us[k];
+        js << "]}" << (g + 1 == benches.size() ? "\n" : ",\n");
+
+        std::cout << "[bench] " << gb.name << " p50=" << p50 << "us mean=" << mean
+                  << "us p99=" << Percentile(sorted, 0.99) << "us tok/s=" << (gb.tokens_per_exec * 1e6 / mean) << "\n";
+    }
+    js << "  ],\n";
+    js << "  \"peak_rss_kb\": " << QnnMemTelemetry::PeakRssKb() << ",\n";
+    js << "  \"memory\": ";
+    QnnMemTelemetry::Instance().DumpJson(js);
+    js << ",\n";
+    js << "  \"total_ms\": " << MsSince(t_total) << "\n";
+    js << "}\n";
+    js.close();
+    std::cout << "[bench] wrote " << args.out << "\n";
+
+    // graphs before contexts
+    benches.clear();
+    mems.clear();
+    contexts.Destroy();
+    sb.ArenaDestroy(arena);
+    return 0;
+}
@@ -7,11 +7,15 @@
 #include <cmath>
 #include <vector>
 #include <algorithm>
+#include <future>
+#include <memory>
+#include <unordered_map>
 
 #include "QnnCommon.h"
 #include "QnnInterface.h"
 #include "QnnLog.h"
 #include "QnnTypes.h"
+#include "HTP/QnnHtpProfile.h"
 #include "qnn_device.h"
 #include "qnn_dynload.h"
 #include "qnn_backend.h"
@@ -22,7 +26,17 @@
 #include "qnn_tensor.h"
 #include "qnn_backendcache.h"
 #include "qnn_mem_manager.h"
+#include "qnn_multi_context.h"
+#include "qnn_graph_registry.h"
+#include "qnn_warmup.h"
+#include "qnn_shard.h"
+#include "qnn_trace.h"
+#include "qnn_latency.h"
+#include "qnn_mem_telemetry.h"
 #include "qnn_log.h"
+#include "qnn_cpu_ref.h"
+#include "qnn_kv_cache.h"
+#include "qnn_scheduler.h"
 
 static bool load_f32_raw(const std::string& path, std::vector<float>& out, size_t numel) {
   out.resize(numel);
@@ -42,68 +56,23 @@ static bool load_f32_raw(const std::string& path, std::vector<float>& out, size_
   return true;
 }
 
-// reference cpu code
-// A: [B, M, K]
-// B: if (!transposeB) [BB, K, N]
-//    if ( transposeB) [BB, N, K]  (we use B^T in multiplication)
-//    BB must be 1 or B
-// Out: [B, M, N]
-static void batch_matmul_f32(
-    const float* A,
-    const float* Bm,
-    float* Out,
-    int B, int M, int K, int N, int BB,
-    bool transposeB)
-{
-  // zero init
-  for (int b = 0; b < B; ++b) {
-    for (int i = 0; i < M; ++i) {
-      for (int j = 0; j < N; ++j) {
-        Out[((b*M + i)*N) + j] = 0.0f;
-      }
-    }
-  }
-
-  for (int b = 0; b < B; ++b) {
-    const float* Ab = A  + (size_t)b * M * K;
-    const float* Bb;
-    if(BB == 1){
-        Bb = Bm;
-    } else{
-        // BB == B
-        Bb = Bm + (size_t)b * (transposeB ? (size_t)N*K : (size_t)K*N);
-    }
-    
-    float* Ob       = Out+ (size_t)b * M * N;
-
-    for (int i = 0; i < M; ++i) {
-      for (int j = 0; j < N; ++j) {
-        float acc = 0.0f;
-        for (int k = 0; k < K; ++k) {
-          const float a = Ab[(size_t)i*K + k];
-
-          // 핵심: transposeB면 B의 "원본" shape이 [N, K]
-          // 곱셈에서는 B^T를 쓰므로, B^T의 (k, j)는 원본 B의 (j, k)
-          const float bval = transposeB
-              ? Bb[(size_t)j*K + k]   // B_original[j, k]
-              : Bb[(size_t)k*N + j];  // B_original[k, j]
-
-          acc += a * bval;
-        }
-        Ob[(size_t)i*N + j] = acc;
-      }
-    }
-  }
-}
+// output bytes after execute, inside the shared arena (own slice or an alias slice)
+struct OutputView{
+    const uint8_t* data{nullptr};
+    size_t size{0};
+};
 
 struct RunResult{
     std::vector<void*> input_ptrs;
     std::vector<Qnn_MemHandle_t> input_handles;
-    std::vector<Qnn_Tensor_t> input_metas;
-    std::vector<Qnn_Tensor_t> output_metas;
-    std::vector<std::vector<uint8_t>> output_bufs;
+    QnnGraphBinding io;  // owned meta + mutable IO tensors
+    std::vector<OutputView> outputs;
+    uint64_t exec_us{0};  // host wall time of graphExecute
 };
 
+// cross-graph aliasing for one graph: tensor name -> alias slice name
+using AliasPlan = std::unordered_map<std::string, std::string>;
+
 static bool RunOneGraph(
     const std::string& graph_name,
     const QnnInterface_t* be,
@@ -113,127 +82,174 @@ static bool RunOneGraph(
     SharedBuffer& sb,
     SharedBuffer::Arena& arena,
     Qnn_ProfileHandle_t ph,
-    RunResult& rr
+    RunResult& rr,
+    QnnProfilerRuntime* profiler = nullptr,
+    QnnTraceWriter* trace = nullptr,
+    QnnArenaAliasMap* aliases = nullptr,
+    const AliasPlan* alias_plan = nullptr
 ){
-    rr.input_metas = backendcache.GetGraphInputs(graph_name);
-    rr.output_metas = backendcache.GetGraphOutputs(graph_name);
+    rr.io = backendcache.MakeBinding(graph_name);
         
     std::cout << "graph_name=" << graph_name
-              << " num_inputs=" << rr.input_metas.size()
-              << " num_outputs=" << rr.output_metas.size() << "\n";
+              << " num_inputs=" << rr.io.inputs.size()
+              << " num_outputs=" << rr.io.outputs.size() << "\n";
 
-    if (rr.input_metas.empty() || rr.output_metas.empty()) {
+    if (rr.io.inputs.empty() || rr.io.outputs.empty()) {
         std::cerr << "[QNN] empty graph IO meta. check graph name or backendcache parsing\n";
         return false;
     }
 
-    // dtype size helper (필요한 것만)
-    auto dtype_size = [](Qnn_DataType_t dt) -> size_t {
-        switch (dt) {
-            case QNN_DATATYPE_FLOAT_32: return 4;
-            case QNN_DATATYPE_FLOAT_16: return 2;
-            case QNN_DATATYPE_UINT_8:
-            case QNN_DATATYPE_INT_8:
-            case QNN_DATATYPE_BOOL_8:
-            case QNN_DATATYPE_SFIXED_POINT_8:
-            case QNN_DATATYPE_UFIXED_POINT_8: return 1;
-            case QNN_DATATYPE_INT_16:
-            case QNN_DATATYPE_UINT_16:
-            case QNN_DATATYPE_SFIXED_POINT_16:
-            case QNN_DATATYPE_UFIXED_POINT_16: return 2;
-            case QNN_DATATYPE_INT_32:
-            case QNN_DATATYPE_UINT_32: return 4;
-            case QNN_DATATYPE_INT_64:
-            case QNN_DATATYPE_UINT_64: return 8;
-            default: return 0;
-        }
-    };
-
-    auto calc_bytes_from_meta = [&](const Qnn_Tensor_t& t) -> size_t {
-        auto* tv = QNN_TENSOR_VER_PTR(t);
-        size_t bytes = dtype_size(tv->dataType);
-        for (uint32_t i = 0; i < tv->rank; ++i) bytes *= tv->dimensions[i];
-        return bytes;
-    };
-
     std::mt19937 rng(12345);
     std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
 
+    QnnTraceScope register_span(trace, graph_name + ":register");
+
     // input buffer
-    rr.input_ptrs.assign(rr.input_metas.size(), nullptr);
-    rr.input_handles.assign(rr.input_metas.size(), nullptr);
+    rr.input_ptrs.assign(rr.io.inputs.size(), nullptr);
+    rr.input_handles.assign(rr.io.inputs.size(), nullptr);
+
+    // tensor name -> alias slice, nullptr if the tensor has its own buffer
+    auto alias_of = [&](const Qnn_Tensor_t& t) -> const std::string* {
+        if (!aliases || !alias_plan) return nullptr;
+        auto it = alias_plan->find(QNN_TENSOR_VER_PTR(t)->name);
+        return it == alias_plan->end() ? nullptr : &it->second;
+    };
+
+    // inputs on an alias slice were written by the producer graph; the rest go in one memRegister
+    // (pool hits skip it entirely)
+    std::vector<Qnn_Tensor_t*> in_tensors;
+    std::vector<size_t> in_bytes(rr.io.inputs.size(), 0), in_idx;
+    std::vector<bool> in_aliased(rr.io.inputs.size(), false);
+    for (size_t i = 0; i < rr.io.inputs.size(); ++i) {
+        auto& t = rr.io.inputs[i];
+        auto* tv = QNN_TENSOR_VER_PTR(t);
+        in_bytes[i] = QnnTensor::MetaBytes(t);
+        if (const std::string* alias = alias_of(t)) {
+            if (!mem.BindAlias(sb, arena, *aliases, *alias, t, in_bytes[i], &rr.input_ptrs[i], &rr.input_handles[i])) {
+                std::cerr << "BindAlias failed for input " << tv->name << "\n";
+                return false;
+            }
+            in_aliased[i] = true;
+            continue;
+        }
+        in_tensors.push_back(&t);
+        in_idx.push_back(i);
+    }
+    {
+        std::vector<size_t> bytes;
+        for (size_t i : in_idx) bytes.push_back(in_bytes[i]);
+        std::vector<void*> ptrs;
+        std::vector<Qnn_MemHandle_t> handles;
+        if(!in_tensors.empty() && !mem.RegisterTensorsInSharedArena(sb, arena, in_tensors, bytes, 64, &ptrs, &handles)){
+            std::cerr << "RegisterTensorsInSharedArena failed\n";
+            return false;
+        }
+        for (size_t k = 0; k < ptrs.size(); ++k) {
+            rr.input_ptrs[in_idx[k]] = ptrs[k];
+            rr.input_handles[in_idx[k]] = handles[k];
+        }
+    }
 
+    for (size_t i = 0; i < rr.io.inputs.size(); ++i) {
+        auto* tv = QNN_TENSOR_VER_PTR(rr.io.inputs[i]);
+        const size_t bytes = in_bytes[i];
+        void* ptr = rr.input_ptrs[i];
 
-    for (size_t i = 0; i < rr.input_metas.size(); ++i) {
-        auto* tv = QNN_TENSOR_VER_PTR(rr.input_metas[i]);
-        size_t bytes = tv->clientBuf.dataSize ? tv->clientBuf.dataSize : calc_bytes_from_meta(rr.input_metas[i]);
-        
-        void* ptr = nullptr;
-        Qnn_MemHandle_t h = nullptr;
-        if(!mem.RegisterTensorInSharedArena(sb, arena, rr.input_metas[i], bytes, 64, &ptr, &h)){
-            std::cerr << "RegisterTensorInSharedArena failed\n";
-            return -1;
+        if (in_aliased[i]) {
+            std::cout << "Input[" << i << "] name=" << tv->name
+                      << " bytes=" << bytes << " aliased to " << *alias_of(rr.io.inputs[i]) << "\n";
+            continue;
         }
 
         // 지금은 float32 입력만 랜덤으로 채우자 (네 모델이 fp32면 OK)
+        // + KV cache inputs (main_aot --kv-cache): f16 / int8 values, int8 scales > 0
+        const std::string tname = tv->name;
+        const bool is_scale = tname.size() > 6 && tname.compare(tname.size() - 6, 6, "_scale") == 0;
         if (tv->dataType == QNN_DATATYPE_FLOAT_32) {
             float* p = reinterpret_cast<float*>(ptr);
             size_t n = bytes / sizeof(float);
-            for (size_t k = 0; k < n; ++k) p[k] = dist(rng);
+            for (size_t k = 0; k < n; ++k) p[k] = is_scale ? std::fabs(dist(rng)) / 127.0f + kKvInt8MinScale : dist(rng);
+        } else if (tv->dataType == QNN_DATATYPE_FLOAT_16) {
+            uint16_t* p = reinterpret_cast<uint16_t*>(ptr);
+            for (size_t k = 0; k < bytes / sizeof(uint16_t); ++k) p[k] = f32_to_f16(dist(rng));
+        } else if (tv->dataType == QNN_DATATYPE_INT_8) {
+            int8_t* p = reinterpret_cast<int8_t*>(ptr);
+            for (size_t k = 0; k < bytes; ++k) p[k] = static_cast<int8_t>(std::lround(dist(rng) * 127.0f));
         } else {
             // 다른 dtype은 일단 0으로
             std::cerr << "Should not reach here\n";
         }
 
-        rr.input_ptrs[i] = ptr;
-        rr.input_handles[i] = h;
-
         std::cout << "Input[" << i << "] name=" << tv->name
                   << " bytes=" << bytes
                   << " dtype=" << tv->dataType
                   << " rank=" << tv->rank << "\n";
     }
-    rr.output_bufs.resize(rr.output_metas.size());
-
-    for (size_t i = 0; i < rr.output_metas.size(); ++i) {
-        auto* tv = QNN_TENSOR_VER_PTR(rr.output_metas[i]);
-        size_t bytes = tv->clientBuf.dataSize ? tv->clientBuf.dataSize : calc_bytes_from_meta(rr.output_metas[i]);
-        rr.output_bufs[i].resize(bytes);
-        std::memset(rr.output_bufs[i].data(), 0, bytes);
-
-        tv->memType = QNN_TENSORMEMTYPE_RAW;
-        tv->clientBuf.data = rr.output_bufs[i].data();
-        tv->clientBuf.dataSize = bytes;
-
-        std::cout << "Output[" << i << "] name=" << tv->name
-                  << " bytes=" << bytes
-                  << " dtype=" << tv->dataType
+    // outputs live in the shared arena too (MEMHANDLE): the backend writes them in place and
+    // post-processing reads the slice, no host copy and no per-run memset
+    std::vector<const std::string*> out_alias;
+    if (aliases && alias_plan){
+        for (const Qnn_Tensor_t& t : rr.io.outputs) out_alias.push_back(alias_of(t));
+    }
+    std::vector<void*> out_ptrs;
+    std::vector<size_t> out_bytes;
+    if (!mem.BindOutputsInSharedArena(sb, arena, rr.io.outputs, aliases, out_alias, &out_ptrs, &out_bytes)) return false;
+
+    rr.outputs.assign(rr.io.outputs.size(), OutputView{});
+    for (size_t i = 0; i < rr.io.outputs.size(); ++i) {
+        auto* tv = QNN_TENSOR_VER_PTR(rr.io.outputs[i]);
+        rr.outputs[i] = OutputView{static_cast<const uint8_t*>(out_ptrs[i]), out_bytes[i]};
+        std::cout << "Output[" << i << "] name=" << tv->name << " bytes=" << out_bytes[i];
+        if (!out_alias.empty() && out_alias[i]) {
+            std::cout << " aliased to " << *out_alias[i] << "\n";
+            continue;
+        }
+        std::cout << " dtype=" << tv->dataType
                   << " rank=" << tv->rank << "\n";
     }
 
     auto& api = be->QNN_INTERFACE_VER_NAME;
 
+    const uint64_t exec_start = QnnTraceWriter::NowUs();
     Qnn_ErrorHandle_t err = api.graphExecute(
         graph_handle,
-        rr.input_metas.data(),
-        static_cast<uint32_t>(rr.input_metas.size()),
-        rr.output_metas.data(),
-        static_cast<uint32_t>(rr.output_metas.size()),
+        rr.io.inputs.data(),
+        static_cast<uint32_t>(rr.io.inputs.size()),
+        rr.io.outputs.data(),
+        static_cast<uint32_t>(rr.io.outputs.size()),
         /*profile=*/ph,
         /*signal=*/nullptr);
 
+    const uint64_t exec_us = QnnTraceWriter::NowUs() - exec_start;
+    rr.exec_us = exec_us;
+
     if (err != QNN_SUCCESS) {
         std::cerr << "[QNN] graphExecute failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
         return false;
     }
     std::cout << "GRAPH EXECUTE: " << graph_name << "\n";
 
+    QnnGraphLatency& lat = QnnLatencyRegistry::Instance().Get(graph_name);
+    lat.wall_us.Record(exec_us);
+    uint64_t accel_us = 0;
+    if (profiler && profiler->IsValid() &&
+        profiler->FindEventValue(QNN_HTP_PROFILE_EVENTTYPE_GRAPH_EXECUTE_ACCEL_TIME_MICROSEC, &accel_us)){
+        lat.accel_us.Record(accel_us);
+    }
+
+    if (trace){
+        trace->AddSpan(graph_name + ":graphExecute", "host", exec_start, exec_us);
+        if (profiler && profiler->IsValid() && !profiler->AppendToTrace(*trace, graph_name, exec_start)){
+            std::cerr << "[QNN] AppendToTrace failed for " << graph_name << "\n";
+        }
+    }
+
     return true;
 }
 
 static void DumpOutputs(
     const std::vector<Qnn_Tensor_t>& output_metas,
-    const std::vector<std::vector<uint8_t>>& output_bufs,
+    const std::vector<OutputView>& outputs,
     size_t max_f32 = 16,
     size_t max_hex = 64
 ){
@@ -243,17 +259,17 @@ static void DumpOutputs(
         std::cout << "=== Output[" << i << "] " << tv->name << " ===\n";
 
         if (tv->dataType == QNN_DATATYPE_FLOAT_32) {
-            const float* p = reinterpret_cast<const float*>(output_bufs[i].data());
-            size_t n = output_bufs[i].size() / sizeof(float);
+            const float* p = reinterpret_cast<const float*>(outputs[i].data);
+            size_t n = outputs[i].size / sizeof(float);
             size_t show = std::min<size_t>(n, 16);
             for (size_t k = 0; k < show; ++k) {
                 std::cout << p[k] << (k + 1 == show ? "\n" : ", ");
             }
         } else {
             // 다른 dtype이면 raw hex로 앞부분만
-            size_t show = std::min<size_t>(output_bufs[i].size(), 64);
+            size_t show = std::min<size_t>(outputs[i].size, 64);
             for (size_t k = 0; k < show; ++k) {
-                printf("%02x%s", output_bufs[i][k], ((k + 1) % 16 == 0) ? "\n" : " ");
+                printf("%02x%s", outputs[i].data[k], ((k + 1) % 16 == 0) ? "\n" : " ");
             }
             if (show % 16 != 0) printf("\n");
         }
@@ -263,15 +279,35 @@ static void DumpOutputs(
 
 struct CpuRefOut {
   std::vector<float> out;   // [B*L*D]
+  std::vector<float> k, v;  // this step's k/v [B*L*D], what the KV cache write stores
+};
+
+// past k/v as the graph's cache-read ops hand them to attention (dequantized), [B*P*D]
+struct CpuRefPast {
+  unsigned int P{0};
+  std::vector<float> k, v;
 };
 
+// [B, n0, D] ++ [B, n1, D] along the sequence axis
+static std::vector<float> ConcatSeq(const std::vector<float>& a, const std::vector<float>& b,
+                                    unsigned int B, unsigned int n0, unsigned int n1, unsigned int D) {
+  std::vector<float> out((size_t)B * (n0 + n1) * D);
+  for (unsigned int i = 0; i < B; ++i) {
+    float* o = out.data() + (size_t)i * (n0 + n1) * D;
+    std::copy_n(a.data() + (size_t)i * n0 * D, (size_t)n0 * D, o);
+    std::copy_n(b.data() + (size_t)i * n1 * D, (size_t)n1 * D, o + (size_t)n0 * D);
+  }
+  return out;
+}
+
 
 static bool ComputeCpuReference(
     bool is_kv,
     const void* x_ptr,   // input_ptrs[0]
     const void* y_ptr,   // input_ptrs[1] (prefill에서만 사용, kv면 무시 가능)
     unsigned int B, unsigned int L, unsigned int D, unsigned int C,
-    CpuRefOut& ref
+    CpuRefOut& ref,
+    const CpuRefPast* past = nullptr
 ) {
   // load static weights
   std::vector<float> static_q, static_k, static_v;
@@ -316,16 +352,24 @@ static bool ComputeCpuReference(
         v.data(), B, L, C, D, 1, true);
   }
 
+  // KV cache: attend over [past; this step]
+  const unsigned int P = past ? past->P : 0;
+  const std::vector<float> k_all = P ? ConcatSeq(past->k, k, B, P, L, D) : k;
+  const std::vector<float> v_all = P ? ConcatSeq(past->v, v, B, P, L, D) : v;
+  attn.resize((size_t)B * L * (P + L));
+
   batch_matmul_f32(
       static_cast<const float*>(q.data()),
-      static_cast<const float*>(k.data()),
-      attn.data(), B, L, D, L, B, true);
+      static_cast<const float*>(k_all.data()),
+      attn.data(), B, L, D, P + L, B, true);
 
   batch_matmul_f32(
       static_cast<const float*>(attn.data()),
-      static_cast<const float*>(v.data()),
-      ref.out.data(), B, L, L, D, B, false);
+      static_cast<const float*>(v_all.data()),
+      ref.out.data(), B, L, P + L, D, B, false);
 
+  ref.k = std::move(k);
+  ref.v = std::move(v);
   return true;
 }
 
@@ -343,17 +387,17 @@ static void DumpCpuReferenceHead(
 }
 
 static void DumpQnnOutputHead(
-    const std::vector<std::vector<uint8_t>>& output_bufs,
+    const std::vector<OutputView>& outputs,
     const char* tag,
     size_t max_f32 = 16
 ) {
   std::cout << "====== QNN OUTPUT (" << tag << ") ======\n";
-  if (output_bufs.empty()) {
+  if (outputs.empty()) {
     std::cout << "(no outputs)\n";
     return;
   }
-  const float* p = reinterpret_cast<const float*>(output_bufs[0].data());
-  size_t n = output_bufs[0].size() / sizeof(float);
+  const float* p = reinterpret_cast<const float*>(outputs[0].data);
+  size_t n = outputs[0].size / sizeof(float);
   size_t show = std::min<size_t>(n, max_f32);
   for (size_t k = 0; k < show; ++k) {
     std::cout << p[k] << (k + 1 == show ? "\n" : ", ");
@@ -371,22 +415,97 @@ static void DumpAndSerializeProfiler(
   }
 }
 
+static int FindTensor(const std::vector<Qnn_Tensor_t>& ts, const std::string& name) {
+  for (size_t i = 0; i < ts.size(); ++i) {
+    if (name == QNN_TENSOR_VER_PTR(ts[i])->name) return static_cast<int>(i);
+  }
+  return -1;
+}
+
+// graph's KV cache write (output <name> [+ <name>_scale]) vs the host quantization of the reference k/v:
+// |graph - host| is the kernel mismatch, |graph - f32| the storage (quantization) error
+static void CheckKvCacheWrite(
+    const std::string& name,
+    const std::vector<float>& ref,  // [B*T*D] f32
+    const std::vector<Qnn_Tensor_t>& output_metas,
+    const std::vector<OutputView>& outputs
+) {
+  const int o = FindTensor(output_metas, name);
+  if (o < 0) return;
+  auto* tv = QNN_TENSOR_VER_PTR(output_metas[o]);
+  const QnnKvCacheMode mode = KvCacheModeOf(tv->dataType);
+  if (tv->rank != 4 || mode == QnnKvCacheMode::kOff) return;
+  const int T = static_cast<int>(tv->dimensions[0] * tv->dimensions[1]);
+  const int H = static_cast<int>(tv->dimensions[2]), Dh = static_cast<int>(tv->dimensions[3]);
+  const size_t n = (size_t)T * H * Dh;
+  if (ref.size() != n) {
+    std::cerr << "[QNN] KV check " << name << ": reference has " << ref.size() << " values, cache " << n << "\n";
+    return;
+  }
+  const int so = FindTensor(output_metas, name + "_scale");
+  const float* graph_scale = so >= 0 ? reinterpret_cast<const float*>(outputs[so].data) : nullptr;
+  if (mode == QnnKvCacheMode::kInt8 && !graph_scale) return;
+
+  std::vector<uint8_t> host_q(KvCacheBytes(mode, T, H, Dh));
+  std::vector<float> host_scale((size_t)T * H), host(n), got(n);
+  quantize_kv(mode, ref.data(), host_q.data(), host_scale.data(), T, H, Dh);
+  dequantize_kv(mode, host_q.data(), host_scale.data(), host.data(), T, H, Dh);
+  dequantize_kv(mode, outputs[o].data, graph_scale, got.data(), T, H, Dh);
+  float vs_host = 0.0f, vs_f32 = 0.0f;
+  for (size_t i = 0; i < n; ++i) {
+    vs_host = std::max(vs_host, std::fabs(got[i] - host[i]));
+    vs_f32 = std::max(vs_f32, std::fabs(got[i] - ref[i]));
+  }
+  std::cout << "[QNN] KV cache write " << name << " (" << KvCacheModeStr(mode) << ", " << T << "x" << H << "x" << Dh
+            << "): max|graph-host|=" << vs_host << " max|graph-f32|=" << vs_f32 << "\n";
+}
+
 static bool PostProcessOneGraphRun(
     const std::string& graph_name,
     bool is_kv,
     const std::vector<void*>& input_ptrs,  // input_ptrs[0]=x, input_ptrs[1]=y (prefill)
+    const std::vector<Qnn_Tensor_t>& input_metas,
     const std::vector<Qnn_Tensor_t>& output_metas,
-    const std::vector<std::vector<uint8_t>>& output_bufs,
+    const std::vector<OutputView>& outputs,
     QnnProfilerRuntime& profiler
 ) {
   // 1) output dump
-  DumpOutputs(output_metas, output_bufs, /*max_f32=*/16, /*max_hex=*/64);
+  DumpOutputs(output_metas, outputs, /*max_f32=*/16, /*max_hex=*/64);
 
   // 2) profiler dump + serialize
   DumpAndSerializeProfiler(profiler, graph_name);
 
   // 3) cpu reference
-  const unsigned int B = 1, L = 30, D = 1024, C = 2048; // 너 기존 그대로 고정
+  unsigned int B = 1, L = 30, D = 1024, C = 2048; // 너 기존 그대로 고정
+
+  // KV cache inputs (main_aot --kv-cache): dequantize past k/v like the graph does, shapes from the cache
+  CpuRefPast past;
+  const int kc = FindTensor(input_metas, "k_cache"), vc = FindTensor(input_metas, "v_cache");
+  if (kc >= 0 && vc >= 0) {
+    auto* kt = QNN_TENSOR_VER_PTR(input_metas[kc]);
+    const QnnKvCacheMode mode = KvCacheModeOf(kt->dataType);
+    if (kt->rank != 4 || mode == QnnKvCacheMode::kOff) {
+      std::cerr << "[QNN] k_cache input is not [B, P, H, D/H] f32/f16/int8\n";
+      return false;
+    }
+    const int ks = FindTensor(input_metas, "k_cache_scale"), vs = FindTensor(input_metas, "v_cache_scale");
+    if (mode == QnnKvCacheMode::kInt8 && (ks < 0 || vs < 0)) {
+      std::cerr << "[QNN] int8 KV cache without k_cache_scale/v_cache_scale inputs\n";
+      return false;
+    }
+    const int H = static_cast<int>(kt->dimensions[2]), Dh = static_cast<int>(kt->dimensions[3]);
+    B = kt->dimensions[0];
+    D = static_cast<unsigned int>(H * Dh);
+    if (auto* xt = QNN_TENSOR_VER_PTR(input_metas[0]); xt->rank == 3) { L = xt->dimensions[1]; C = xt->dimensions[2]; }
+    past.P = kt->dimensions[1];
+    past.k.resize((size_t)B * past.P * D);
+    past.v.resize((size_t)B * past.P * D);
+    const int T = static_cast<int>(B * past.P);
+    dequantize_kv(mode, input_ptrs[kc], ks >= 0 ? static_cast<const float*>(input_ptrs[ks]) : nullptr, past.k.data(), T, H, Dh);
+    dequantize_kv(mode, input_ptrs[vc], vs >= 0 ? static_cast<const float*>(input_ptrs[vs]) : nullptr, past.v.data(), T, H, Dh);
+    std::cout << "[QNN] " << graph_name << ": KV cache " << KvCacheModeStr(mode) << " past=" << past.P
+              << " heads=" << H << " (" << KvCacheBytes(mode, past.P, H, Dh) << " bytes per K)\n";
+  }
   if (input_ptrs.empty() || input_ptrs[0] == nullptr) {
     std::cerr << "[QNN] input_ptrs[0] missing\n";
     return false;
@@ -402,134 +521,533 @@ static bool PostProcessOneGraphRun(
           /*x_ptr=*/input_ptrs[0],
           /*y_ptr=*/(is_kv ? nullptr : input_ptrs[1]),
           B, L, D, C,
-          ref)) {
+          ref,
+          past.P ? &past : nullptr)) {
     std::cerr << "[QNN] ComputeCpuReference failed for " << graph_name << "\n";
     return false;
   }
 
-  DumpQnnOutputHead(output_bufs, graph_name.c_str(), /*max_f32=*/16);
+  DumpQnnOutputHead(outputs, graph_name.c_str(), /*max_f32=*/16);
   DumpCpuReferenceHead(ref, graph_name.c_str(), /*max_f32=*/16);
 
+  // KV cache writes: prefill stores k_cache/v_cache, decode k_new/v_new
+  CheckKvCacheWrite(is_kv ? "k_new" : "k_cache", ref.k, output_metas, outputs);
+  CheckKvCacheWrite(is_kv ? "v_new" : "v_cache", ref.v, output_metas, outputs);
+
   return true;
 }
 
-int main(int argc, char** argv){
-    std::ifstream bin("multi_graph.bin", std::ios::binary | std::ios::ate);
-    assert(bin.is_open());
+// hidden_in (random) -> shard_0 -> ... -> shard_{K-1} -> hidden_out
+static bool RunShardedModel(
+    const QnnInterface_t* be,
+    const QnnSystemInterface_t* sys,
+    QnnBackendRuntime& backend,
+    QnnDeviceRuntime& device,
+    const std::vector<std::string>& shard_paths
+){
+    auto& sb = SharedBuffer::Instance();
+    SharedBuffer::Arena arena;
+    if (!sb.ArenaCreate(arena, 20000000, 64)){
+        std::cerr << "ArenaCreate failed\n";
+        return false;
+    }
+
+    QnnShardedModelRuntime model;
+    QnnShardedModelRuntime::Options opt;
+    opt.prefetch = true;
+    opt.keep_resident = false;
+    if (!model.Init(be, sys, backend.Handle(), device.Handle(), /*profile_handle=*/nullptr,
+                    shard_paths, sb, arena, opt)){
+        std::cerr << "Sharded model init failed\n";
+        sb.ArenaDestroy(arena);
+        return false;
+    }
+
+    // Basic on every run, Detailed on every 2nd -> per-op stats without Optrace cost on each run
+    QnnSamplingProfilerRuntime sampler;
+    if (sampler.Create(be, sys, backend.Handle(), QnnProfileLevel::Basic, /*every_n=*/2)){
+        model.SetSampler(&sampler);
+    } else {
+        std::cerr << "Sampling profiler create failed (continuing without)\n";
+    }
+
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    bool ok = true;
+    const int iters = 4;
+    for (int it = 0; it < iters && ok; ++it){
+        float* in = reinterpret_cast<float*>(model.Input());
+        for (size_t k = 0; k < model.HiddenBytes() / sizeof(float); ++k) in[k] = dist(rng);
+        ok = model.Run();
+    }
+    sampler.Dump(std::cout);
+    QnnLatencyRegistry::Instance().Dump(std::cout);
+    if (ok){
+        const float* out = reinterpret_cast<const float*>(model.Output());
+        size_t show = std::min<size_t>(model.HiddenBytes() / sizeof(float), 16);
+        std::cout << "====== QNN OUTPUT (sharded, " << model.NumShards() << " shards) ======\n";
+        for (size_t k = 0; k < show; ++k) std::cout << out[k] << (k + 1 == show ? "\n" : ", ");
+    }
+
+    model.Destroy();
+    sampler.Destroy();
+    sb.ArenaDestroy(arena);
+    return ok;
+}
+
+struct ServeOptions{
+    uint32_t requests{0};       // synthetic requests, all submitted up front
+    uint32_t prompt_tokens{64};  // per request, +-50% spread
+    uint32_t new_tokens{32};     // per request, +-50% spread
+    QnnBatchScheduler::Options sched;
+};
+
+// N concurrent requests through QnnBatchScheduler over every [B, L, C] graph of the binaries:
+// L == 1 graphs take decode tokens, L > 1 graphs take prefill chunks, B = rows per execute.
+// graphs are bound once (RunOneGraph) and then only re-executed; each launch writes its rows into x.
+static bool ServeRequests(
+    const ServeOptions& opt,
+    const QnnInterface_t* be,
+    QnnMultiContextRuntime& contexts,
+    QnnGraphRegistry& graphs,
+    std::vector<QnnMemManagerRuntime*> mems,  // per context, nullptr = not created yet
+    SharedBuffer& sb,
+    SharedBuffer::Arena& arena,
+    std::unordered_map<std::string, RunResult*> bound,  // graphs already run (and bound) by the caller
+    QnnTraceWriter* trace
+){
+    std::vector<std::unique_ptr<QnnMemManagerRuntime>> own_mems;
+    std::vector<std::unique_ptr<RunResult>> own_runs;
+
+    struct Launchable{
+        QnnGraphRuntime* graph{nullptr};
+        RunResult* rr{nullptr};
+        int x{0};      // x input index
+        size_t C{0};   // x row width (elements)
+    };
+    std::vector<QnnStepGraph> catalog;
+    std::vector<Launchable> launchable;
+    for (size_t ci = 0; ci < contexts.Size(); ++ci){
+        for (const std::string& name : contexts.Cache(ci).GraphNames()){
+            const auto& ins = contexts.Cache(ci).GraphInputs(name);
+            const int xi = std::max(FindTensor(ins, "x"), 0);
+            if (ins.empty() || QNN_TENSOR_VER_PTR(ins[xi])->rank != 3){
+                std::cout << "[QNN] serve: skip " << name << " (no [B, L, C] input)\n";
+                continue;
+            }
+            const uint32_t* d = QNN_TENSOR_VER_PTR(ins[xi])->dimensions;
+            QnnGraphRuntime* g = graphs.Get(name);
+            if (!g){
+                std::cerr << "[QNN] serve: graphRetrieve failed for " << name << "\n";
+                return false;
+            }
+            RunResult* rr = bound.count(name) ? bound[name] : nullptr;
+            if (!rr){
+                if (!mems[ci]){
+                    // graphs.Get above activated the context
+                    own_mems.push_back(std::make_unique<QnnMemManagerRuntime>());
+                    if (!own_mems.back()->Init(be, &contexts.Context(ci))){
+                        std::cerr << "[QNN] serve: MemManager init failed for " << contexts.Path(ci) << "\n";
+                        return false;
+                    }
+                    mems[ci] = own_mems.back().get();
+                }
+                own_runs.push_back(std::make_unique<RunResult>());
+                rr = own_runs.back().get();
+                if (!RunOneGraph(name, be, g->Handle(), contexts.Cache(ci), *mems[ci], sb, arena, /*ph=*/nullptr, *rr)){
+                    std::cerr << "[QNN] serve: skip " << name << " (bind failed)\n";
+                    continue;
+                }
+            }
+            catalog.push_back(QnnStepGraph{name, d[0], d[1]});
+            launchable.push_back(Launchable{g, rr, xi, d[2]});
+            std::cout << "[QNN] serve: " << name << " batch=" << d[0] << " tokens=" << d[1]
+                      << (d[1] == 1 ? " (decode)\n" : " (prefill chunk)\n");
+        }
+    }
 
-    size_t binSize = bin.tellg();
-    bin.seekg(0);
+    QnnBatchScheduler sched;
+    if (!sched.Init(catalog, opt.sched)) return false;
+    std::mt19937 rng(777);
+    auto spread = [&](uint32_t v){
+        std::uniform_int_distribution<uint32_t> d(std::max(v / 2, 1u), v + v / 2);
+        return d(rng);
+    };
+    for (uint32_t r = 0; r < opt.requests; ++r) sched.Submit(spread(opt.prompt_tokens), spread(opt.new_tokens));
 
-    std::vector<uint8_t> binData(binSize);
-    bin.read(reinterpret_cast<char *>(binData.data()), binSize);
-    bin.close();
+    auto& api = be->QNN_INTERFACE_VER_NAME;
+    QnnStepPlan plan;
+    const uint64_t t0 = QnnTraceWriter::NowUs();
+    while (sched.Schedule(&plan)){
+        QnnTraceScope step_span(trace, "serve:step", "serve");
+        for (const QnnStepLaunch& l : plan.launches){
+            const QnnStepGraph& sg = sched.Graph(l.graph);
+            Launchable& ln = launchable[l.graph];
+            RunResult& rr = *ln.rr;
+
+            // stand-in embeddings of the rows' tokens; padding rows keep whatever they held
+            if (QNN_TENSOR_VER_PTR(rr.io.inputs[ln.x])->dataType == QNN_DATATYPE_FLOAT_32){
+                float* x = static_cast<float*>(rr.input_ptrs[ln.x]);
+                for (size_t i = 0; i < l.rows.size(); ++i){
+                    const QnnStepRow& row = l.rows[i];
+                    float* dst = x + i * sg.tokens * ln.C;
+                    for (size_t k = 0; k < row.n * ln.C; ++k){
+                        dst[k] = static_cast<float>((row.id * 131 + row.pos * 7 + k) % 97) / 97.0f - 0.5f;
+                    }
+                }
+            }
 
-    printf("Loaded context binary: %zu bytes\n", binSize);
+            const uint64_t exec_start = QnnTraceWriter::NowUs();
+            Qnn_ErrorHandle_t err = api.graphExecute(
+                ln.graph->Handle(),
+                rr.io.inputs.data(), static_cast<uint32_t>(rr.io.inputs.size()),
+                rr.io.outputs.data(), static_cast<uint32_t>(rr.io.outputs.size()),
+                /*profile=*/nullptr, /*signal=*/nullptr);
+            const uint64_t exec_us = QnnTraceWriter::NowUs() - exec_start;
+            if (err != QNN_SUCCESS){
+                std::cerr << "[QNN] serve: graphExecute(" << sg.name << ") failed, err=" << QNN_GET_ERROR_CODE(err) << "\n";
+                return false;
+            }
+            QnnLatencyRegistry::Instance().Get(sg.name).wall_us.Record(exec_us);
+            if (trace) trace->AddSpan(sg.name + ":graphExecute", "serve", exec_start, exec_us);
+        }
+        sched.Complete(plan);
+    }
+    const double sec = (QnnTraceWriter::NowUs() - t0) / 1e6;
+
+    const auto st = sched.GetStats();
+    const uint64_t tokens = st.decode_tokens + st.prefill_tokens;
+    std::cout << "====== SERVE (" << st.finished << "/" << st.submitted << " requests, "
+              << opt.sched.max_running << " running, " << opt.sched.max_step_tokens << " tokens/step) ======\n"
+              << "  wall " << sec * 1e3 << " ms, " << st.steps << " steps, " << st.launches << " executes, max batch " << st.max_batch << "\n"
+              << "  tokens/s " << (sec > 0 ? tokens / sec : 0.0) << " (decode " << (sec > 0 ? st.decode_tokens / sec : 0.0)
+              << ", prefill " << (sec > 0 ? st.prefill_tokens / sec : 0.0) << ")\n"
+              << "  padding " << (tokens + st.padded_tokens ? 100.0 * st.padded_tokens / (tokens + st.padded_tokens) : 0.0) << "%\n"
+              << "  ttft us p50/p90/p99 " << st.ttft_us.p50 << "/" << st.ttft_us.p90 << "/" << st.ttft_us.p99 << "\n"
+              << "  e2e  us p50/p90/p99 " << st.e2e_us.p50 << "/" << st.e2e_us.p90 << "/" << st.e2e_us.p99 << "\n";
+    return st.finished == st.submitted;
+}
+
+int main(int argc, char** argv){
+    // ./qnn_runtime_runner [ctx0.bin ctx1.bin ...]
+    // several binaries => all contexts share one spill-fill buffer
+    // ./qnn_runtime_runner --shards shard_0.bin shard_1.bin ...
+    // layer-sharded model, shard i+1 is loaded while shard i runs
+    // --warmup : pre-fault the arena and execute every graph once before the first request
+    // --alias <prefill output>=<kv input> : bind both on one arena slice (repeatable).
+    //           outputs/inputs with the same name, dtype and size are aliased without it
+    // --mem-dump-ms N : write mem_telemetry.json every N ms (always written once at the end)
+    // --serve N [--serve-prompt P] [--serve-new T] [--serve-running R] [--serve-step-tokens K]
+    //           : after the single run, N concurrent requests through the continuous-batching scheduler
+    std::vector<std::string> bin_paths;
+    bool sharded = false;
+    bool warmup = false;
+    std::vector<std::pair<std::string, std::string>> alias_args;
+    uint32_t mem_dump_ms = 0;
+    ServeOptions serve;
+    for (int i = 1; i < argc; ++i){
+        if (std::string(argv[i]) == "--shards") { sharded = true; continue; }
+        if (std::string(argv[i]) == "--warmup") { warmup = true; continue; }
+        if (std::string(argv[i]) == "--mem-dump-ms" && i + 1 < argc){
+            mem_dump_ms = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--serve" && i + 1 < argc){
+            serve.requests = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--serve-prompt" && i + 1 < argc){
+            serve.prompt_tokens = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--serve-new" && i + 1 < argc){
+            serve.new_tokens = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--serve-running" && i + 1 < argc){
+            serve.sched.max_running = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--serve-step-tokens" && i + 1 < argc){
+            serve.sched.max_step_tokens = static_cast<uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (std::string(argv[i]) == "--alias" && i + 1 < argc){
+            const std::string a = argv[++i];
+            const size_t eq = a.find('=');
+            if (eq == std::string::npos || eq == 0 || eq + 1 == a.size()){
+                std::cerr << "--alias expects <output>=<input>, got " << a << "\n";
+                return -1;
+            }
+            alias_args.emplace_back(a.substr(0, eq), a.substr(eq + 1));
+            continue;
+        }
+        bin_paths.emplace_back(argv[i]);
+    }
+    if (bin_paths.empty()) bin_paths.emplace_back("multi_graph.bin");
 
     const std::string backend_so = "libQnnHtp.so";
     const std::string system_so = "libQnnSystem.so";
 
+    // startup stages go to trace.json (cat "init") and a table before execute.
+    // independent stages run next to backend/device creation on the main thread:
+    //   io     : read context binaries
+    //   system : dlopen(libQnnSystem.so) -> binary info parse (waits for io)
+    //   arena  : rpcmem arena
+    // host spans + per-op profile events on one timeline (open in ui.perfetto.dev)
+    QnnTraceWriter trace;
+    constexpr int kInitIoTid = 11;
+    constexpr int kInitSystemTid = 12;
+    constexpr int kInitArenaTid = 13;
+    trace.SetThreadName(kInitIoTid, "init io");
+    trace.SetThreadName(kInitSystemTid, "init system");
+    trace.SetThreadName(kInitArenaTid, "init arena");
+
+    auto& telemetry = QnnMemTelemetry::Instance();
+    if (mem_dump_ms) telemetry.StartPeriodicDump(mem_dump_ms, "mem_telemetry.json");
+
     auto& qnn = QnnDynLoad::Instance();
-    if (!qnn.LoadAll(backend_so, system_so)) {
-        std::cerr << "Failed to load QNN backend or system\n";
-        return -1;
+    QnnMultiContextRuntime contexts;
+    SharedBuffer::Arena arena;
+
+    // futures are declared after what they touch => joined before those are destroyed
+    std::future<bool> read_done;
+    if (!sharded){
+        read_done = std::async(std::launch::async, [&]{
+            QnnTraceScope span(&trace, "read_binaries", "init", kInitIoTid);
+            return contexts.ReadBinaries(bin_paths);
+        });
+    }
+    std::future<bool> system_done = std::async(std::launch::async, [&]{
+        {
+            QnnTraceScope span(&trace, "dlopen_system", "init", kInitSystemTid);
+            if (!qnn.LoadSystem(system_so)) return false;
+        }
+        if (sharded) return true;
+        if (!read_done.get()) return false;
+        QnnTraceScope span(&trace, "parse_binary_info", "init", kInitSystemTid);
+        return contexts.ParseBinaries(qnn.System());
+    });
+    std::future<bool> arena_done;
+    if (!sharded){
+        arena_done = std::async(std::launch::async, [&]{
+            QnnTraceScope span(&trace, "arena_create", "init", kInitArenaTid);
+            // 대충 크게 alloc
+            return SharedBuffer::Instance().ArenaCreate(arena, 20000000, 64);
+        });
     }
 
+    {
+        QnnTraceScope span(&trace, "dlopen_backend", "init");
+        if (!qnn.LoadBackend(backend_so)) {
+            std::cerr << "Failed to load QNN backend\n";
+            return -1;
+        }
+    }
     std::cout << "QNN backend loaded: backendId= " << qnn.Backend()->backendId << "\n";
-    std::cout << "QNN system loaded: systemId= " << qnn.System() << "\n";
-    
+
     Qnn_LogHandle_t logHandle = nullptr;
-    if (!CreateQnnLogger(qnn.Backend(), &logHandle, /*QNN_LOG_LEVEL_VERBOSE*/ QNN_LOG_LEVEL_INFO)) {
-        std::cerr << "Failed to create QNN logger (continuing without logger)\n";
-        return -1;
-    } else {
-        std::cout << "QNN logger created. logHandle=" << logHandle << "\n";
+    {
+        QnnTraceScope span(&trace, "log_create", "init");
+        if (!CreateQnnLogger(qnn.Backend(), &logHandle, /*QNN_LOG_LEVEL_VERBOSE*/ QNN_LOG_LEVEL_INFO)) {
+            std::cerr << "Failed to create QNN logger (continuing without logger)\n";
+            return -1;
+        } else {
+            std::cout << "QNN logger created. logHandle=" << logHandle << "\n";
+        }
     }
 
     QnnBackendRuntime backend;
-    if (!backend.Create(qnn.Backend(), /*logger_handler=*/logHandle)){
-        std::cerr << "backendCreate failed\n";
-        return -1;
+    {
+        QnnTraceScope span(&trace, "backend_create", "init");
+        if (!backend.Create(qnn.Backend(), /*logger_handler=*/logHandle)){
+            std::cerr << "backendCreate failed\n";
+            return -1;
+        }
     }
     std::cout << "backendCreate OK\n";
 
     QnnDeviceRuntime device;
-    if(!device.Create(qnn.Backend(), /*logger_handler=*/logHandle)){
-        std::cerr << "deviceCreate failed\n";
-        return -1;
+    // clocks may drop between requests; burst is voted only while executing (below)
+    device.EnablePerfVote(QnnHtpPowerProfile::kBalanced);
+    {
+        QnnTraceScope span(&trace, "device_create", "init");
+        if(!device.Create(qnn.Backend(), /*logger_handler=*/logHandle)){
+            std::cerr << "deviceCreate failed\n";
+            return -1;
+        }
     }
     std::cout << "deviceCreate OK\n";
-    
-    HtpBackendCacheRuntime backendcache;
-    QnnContextBinary blob;
-    blob.buffer = binData.data();
-    blob.nbytes = static_cast<uint32_t>(binSize);
-
-    if(!backendcache.Create(qnn.System(), blob)){
-        std::cerr << "backendcacheCreate failed\n";
-        return -1;
+
+    {
+        QnnTraceScope span(&trace, "wait_system", "init");
+        if (!system_done.get()){
+            std::cerr << "Failed to load QNN system or parse binaries\n";
+            return -1;
+        }
+    }
+    std::cout << "QNN system loaded: systemId= " << qnn.System() << "\n";
+
+    if (sharded){
+        QnnHtpPerfScope burst(device.Perf(), QnnHtpPowerProfile::kBurst);
+        if (!RunShardedModel(qnn.Backend(), qnn.System(), backend, device, bin_paths)) return -1;
+        std::cout << "[QNN] Done.\n";
+        return 0;
     }
 
     QnnProfilerRuntime profiler;
-    if(!profiler.Create(qnn.Backend(), qnn.System(), backend.Handle(), QnnProfileLevel::Optrace, true, "qnn.log")){
-        std::cerr << "ProfilerCreate failed\n";
+    {
+        QnnTraceScope span(&trace, "profiler_create", "init");
+        if(!profiler.Create(qnn.Backend(), qnn.System(), backend.Handle(), QnnProfileLevel::Optrace, true, "qnn.log")){
+            std::cerr << "ProfilerCreate failed\n";
+            return -1;
+        }
+        // systemProfileSerializeEventData + file write off the execute thread
+        profiler.EnableAsyncSerialization(/*queue_capacity=*/4);
+    }
+
+    // contexts is declared above backend/device/profiler for the init futures, but contextFree
+    // (and its DSP heap events) needs all three alive => free the contexts first on every return path
+    struct ContextsFreeFirst{
+        QnnMultiContextRuntime& c;
+        ~ContextsFreeFirst() { c.Destroy(); }
+    } contexts_free_first{contexts};
+
+    // contexts are activated (contextCreateFromBinary) by the registry on first Get
+    QnnGraphRegistry graphs;
+    if(!contexts.Prepare(qnn.Backend(), backend.Handle(), device.Handle(), profiler.GetProfiler()) ||
+       !graphs.Init(qnn.Backend(), &contexts, profiler.GetProfiler())){
+        std::cerr << "graph registry init failed\n";
         return -1;
     }
 
-    QnnContextRuntime ctx;
-    // ctx.SetMultiContexts(true, /*max_sf_buf_size=*/spill_fill_size);
-    if(!ctx.CreateFromBinary(qnn.Backend(), backend.Handle(), device.Handle(), profiler.GetProfiler(), binData.data(), blob.nbytes)){
-        std::cerr << "contextCreateFromBinary failed\n";
+    const int prefill_idx = graphs.ContextIndex("prefill_forward");
+    const int kv_idx = graphs.ContextIndex("kv_forward");
+    if (prefill_idx < 0 || kv_idx < 0){
+        std::cerr << "prefill_forward/kv_forward not found in given binaries\n";
         return -1;
     }
+    QnnContextRuntime& ctx_prefill = contexts.Context(prefill_idx);
+    QnnContextRuntime& ctx_kv = contexts.Context(kv_idx);
 
     const std::string graph_name = "prefill_forward";
     bool is_kv = false;
 
-    QnnGraphRuntime g_prefill, g_kv;
-    g_prefill.SetRestoreMode(true);
-    g_kv.SetRestoreMode(true);
-    if (!g_prefill.Create(qnn.Backend(), ctx.Handle(), profiler.GetProfiler(), "prefill_forward")) {
-        std::cerr << "graphCreate for prefill failed\n";
-        return -1;
+    // prefill is needed right away; kv is retrieved in the background while prefill runs
+    QnnGraphRuntime* g_prefill = nullptr;
+    {
+        QnnTraceScope span(&trace, "graph_retrieve", "init");
+        g_prefill = graphs.Get("prefill_forward");
+        if (!g_prefill) {
+            std::cerr << "graphRetrieve for prefill failed\n";
+            return -1;
+        }
     }
+    graphs.Prewarm({"kv_forward"});
+
+    std::cout << "graphRetrieve OK. graph_handle for prefill=" << g_prefill->Handle() << "\n";
 
-    if (!g_kv.Create(qnn.Backend(), ctx.Handle(), profiler.GetProfiler(), "kv_forward")) {
-        std::cerr << "graphCreate for kv failed\n";
+    // mem handles are per context. kv's context may still be activating in the prewarm
+    // (kv_forward in another binary) => mem_kv is initialized after graphs.Get("kv_forward")
+    QnnMemManagerRuntime mem_prefill, mem_kv;
+    if (!mem_prefill.Init(qnn.Backend(), &ctx_prefill)){
+        std::cerr << "MemManager init for prefill failed\n";
         return -1;
     }
 
-    std::cout << "graphCreate OK. graph_handle for prefill=" << g_prefill.Handle() << " for kv= " << g_kv.Handle() << "\n";
-
-    QnnMemManagerRuntime mem;
-    mem.Init(qnn.Backend(), &ctx);
-
     // ===== 4) host-side buffers 준비 (random input) =====
-    auto & sb = SharedBuffer::Instance();
-    SharedBuffer::Arena arena;
-    // 대충 크게 alloc
-    if (!sb.ArenaCreate(arena, 20000000, 64)){
-        std::cerr << "ArenaCreate failed\n";
-        return -1;
+    {
+        QnnTraceScope span(&trace, "wait_arena", "init");
+        if (!arena_done.get()){
+            std::cerr << "ArenaCreate failed\n";
+            return -1;
+        }
     }
+    auto & sb = SharedBuffer::Instance();
 
-    auto tensor_bytes = [](const Qnn_Tensor_t& t) -> size_t {
-        // 보통 metadata에 clientBuf.dataSize가 들어있음
-        // 없으면 dims * dtype size로 계산해야 함
-        size_t n = QNN_TENSOR_VER_PTR(t)->clientBuf.dataSize;
-        return n;
-    };
+    // cold-start costs (power-up, VTCM acquire, page faults) paid here instead of by the first request
+    QnnWarmupRuntime warm;
+    if (warmup){
+        {
+            QnnTraceScope span(&trace, "prefault_arena", "init");
+            const size_t pages = QnnWarmupRuntime::PrefaultArena(arena);
+            std::cout << "[QNN] Warmup: prefaulted " << pages << " arena pages\n";
+        }
+        QnnTraceScope span(&trace, "warmup_execute", "init");
+        for (const char* name : {"prefill_forward", "kv_forward"}){
+            QnnGraphRuntime* g = graphs.Get(name);
+            HtpBackendCacheRuntime& cache = contexts.Cache(graphs.ContextIndex(name));
+            if (!g || !warm.WarmGraph(qnn.Backend(), g->Handle(), name,
+                                      cache.GraphInputs(name), cache.GraphOutputs(name))){
+                std::cerr << "warm-up failed for " << name << "\n";
+                return -1;
+            }
+        }
+    }
+    trace.DumpSpans(std::cout, "init");
 
     RunResult rr_prefill, rr_kv;
 
-    // Preregister TODO - memRegister on runtime for now
-    if(!RunOneGraph("prefill_forward", qnn.Backend(), g_prefill.Handle(), backendcache, mem, sb, arena, profiler.GetProfiler(), rr_prefill)){
-        std::cerr << "Run prefill failed\n";
-        return -1;
+    // prefill output -> kv input on one arena slice: kv_forward reads prefill's result in place.
+    // alias slice name = producer output name
+    QnnArenaAliasMap aliases;
+    AliasPlan prefill_aliases, kv_aliases;
+    {
+        const auto& outs = contexts.Cache(prefill_idx).GraphOutputs("prefill_forward");
+        const auto& ins = contexts.Cache(kv_idx).GraphInputs("kv_forward");
+        auto find = [](const std::vector<Qnn_Tensor_t>& ts, const std::string& name) -> const Qnn_Tensor_t* {
+            for (const auto& t : ts) if (name == QNN_TENSOR_VER_PTR(t)->name) return &t;
+            return nullptr;
+        };
+        auto compatible = [&](const Qnn_Tensor_t& a, const Qnn_Tensor_t& b){
+            return QNN_TENSOR_VER_PTR(a)->dataType == QNN_TENSOR_VER_PTR(b)->dataType &&
+                   QnnTensor::MetaBytes(a) == QnnTensor::MetaBytes(b) && QnnTensor::MetaBytes(a) != 0;
+        };
+        std::vector<std::pair<std::string, std::string>> pairs = alias_args;
+        for (const auto& o : outs){
+            const std::string name = QNN_TENSOR_VER_PTR(o)->name;
+            if (const Qnn_Tensor_t* in = find(ins, name)){
+                if (compatible(o, *in)) pairs.emplace_back(name, name);
+            }
+        }
+        for (const auto& pr : pairs){
+            const Qnn_Tensor_t* o = find(outs, pr.first);
+            const Qnn_Tensor_t* in = find(ins, pr.second);
+            if (kv_aliases.count(pr.second) && kv_aliases[pr.second] == pr.first) continue;  // --alias that is also automatic
+            if (!o || !in || !compatible(*o, *in)){
+                std::cerr << "[QNN] alias " << pr.first << "=" << pr.second << " skipped (missing or dtype/size mismatch)\n";
+                continue;
+            }
+            prefill_aliases[pr.first] = pr.first;
+            kv_aliases[pr.second] = pr.first;
+            std::cout << "[QNN] alias prefill_forward:" << pr.first << " -> kv_forward:" << pr.second << "\n";
+        }
     }
-    if(!RunOneGraph("kv_forward", qnn.Backend(), g_kv.Handle(), backendcache, mem, sb, arena, profiler.GetProfiler(), rr_kv)){
-        std::cerr << "Run kv failed\n";
-        return -1;
+
+    // burst vote for the request, back to idle (balanced) at the end of the scope
+    {
+        QnnHtpPerfScope burst(device.Perf(), QnnHtpPowerProfile::kBurst);
+
+        // Preregister TODO - memRegister on runtime for now
+        if(!RunOneGraph("prefill_forward", qnn.Backend(), g_prefill->Handle(), contexts.Cache(prefill_idx), mem_prefill, sb, arena, profiler.GetProfiler(), rr_prefill, &profiler, &trace, &aliases, &prefill_aliases)){
+            std::cerr << "Run prefill failed\n";
+            return -1;
+        }
+        warm.Report("prefill_forward", rr_prefill.exec_us, &profiler);
+        QnnGraphRuntime* g_kv = graphs.Get("kv_forward");  // waits if the prewarm is still retrieving
+        if (!g_kv) {
+            std::cerr << "graphRetrieve for kv failed\n";
+            return -1;
+        }
+        if (!mem_kv.Init(qnn.Backend(), &ctx_kv)){
+            std::cerr << "MemManager init for kv failed\n";
+            return -1;
+        }
+        if(!RunOneGraph("kv_forward", qnn.Backend(), g_kv->Handle(), contexts.Cache(kv_idx), mem_kv, sb, arena, profiler.GetProfiler(), rr_kv, &profiler, &trace, &aliases, &kv_aliases)){
+            std::cerr << "Run kv failed\n";
+            return -1;
+        }
+        warm.Report("kv_forward", rr_kv.exec_us, &profiler);
     }
 
 
@@ -537,21 +1055,52 @@ int main(int argc, char** argv){
     // profiler.DumpEvents();
     // std::cout << "DUMP DONE\n";
     profiler.DumpEventsRecursive(/*dump_sub_events=*/true, /*max_depth=*/32);
+    graphs.Dump();
 
     if(!profiler.SerializeAfterExecute(graph_name.c_str())){
         std::cerr << "[QNN] SerializeAfterExecute failed\n";
     }
 
-    if(!PostProcessOneGraphRun("prefill_forward", false, rr_prefill.input_ptrs,
-            rr_prefill.output_metas, rr_prefill.output_bufs, profiler)){
-        return -1;
+    {
+        QnnTraceScope span(&trace, "prefill_forward:post-process");
+        if(!PostProcessOneGraphRun("prefill_forward", false, rr_prefill.input_ptrs, rr_prefill.io.inputs,
+                rr_prefill.io.outputs, rr_prefill.outputs, profiler)){
+            return -1;
+        }
     }
 
-    if(!PostProcessOneGraphRun("kv_forward", true, rr_kv.input_ptrs,
-            rr_kv.output_metas, rr_kv.output_bufs, profiler)){
-        return -1;
+    {
+        QnnTraceScope span(&trace, "kv_forward:post-process");
+        if(!PostProcessOneGraphRun("kv_forward", true, rr_kv.input_ptrs, rr_kv.io.inputs,
+                rr_kv.io.outputs, rr_kv.outputs, profiler)){
+            return -1;
+        }
+    }
+
+    if (serve.requests){
+        QnnHtpPerfScope burst(device.Perf(), QnnHtpPowerProfile::kBurst);
+        std::vector<QnnMemManagerRuntime*> mems(contexts.Size(), nullptr);
+        mems[prefill_idx] = &mem_prefill;
+        mems[kv_idx] = &mem_kv;
+        if (!ServeRequests(serve, qnn.Backend(), contexts, graphs, mems, sb, arena,
+                           {{"prefill_forward", &rr_prefill}, {"kv_forward", &rr_kv}}, &trace)){
+            std::cerr << "Serve failed\n";
+            return -1;
+        }
+    }
+
+    trace.WriteJson("trace.json");
+    QnnLatencyRegistry::Instance().Dump(std::cout);
+    {
+        const auto ps = QnnMemHandlePool::Instance().GetStats();
+        std::cout << "[QNN] MemHandlePool: entries=" << ps.entries << " idle=" << ps.idle
+                  << " hits=" << ps.hits << " inserts=" << ps.inserts
+                  << " deregistered=" << ps.deregistered << "\n";
     }
 
+    profiler.FlushSerialization();
+    telemetry.StopPeriodicDump();
+    telemetry.WriteJson("mem_telemetry.json");
     sb.ArenaDestroy(arena);
 
     std::cout << "[QNN] Done.\n";
@@ -0,0 +1,254 @@
+#!/usr/bin/env python3
+"""Compare two qnn_bench JSON results and fail on regression.
+
+usage:
+  python3 script/bench_compare.py base.json new.json [--threshold 5] [--alpha 0.01]
+                                  [--init-threshold 20] [--rss-threshold 10]
+  python3 script/bench_compare.py --self-test
+
+A latency regression needs two things:
+  1) the relative change of the metric is worse than --threshold (%)
+  2) a one-sided Mann-Whitney U test over the per-iteration samples says the new
+     samples are larger (p < --alpha). Without samples, only the threshold is used.
+
+init_ms / peak_rss_kb have no samples, so they are threshold only.
+
+Both files are schema-checked first (every graph needs a name and latency_us as a
+dict of numbers), so a malformed file is reported as bad input, not as a regression.
+
+exit code: 0 = no regression, 1 = regression, 2 = bad input
+"""
+import argparse
+import json
+import math
+import sys
+
+LATENCY_METRICS = ["min", "mean", "p50", "p90", "p99"]
+
+
+def load(path):
+    try:
+        with open(path) as f:
+            return json.load(f)
+    except (OSError, ValueError) as e:
+        print(f"failed to read {path}: {e}", file=sys.stderr)
+        sys.exit(2)
+
+
+def is_number(v):
+    return isinstance(v, (int, float)) and not isinstance(v, bool)
+
+
+def schema_errors(doc):
+    """list of problems with a qnn_bench result, empty if it can be compared."""
+    if not isinstance(doc, dict):
+        return ["top level is not an object"]
+    errs = []
+    graphs = doc.get("graphs", [])
+    if not isinstance(graphs, list):
+        return ["graphs is not a list"]
+    for i, g in enumerate(graphs):
+        if not isinstance(g, dict) or not isinstance(g.get("name"), str):
+            errs.append(f"graphs[{i}]: missing name")
+            continue
+        where = f"graph {g['name']}"
+        lat = g.get("latency_us")
+        if not isinstance(lat, dict) or not all(is_number(v) for v in lat.values()):
+            errs.append(f"{where}: latency_us must be a dict of numbers")
+        samples = g.get("samples_us", [])
+        if not isinstance(samples, list) or not all(is_number(v) for v in samples):
+            errs.append(f"{where}: samples_us must be a list of numbers")
+        if "tokens_per_sec" in g and not is_number(g["tokens_per_sec"]):
+            errs.append(f"{where}: tokens_per_sec is not a number")
+    init = doc.get("init_ms", {})
+    if not isinstance(init, dict) or not all(is_number(v) for v in init.values()):
+        errs.append("init_ms must be a dict of numbers")
+    if "peak_rss_kb" in doc and not is_number(doc["peak_rss_kb"]):
+        errs.append("peak_rss_kb is not a number")
+    return errs
+
+
+def check_schema(doc, path):
+    errs = schema_errors(doc)
+    if errs:
+        for e in errs:
+            print(f"bad input {path}: {e}", file=sys.stderr)
+        sys.exit(2)
+
+
+def mann_whitney_greater(a, b):
+    """P(b > a) one-sided p-value, normal approximation with tie correction."""
+    n1, n2 = len(a), len(b)
+    if n1 == 0 or n2 == 0:
+        return None
+    pooled = sorted([(v, 0) for v in a] + [(v, 1) for v in b])
+    ranks = [0.0] * len(pooled)
+    tie_term = 0.0
+    i = 0
+    while i < len(pooled):
+        j = i
+        while j + 1 < len(pooled) and pooled[j + 1][0] == pooled[i][0]:
+            j += 1
+        r = (i + j) / 2.0 + 1.0
+        for k in range(i, j + 1):
+            ranks[k] = r
+        t = j - i + 1
+        tie_term += t ** 3 - t
+        i = j + 1
+    r2 = sum(r for r, (_, g) in zip(ranks, pooled) if g == 1)
+    u2 = r2 - n2 * (n2 + 1) / 2.0
+    mu = n1 * n2 / 2.0
+    n = n1 + n2
+    var = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if var <= 0:
+        return 1.0
+    z = (u2 - mu - 0.5) / math.sqrt(var)  # continuity correction
+    return 0.5 * math.erfc(z / math.sqrt(2))
+
+
+def rel_change(base, new):
+    if base == 0:
+        return 0.0 if new == 0 else math.inf
+    return (new - base) / base * 100.0
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("base", nargs="?")
+    ap.add_argument("new", nargs="?")
+    ap.add_argument("--self-test", action="store_true", help="run the built-in checks and exit")
+    ap.add_argument("--threshold", type=float, default=5.0, help="latency noise threshold in %% (default 5)")
+    ap.add_argument("--alpha", type=float, default=0.01, help="significance level (default 0.01)")
+    ap.add_argument("--init-threshold", type=float, default=20.0, help="init time threshold in %% (default 20)")
+    ap.add_argument("--rss-threshold", type=float, default=10.0, help="peak RSS threshold in %% (default 10)")
+    ap.add_argument("--metrics", default=",".join(LATENCY_METRICS),
+                    help="latency metrics to gate on (default %(default)s)")
+    args = ap.parse_args()
+    if args.self_test:
+        return self_test(ap)
+    if not args.base or not args.new:
+        ap.error("base and new are required")
+
+    base, new = load(args.base), load(args.new)
+    check_schema(base, args.base)
+    check_schema(new, args.new)
+    return compare(base, new, args)
+
+
+def compare(base, new, args):
+    metrics = [m for m in args.metrics.split(",") if m]
+    base_graphs = {g["name"]: g for g in base.get("graphs", [])}
+    new_graphs = {g["name"]: g for g in new.get("graphs", [])}
+
+    regressions = []
+    rows = []
+
+    for name in sorted(set(base_graphs) | set(new_graphs)):
+        if name not in base_graphs or name not in new_graphs:
+            print(f"[skip] {name}: only in {'base' if name in base_graphs else 'new'}")
+            continue
+        b, n = base_graphs[name], new_graphs[name]
+        p = mann_whitney_greater(b.get("samples_us", []), n.get("samples_us", []))
+        significant = p is None or p < args.alpha
+
+        for m in metrics:
+            bv = b["latency_us"].get(m)
+            nv = n["latency_us"].get(m)
+            if bv is None or nv is None:
+                continue
+            d = rel_change(bv, nv)
+            bad = d > args.threshold and significant
+            rows.append((name, f"latency.{m} (us)", bv, nv, d, bad))
+            if bad:
+                regressions.append(f"{name} latency.{m} +{d:.1f}%")
+
+        # tokens/sec: higher is better
+        bt, nt = b.get("tokens_per_sec"), n.get("tokens_per_sec")
+        if bt is not None and nt is not None:
+            d = rel_change(bt, nt)
+            bad = -d > args.threshold and significant
+            rows.append((name, "tokens_per_sec", bt, nt, d, bad))
+            if bad:
+                regressions.append(f"{name} tokens_per_sec {d:.1f}%")
+
+        if p is not None:
+            rows.append((name, "mann-whitney p", None, p, None, False))
+
+    for key, bv in base.get("init_ms", {}).items():
+        nv = new.get("init_ms", {}).get(key)
+        if nv is None:
+            continue
+        d = rel_change(bv, nv)
+        bad = d > args.init_threshold
+        rows.append(("init", f"{key} (ms)", bv, nv, d, bad))
+        if bad:
+            regressions.append(f"init.{key} +{d:.1f}%")
+
+    if "peak_rss_kb" in base and "peak_rss_kb" in new:
+        d = rel_change(base["peak_rss_kb"], new["peak_rss_kb"])
+        bad = d > args.rss_threshold
+        rows.append(("memory", "peak_rss_kb", base["peak_rss_kb"], new["peak_rss_kb"], d, bad))
+        if bad:
+            regressions.append(f"peak_rss_kb +{d:.1f}%")
+
+    print(f"{'graph':<24} {'metric':<32} {'base':>12} {'new':>12} {'delta':>9}")
+    for g, m, bv, nv, d, bad in rows:
+        bs = "" if bv is None else f"{bv:12.2f}"
+        ds = "" if d is None else f"{d:+8.1f}%"
+        print(f"{g:<24} {m:<32} {bs:>12} {nv:12.4g} {ds:>9}{'  <-- REGRESSION' if bad else ''}")
+
+    if regressions:
+        print(f"\n{len(regressions)} regression(s):")
+        for r in regressions:
+            print(f"  {r}")
+        return 1
+    print("\nno regression")
+    return 0
+
+
+def self_test(ap):
+    """exit codes of compare / schema check on small in-memory results."""
+    import contextlib
+    import io
+
+    args = ap.parse_args(["base.json", "new.json"])
+
+    def result(mean, samples, **graph):
+        g = {"name": "g", "latency_us": {"min": mean, "mean": mean, "p50": mean, "p90": mean, "p99": mean},
+             "samples_us": samples}
+        g.update(graph)
+        return {"graphs": [g], "init_ms": {"total": 10.0}, "peak_rss_kb": 1000}
+
+    def code(base, new):
+        out = io.StringIO()
+        with contextlib.redirect_stdout(out), contextlib.redirect_stderr(out):
+            try:
+                check_schema(base, "base")
+                check_schema(new, "new")
+                return compare(base, new, args)
+            except SystemExit as e:
+                return e.code
+
+    fast = result(100.0, [100.0 + i % 3 for i in range(30)])
+    slow = result(150.0, [150.0 + i % 3 for i in range(30)])
+    no_latency = result(100.0, [100.0])
+    del no_latency["graphs"][0]["latency_us"]
+    cases = [
+        ("same result", code(fast, fast), 0),
+        ("slower samples", code(fast, slow), 1),
+        ("faster samples", code(slow, fast), 0),
+        ("missing latency_us", code(fast, no_latency), 2),
+        ("latency_us not numbers", code(result("x", [1.0]), fast), 2),
+        ("samples_us not a list", code(fast, result(100.0, 3)), 2),
+        ("graphs not a list", code({"graphs": {}}, fast), 2),
+    ]
+    failed = 0
+    for name, got, want in cases:
+        ok = got == want
+        failed += not ok
+        print(f"[{'ok' if ok else 'FAIL'}] {name}: exit {got} (want {want})")
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())